@@ -38,7 +38,14 @@ magecore_sources := \
  $(magecore_path)/IO/FileSystem.cpp \
  $(magecore_path)/IO/Resource.cpp \
  $(magecore_path)/Threads/Mutex_Unix.cpp \
+ $(magecore_path)/Threads/Thread_Unix.cpp \
+ $(magecore_path)/Threads/Semaphore_Unix.cpp \
+ $(magecore_path)/Threads/Job.cpp \
+ $(magecore_path)/Threads/JobManager.cpp \
+ $(magecore_path)/Threads/Task.cpp \
+ $(magecore_path)/Threads/JobBenchmark.cpp \
  $(magecore_path)/DataStructures/HashString.cpp \
+ $(magecore_path)/DataStructures/ObjectPool.cpp \
  $(magecore_path)/DataStructures/Dictionary.cpp \
  $(magecore_path)/Util/StringUtil.cpp \
  $(magecore_path)/Util/HashUtil.cpp \
@@ -48,6 +55,12 @@ magecore_sources := \
  $(magecore_path)/Assertion.cpp \
  $(magecore_path)/Color.cpp \
  $(magecore_path)/Clock.cpp \
+ $(magecore_path)/ProfilingSystem.cpp \
+ $(magecore_path)/FrameTimeHistogram.cpp \
+ $(magecore_path)/FrameArena.cpp \
+ $(magecore_path)/MageMemory.cpp \
+ $(magecore_path)/MemoryBenchmark.cpp \
+ $(magecore_path)/HashMapBenchmark.cpp \
  $(magecore_path)/Object.cpp \
  $(magecore_path)/RTTI.cpp \
 
@@ -113,6 +126,9 @@ magerenderer_sources := \
  $(magerenderer_path)/Camera.cpp \
  $(magerenderer_path)/Font.cpp \
  $(magerenderer_path)/Renderer.cpp \
+ $(magerenderer_path)/RenderQueue.cpp \
+ $(magerenderer_path)/QuadList.cpp \
+ $(magerenderer_path)/NullRenderer.cpp \
  $(magerenderer_path)/Shader.cpp \
  $(magerenderer_path)/Surface.cpp \
  $(magerenderer_path)/Texture.cpp \
@@ -121,6 +137,7 @@ magerenderer_sources := \
  $(magerenderer_path)/SpriteManager.cpp \
  $(magerenderer_path)/TileMap.cpp \
  $(magerenderer_path)/BitmapFont.cpp \
+ $(magerenderer_path)/PerformanceHUD.cpp \
 
 
 
@@ -161,6 +178,7 @@ $(aw_data_path)/Scenario.cpp \
 $(aw_game_path)/GameplayState.cpp \
 $(aw_game_path)/GameplayInputStates.cpp \
 $(aw_game_path)/abilities/Ability.cpp \
+$(aw_game_path)/abilities/ActionArena.cpp \
 $(aw_game_path)/abilities/UnitAbility.cpp \
 $(aw_game_path)/abilities/UnitWaitAbility.cpp \
 $(aw_game_path)/abilities/UnitAttackAbility.cpp \
@@ -173,9 +191,18 @@ $(aw_game_path)/Game.cpp \
 $(aw_game_path)/Player.cpp \
 $(aw_game_path)/Faction.cpp \
 $(aw_game_path)/Unit.cpp \
+$(aw_game_path)/CombatForecast.cpp \
+$(aw_game_path)/ai/AISimulation.cpp \
+$(aw_game_path)/ai/AIEvaluator.cpp \
+$(aw_game_path)/ai/AIController.cpp \
+$(aw_game_path)/ai/AIMatchBatch.cpp \
 $(aw_game_path)/Map.cpp \
+$(aw_game_path)/DistanceField.cpp \
 $(aw_game_path)/MapView.cpp \
 $(aw_game_path)/TileSprite.cpp \
+$(aw_game_path)/TerrainChunk.cpp \
+$(aw_game_path)/RenderBenchmark.cpp \
+$(aw_game_path)/Benchmarks.cpp \
 $(aw_game_path)/UnitSprite.cpp \
 $(aw_game_path)/ArrowSprite.cpp \
 $(aw_game_path)/TargetSprite.cpp \
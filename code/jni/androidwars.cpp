@@ -19,6 +19,13 @@ OnlineGameClient* gOnlineGameClient = nullptr;
 
 const float DEBUG_POINTER_DRAW_RADIUS = 40.0f;
 
+// Touching the screen with this many fingers at once shows or hides the PerformanceHUD.
+const size_t PERFORMANCE_HUD_TOGGLE_POINTER_COUNT = 4;
+const float PERFORMANCE_HUD_MARGIN = 10.0f;
+
+// How often to check for online responses while the game is otherwise idle.
+const float ONLINE_POLL_INTERVAL = 0.1f;
+
 
 void DebugDrawPointers()
 {
@@ -54,6 +61,9 @@ void OnDraw()
 
 	DebugDrawPointers();
 
+	// Draw the performance overlay on top of everything (does nothing while hidden).
+	PerformanceHUD::OnDraw( PERFORMANCE_HUD_MARGIN, PERFORMANCE_HUD_MARGIN );
+
 	// Camera debug
 //	DrawRect( gCameraTarget.x - 5, gCameraTarget.y - 5, 10, 10, Color::PINK );
 	FlushRenderer();
@@ -71,6 +81,25 @@ void OnUpdate( float dt )
 	}
 }
 
+float GetIdleTime()
+{
+	float idleTime = -1.0f;
+
+	if( gGameStateManager )
+	{
+		// Let the current GameState decide when it needs another frame.
+		idleTime = gGameStateManager->GetIdleTime();
+	}
+
+	if( gOnlineGameClient->HasPendingRequests() && ( idleTime < 0.0f || idleTime > ONLINE_POLL_INTERVAL ) )
+	{
+		// Wake up periodically to poll for online request responses.
+		idleTime = ONLINE_POLL_INTERVAL;
+	}
+
+	return idleTime;
+}
+
 void OnScreenSizeChanged( int32 w, int32 h )
 {
 	gWindowWidth = w;
@@ -96,6 +125,13 @@ void OnWindowShown()
 		gWidgetManager = new WidgetManager();
 		gWidgetManager->Init();
 
+		// Give the PerformanceHUD a font to draw with.
+		PerformanceHUD::SetFont( gWidgetManager->GetFontByName( "default_s.fnt" ) );
+
+		// Show the allocations of the pooled game objects on the PerformanceHUD.
+		PerformanceHUD::TrackPool( "Widget", PoolAllocated< Widget >::GetPoolStats );
+		PerformanceHUD::TrackPool( "MapAnimation", PoolAllocated< MapAnimation >::GetPoolStats );
+
 		// Create the GameStateManager and create the first state.
 		DebugPrintf( "Creating GameStateManager..." );
 		gGameStateManager = new GameStateManager();
@@ -126,6 +162,12 @@ void OnPointerDown( const Pointer& pointer )
 {
 	//DebugPrintf( "Pointer %d: Down at (%.3f,%.3f).", pointer.id, pointer.position.x, pointer.position.y );
 
+	if( GetPointerCount() == PERFORMANCE_HUD_TOGGLE_POINTER_COUNT )
+	{
+		// Show or hide the PerformanceHUD.
+		PerformanceHUD::ToggleVisible();
+	}
+
 	if( gGameStateManager )
 	{
 		// Pass the input event to the GameStateManager.
@@ -180,6 +222,54 @@ void OnVolumeChanged( float volume )
 		gSoundManager->SetVolume( volume );*/
 }
 
+
+/**
+ * Returns the Intent the Activity was launched with.
+ */
+jobject GetLaunchIntent( JNI& env, android_app* app )
+{
+	jclass activityClass = env->GetObjectClass( app->activity->clazz );
+	jmethodID getIntent = env->GetMethodID( activityClass, "getIntent", "()Landroid/content/Intent;" );
+	return env->CallObjectMethod( app->activity->clazz, getIntent );
+}
+
+
+/**
+ * Returns a string extra from the launch Intent, or an empty string if it wasn't set.
+ */
+std::string GetLaunchStringExtra( android_app* app, const char* name )
+{
+	JNI env;
+
+	jobject intent = GetLaunchIntent( env, app );
+	jmethodID getStringExtra = env->GetMethodID( env->GetObjectClass( intent ), "getStringExtra", "(Ljava/lang/String;)Ljava/lang/String;" );
+	jstring value = (jstring) env->CallObjectMethod( intent, getStringExtra, env->NewStringUTF( name ) );
+
+	std::string result;
+
+	if( value )
+	{
+		const char* chars = env->GetStringUTFChars( value, nullptr );
+		result = chars;
+		env->ReleaseStringUTFChars( value, chars );
+	}
+
+	return result;
+}
+
+
+/**
+ * Returns an int extra from the launch Intent, or defaultValue if it wasn't set.
+ */
+int GetLaunchIntExtra( android_app* app, const char* name, int defaultValue )
+{
+	JNI env;
+
+	jobject intent = GetLaunchIntent( env, app );
+	jmethodID getIntExtra = env->GetMethodID( env->GetObjectClass( intent ), "getIntExtra", "(Ljava/lang/String;I)I" );
+	return env->CallIntMethod( intent, getIntExtra, env->NewStringUTF( name ), defaultValue );
+}
+
 void main()
 {
 	// Initialize the application
@@ -190,6 +280,29 @@ void main()
 	assertion( app, "Cannot create OnlineGameClient without a reference to the Java app instance!" );
 	JNI::Init( app->activity->vm );
 
+	// If the app was launched to run a benchmark (see Benchmarks), run it instead of the game and then exit.
+	std::string benchmarkName = GetLaunchStringExtra( app, "benchmark" );
+
+	if( !benchmarkName.empty() )
+	{
+		Benchmarks::Run( benchmarkName, GetLaunchIntExtra( app, "benchmarkCount", 0 ) );
+
+		// Keep running until the Activity is destroyed, so the app shuts down cleanly.
+		ANativeActivity_finish( app->activity );
+		Run();
+		JNI::Destroy();
+		return;
+	}
+
+	// If the app was launched with a "traceFrames" extra, trace that many of its first frames to a Chrome trace file:
+	//   adb shell am start -n com.timechildgames.androidwars/.MainActivity --ei traceFrames 120
+	int traceFrameCount = GetLaunchIntExtra( app, "traceFrames", 0 );
+
+	if( traceFrameCount > 0 )
+	{
+		ProfilingSystem::CaptureFrames( (uint32) traceFrameCount, "trace.json" );
+	}
+
 	// Sounds can either be .wav or .pcm files, but they must be saved as mono with a sampling rate of 44,100 Hz.
 	gSoundManager = new SoundManager( app );
 //	gJumpSoundFx = gSoundManager->LoadSoundClip( "sfx/super_mario_jump.wav", "jump.sfx" );
@@ -215,6 +328,7 @@ void main()
 	RegisterOnFocusLostFn( OnFocusLost );
 	RegisterOnFocusGainedFn( OnFocusGained );
 	RegisterOnVolumeChangedFn( OnVolumeChanged );
+	RegisterGetIdleTimeFn( GetIdleTime );
 
 	//RegisterEventFuncs();
 
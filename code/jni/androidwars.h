@@ -75,6 +75,7 @@ const size_t MAP_SIZE_POWER_OF_TWO = 10;
 
 #include "game/Path.h"
 #include "game/abilities/Ability.h"
+#include "game/abilities/ActionArena.h"
 #include "game/abilities/UnitAbility.h"
 #include "game/abilities/UnitWaitAbility.h"
 #include "game/abilities/UnitAttackAbility.h"
@@ -85,8 +86,15 @@ const size_t MAP_SIZE_POWER_OF_TWO = 10;
 #include "game/animations/MapAnimation.h"
 #include "game/animations/UnitMoveMapAnimation.h"
 #include "game/Map.h"
+#include "game/DistanceField.h"
+#include "game/CombatForecast.h"
+#include "game/ai/AISimulation.h"
+#include "game/ai/AIEvaluator.h"
+#include "game/ai/AIController.h"
+#include "game/ai/AIMatchBatch.h"
 #include "game/Faction.h"
 #include "game/TileSprite.h"
+#include "game/TerrainChunk.h"
 #include "game/TargetSprite.h"
 #include "game/UnitSprite.h"
 #include "game/ArrowSprite.h"
@@ -95,6 +103,8 @@ const size_t MAP_SIZE_POWER_OF_TWO = 10;
 #include "game/Unit.h"
 #include "game/Game.h"
 #include "game/GameplayState.h"
+#include "game/RenderBenchmark.h"
+#include "game/Benchmarks.h"
 #include "game/GameplayInputStates.h"
 
 #include "editor/EditorState.h"
@@ -141,6 +141,9 @@ void Scenario::LoadDataFromJSON( const rapidjson::Value& object )
 	UnitTypes.LoadRecordsFromJSON( object );
 	MovementTypes.LoadRecordsFromJSON( object );
 
+	// Compile the terrain Variations so tile sprites can be chosen quickly.
+	TerrainTypes.CompileVariations();
+
 	//DebugPrintData();
 }
 
@@ -3,6 +3,10 @@
 using namespace mage;
 
 const HashString TerrainType::DEFAULT_ANIMATION_NAME = "Idle";
+const HashString TerrainType::NO_TERRAIN_EXPRESSION = "None";
+const uint8 TerrainType::NO_TERRAIN_INDEX;
+const size_t TerrainType::MAX_COMPILED_TERRAIN_TYPES;
+const size_t TerrainType::NEIGHBOR_MASK_COUNT;
 
 
 void Variation::Condition::AddExpression( PrimaryDirection direction, const HashString& expression )
@@ -215,6 +219,8 @@ void Variation::DestroyAllConditions()
 
 TerrainType::TerrainType( const HashString& name ) :
 	Record( name ),
+	mTerrainIndex( NO_TERRAIN_INDEX ),
+	mIsVariationLookupCompiled( false ),
 	mIncome( 0 ),
 	mCoverBonus( 0 ),
 	mIsCapturable( false )
@@ -235,6 +241,7 @@ Variation* TerrainType::CreateVariation( const HashString& animationName )
 
 	// Add the new Variation to the list.
 	mVariations.push_back( variation );
+	InvalidateVariationLookup();
 
 	// Return the new Variation.
 	return variation;
@@ -284,6 +291,7 @@ void TerrainType::DestroyVariation( Variation* variation )
 
 	assertion( it != mVariations.end(), "Cannot destroy Variation that is not part of %s!", ToString() );
 	mVariations.erase( it );
+	InvalidateVariationLookup();
 }
 
 
@@ -297,6 +305,211 @@ void TerrainType::DestroyAllVariations()
 
 	// Clear the list of Variations.
 	mVariations.clear();
+	InvalidateVariationLookup();
+}
+
+
+void TerrainType::CompileVariations()
+{
+	InvalidateVariationLookup();
+
+	// Terrain indices are assigned by the TerrainTypesTable (index 0 is reserved for tiles with no terrain).
+	const size_t terrainIndexCount = ( GetTable()->GetRecords().size() + 1 );
+
+	if( mTerrainIndex != NO_TERRAIN_INDEX )
+	{
+		for( auto it = mVariations.rbegin(); it != mVariations.rend(); ++it )
+		{
+			// Compile the Conditions of the last Variation first, since the last matching Variation wins.
+			const Variation* variation = *it;
+			const Variation::Conditions& conditions = variation->GetConditions();
+
+			for( auto it2 = conditions.begin(); it2 != conditions.end(); ++it2 )
+			{
+				// Accept any neighbor in directions the Condition doesn't mention.
+				CompiledCondition compiledCondition;
+				compiledCondition.ChosenVariation = variation;
+
+				for( size_t i = 0; i < PRIMARY_DIRECTION_COUNT; ++i )
+				{
+					compiledCondition.AcceptedNeighbors[ i ] = ~0ull;
+				}
+
+				const Variation::Condition::ExpressionsByDirection& expressions = ( *it2 )->GetExpressionsByDirection();
+
+				for( auto it3 = expressions.begin(); it3 != expressions.end(); ++it3 )
+				{
+					// Only accept the terrain named by the expressions in each mentioned direction.
+					uint64& acceptedNeighbors = compiledCondition.AcceptedNeighbors[ it3->first.GetIndex() - 1 ];
+					acceptedNeighbors = 0;
+
+					for( auto it4 = it3->second.begin(); it4 != it3->second.end(); ++it4 )
+					{
+						acceptedNeighbors |= GetTerrainIndexMask( *it4 );
+					}
+				}
+
+				mCompiledConditions.push_back( compiledCondition );
+			}
+		}
+
+		// Classify the neighboring terrain in each direction as matching (treated the same as this TerrainType by
+		// every Condition) or not matching. This only works if the Conditions split the terrain into two groups.
+		const uint64 selfMask = ( 1ull << mTerrainIndex );
+		uint8 otherTerrainIndices[ PRIMARY_DIRECTION_COUNT ];
+		bool canBuildLookupTable = true;
+
+		for( size_t i = 0; i < PRIMARY_DIRECTION_COUNT && canBuildLookupTable; ++i )
+		{
+			mMatchingNeighbors[ i ] = selfMask;
+			otherTerrainIndices[ i ] = mTerrainIndex;
+
+			for( size_t terrainIndex = 0; terrainIndex < terrainIndexCount; ++terrainIndex )
+			{
+				const uint64 terrainMask = ( 1ull << terrainIndex );
+				bool matchesSelf = true;
+				bool matchesOther = true;
+
+				for( auto it = mCompiledConditions.begin(); it != mCompiledConditions.end(); ++it )
+				{
+					// Compare how each Condition treats this terrain and the representative terrain of each group.
+					const uint64 acceptedNeighbors = it->AcceptedNeighbors[ i ];
+					const bool isAccepted = ( ( acceptedNeighbors & terrainMask ) != 0 );
+					matchesSelf &= ( isAccepted == ( ( acceptedNeighbors & selfMask ) != 0 ) );
+					matchesOther &= ( isAccepted == ( ( acceptedNeighbors & ( 1ull << otherTerrainIndices[ i ] ) ) != 0 ) );
+				}
+
+				if( matchesSelf )
+				{
+					mMatchingNeighbors[ i ] |= terrainMask;
+				}
+				else if( otherTerrainIndices[ i ] == mTerrainIndex )
+				{
+					// Use the first non-matching terrain as the representative of the non-matching group.
+					otherTerrainIndices[ i ] = terrainIndex;
+				}
+				else if( !matchesOther )
+				{
+					// A third group of terrain can't be represented by a single bit.
+					canBuildLookupTable = false;
+					break;
+				}
+			}
+		}
+
+		if( canBuildLookupTable )
+		{
+			mVariationsByNeighborMask.resize( NEIGHBOR_MASK_COUNT );
+			NeighborTerrainIndices neighborTerrainIndices;
+
+			for( size_t neighborMask = 0; neighborMask < NEIGHBOR_MASK_COUNT; ++neighborMask )
+			{
+				for( size_t i = 0; i < PRIMARY_DIRECTION_COUNT; ++i )
+				{
+					// Evaluate each neighbor mask using the representative terrain for each direction.
+					neighborTerrainIndices[ i ] = ( ( neighborMask & ( 1 << i ) ) ? mTerrainIndex : otherTerrainIndices[ i ] );
+				}
+
+				mVariationsByNeighborMask[ neighborMask ] = FindCompiledVariation( neighborTerrainIndices );
+			}
+		}
+		else
+		{
+			DebugPrintf( "Variations for %s can't be reduced to a neighbor mask, so Conditions will be tested individually.", ToString() );
+		}
+
+		mIsVariationLookupCompiled = true;
+	}
+	else
+	{
+		WarnFail( "Cannot compile Variations for %s because it has not been assigned a terrain index!", ToString() );
+	}
+}
+
+
+const Variation* TerrainType::ChooseVariation( const NeighborTerrainIndices& neighborTerrainIndices ) const
+{
+	assertion( mIsVariationLookupCompiled, "Cannot choose Variation for %s because its Variations have not been compiled!", ToString() );
+
+	const Variation* result = nullptr;
+
+	if( !mVariationsByNeighborMask.empty() )
+	{
+		// Build the mask of matching neighbors and look up the Variation.
+		size_t neighborMask = 0;
+
+		for( size_t i = 0; i < PRIMARY_DIRECTION_COUNT; ++i )
+		{
+			neighborMask |= ( ( mMatchingNeighbors[ i ] >> neighborTerrainIndices[ i ] ) & 1 ) << i;
+		}
+
+		result = mVariationsByNeighborMask[ neighborMask ];
+	}
+	else
+	{
+		// Otherwise, test the compiled Conditions directly.
+		result = FindCompiledVariation( neighborTerrainIndices );
+	}
+
+	return result;
+}
+
+
+void TerrainType::InvalidateVariationLookup()
+{
+	mCompiledConditions.clear();
+	mVariationsByNeighborMask.clear();
+	mIsVariationLookupCompiled = false;
+}
+
+
+uint64 TerrainType::GetTerrainIndexMask( const HashString& expression ) const
+{
+	uint64 result = 0;
+
+	if( expression == NO_TERRAIN_EXPRESSION )
+	{
+		// Match tiles without terrain.
+		result = ( 1ull << NO_TERRAIN_INDEX );
+	}
+	else
+	{
+		// Match tiles with the named TerrainType (if it exists).
+		const TerrainType* terrainType = GetTable()->FindByName( expression );
+
+		if( terrainType && terrainType->mTerrainIndex != NO_TERRAIN_INDEX )
+		{
+			result = ( 1ull << terrainType->mTerrainIndex );
+		}
+	}
+
+	return result;
+}
+
+
+const Variation* TerrainType::FindCompiledVariation( const NeighborTerrainIndices& neighborTerrainIndices ) const
+{
+	const Variation* result = nullptr;
+
+	for( auto it = mCompiledConditions.begin(); it != mCompiledConditions.end(); ++it )
+	{
+		uint64 isMatch = 1;
+
+		for( size_t i = 0; i < PRIMARY_DIRECTION_COUNT; ++i )
+		{
+			// Test whether the neighbor in each direction is accepted by the Condition.
+			isMatch &= ( it->AcceptedNeighbors[ i ] >> neighborTerrainIndices[ i ] );
+		}
+
+		if( isMatch )
+		{
+			// The first matching Condition belongs to the highest priority matching Variation.
+			result = it->ChosenVariation;
+			break;
+		}
+	}
+
+	return result;
 }
 
 
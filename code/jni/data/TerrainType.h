@@ -53,13 +53,23 @@ namespace mage
 
 	/**
 	 * Represents all non-changing aspects of a tile.
+	 *
+	 * The Variations of each TerrainType are compiled when the Scenario is loaded. Every neighboring tile is
+	 * classified as either matching or not matching the rules for its direction, and the resulting 8-bit
+	 * neighbor mask indexes a table of precomputed Variations, so choosing the Variation for a tile doesn't
+	 * require any string comparisons.
 	 */
 	class TerrainType : public TerrainTypesTable::Record
 	{
 	public:
 		static const HashString DEFAULT_ANIMATION_NAME;
+		static const HashString NO_TERRAIN_EXPRESSION;
+		static const uint8 NO_TERRAIN_INDEX = 0;
+		static const size_t MAX_COMPILED_TERRAIN_TYPES = 63;
+		static const size_t NEIGHBOR_MASK_COUNT = ( 1 << PRIMARY_DIRECTION_COUNT );
 
 		typedef std::vector< Variation* > Variations;
+		typedef uint8 NeighborTerrainIndices[ PRIMARY_DIRECTION_COUNT ];
 
 		TerrainType( const HashString& name );
 		virtual ~TerrainType();
@@ -71,6 +81,11 @@ namespace mage
 		void DestroyVariation( Variation* variation );
 		void DestroyAllVariations();
 
+		void CompileVariations();
+		bool IsVariationLookupCompiled() const;
+		uint8 GetTerrainIndex() const;
+		const Variation* ChooseVariation( const NeighborTerrainIndices& neighborTerrainIndices ) const;
+
 		HashString GetAnimationSetName() const;
 		std::string GetDisplayName() const;
 		int GetIncome() const;
@@ -78,9 +93,28 @@ namespace mage
 		bool IsCapturable() const;
 
 	protected:
+		/**
+		 * A Condition flattened into the set of neighboring terrain indices it accepts in each direction.
+		 */
+		struct CompiledCondition
+		{
+			uint64 AcceptedNeighbors[ PRIMARY_DIRECTION_COUNT ];
+			const Variation* ChosenVariation;
+		};
+
+		typedef std::vector< CompiledCondition > CompiledConditions;
+
 		void LoadAnimation();
+		void InvalidateVariationLookup();
+		uint64 GetTerrainIndexMask( const HashString& expression ) const;
+		const Variation* FindCompiledVariation( const NeighborTerrainIndices& neighborTerrainIndices ) const;
 
 		Variations mVariations;
+		CompiledConditions mCompiledConditions;
+		std::vector< const Variation* > mVariationsByNeighborMask;
+		uint64 mMatchingNeighbors[ PRIMARY_DIRECTION_COUNT ];
+		uint8 mTerrainIndex;
+		bool mIsVariationLookupCompiled;
 		HashString mAnimationSetName;
 		std::string mAnimationSetPath;
 		std::string mDisplayName;
@@ -96,4 +130,16 @@ namespace mage
 	{
 		return mCoverBonus;
 	}
+
+
+	inline bool TerrainType::IsVariationLookupCompiled() const
+	{
+		return mIsVariationLookupCompiled;
+	}
+
+
+	inline uint8 TerrainType::GetTerrainIndex() const
+	{
+		return mTerrainIndex;
+	}
 }
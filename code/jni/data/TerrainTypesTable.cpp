@@ -14,6 +14,31 @@ TerrainTypesTable::TerrainTypesTable( Scenario* scenario )
 TerrainTypesTable::~TerrainTypesTable() { }
 
 
+void TerrainTypesTable::CompileVariations()
+{
+	if( mRecords.size() <= TerrainType::MAX_COMPILED_TERRAIN_TYPES )
+	{
+		uint8 terrainIndex = TerrainType::NO_TERRAIN_INDEX;
+
+		for( auto it = mRecords.begin(); it != mRecords.end(); ++it )
+		{
+			// Give each TerrainType a unique index (skipping the index reserved for tiles with no terrain).
+			it->second->mTerrainIndex = ++terrainIndex;
+		}
+
+		for( auto it = mRecords.begin(); it != mRecords.end(); ++it )
+		{
+			// Compile the Variations once every TerrainType has an index.
+			it->second->CompileVariations();
+		}
+	}
+	else
+	{
+		WarnFail( "Cannot compile TerrainType Variations because there are more than %d TerrainTypes (%d loaded)!", TerrainType::MAX_COMPILED_TERRAIN_TYPES, mRecords.size() );
+	}
+}
+
+
 void TerrainTypesTable::OnLoadRecordFromJSON( TerrainType* terrainType, const rapidjson::Value& object )
 {
 	// Read in all attributes.
@@ -14,6 +14,8 @@ namespace mage
 		TerrainTypesTable( Scenario* scenario );
 		virtual ~TerrainTypesTable();
 
+		void CompileVariations();
+
 	protected:
 		virtual void OnLoadRecordFromJSON( TerrainType* terrainType, const rapidjson::Value& object );
 
@@ -210,6 +210,20 @@ void EditorState::OnUpdate( float elapsedTime )
 }
 
 
+float EditorState::GetIdleTime() const
+{
+	float result = 0.0f;
+
+	if( !HasPendingStateChange() )
+	{
+		// Wait for the MapView to animate.
+		result = mMapView.GetIdleTime();
+	}
+
+	return result;
+}
+
+
 void EditorState::OnDraw()
 {
 	// Draw the MapView.
@@ -34,6 +34,7 @@ namespace mage
 		virtual bool OnPointerDown( const Pointer& pointer );
 		virtual bool OnPointerUp( const Pointer& pointer );
 		virtual bool OnPointerMotion( const Pointer& activePointer, const PointersByID& pointersByID );
+		virtual float GetIdleTime() const;
 
 		void BuildTilePalette();
 		void BuildUnitPalette();
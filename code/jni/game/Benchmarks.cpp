@@ -0,0 +1,134 @@
+#include "androidwars.h"
+
+using namespace mage;
+
+
+// The Scenario that benchmarks which need game data load for themselves.
+const char* const BENCHMARK_SCENARIO_FILE = "data/Data.json";
+const char* const BENCHMARK_FONT_FILE = "default_s.fnt";
+
+// There is no window while benchmarks run, so draw into a typical phone-sized viewport.
+const int BENCHMARK_VIEWPORT_WIDTH = 1280;
+const int BENCHMARK_VIEWPORT_HEIGHT = 720;
+
+
+void RunAIMatchBenchmark( int matchesPerThread )
+{
+	Scenario scenario;
+
+	if( scenario.LoadDataFromFile( BENCHMARK_SCENARIO_FILE ) )
+	{
+		AIMatchBatch::RunScalingBenchmark( &scenario, matchesPerThread );
+	}
+	else
+	{
+		WarnFail( "Could not run AI match benchmark because the Scenario \"%s\" could not be loaded!", BENCHMARK_SCENARIO_FILE );
+	}
+}
+
+
+void RunQuadSubmissionBenchmark( int quadCount )
+{
+	BenchmarkQuadSubmission( (size_t) quadCount );
+}
+
+
+void RunRenderFrameBenchmark( int frameCount )
+{
+	RenderBenchmark::RunHeadless( BENCHMARK_SCENARIO_FILE, BENCHMARK_FONT_FILE, frameCount, BENCHMARK_VIEWPORT_WIDTH, BENCHMARK_VIEWPORT_HEIGHT );
+}
+
+
+void RunJobBenchmark( int jobCount )
+{
+	JobBenchmark::Run( (unsigned int) jobCount );
+}
+
+
+void RunMemoryBenchmark( int operationsPerThread )
+{
+	MemoryBenchmark::Run( (unsigned int) operationsPerThread );
+}
+
+
+void RunHashMapBenchmark( int minOperations )
+{
+	HashMapBenchmark::Run( (unsigned int) minOperations );
+}
+
+
+struct BenchmarkEntry
+{
+	const char* Name;
+	Benchmarks::Runner Run;
+	int DefaultCount;
+};
+
+
+// Every benchmark that can be run by name.
+const BenchmarkEntry BENCHMARKS[] =
+{
+	// Measures how well headless computer-vs-computer matches scale across threads. Count is matches per thread.
+	{ "aiMatches", RunAIMatchBenchmark, 4 },
+	// Compares the cost of submitting quads through RenderVerticies() and ReserveQuads(). Count is quads.
+	{ "quadSubmission", RunQuadSubmissionBenchmark, 10000 },
+	// Measures the CPU cost of drawing a large Map without the GPU. Count is frames.
+	{ "renderFrames", RunRenderFrameBenchmark, 600 },
+	// Measures job pickup latency and how job throughput scales across cores. Count is jobs.
+	{ "jobs", RunJobBenchmark, 2000 },
+	// Stresses the MemoryPool with allocation churn on several threads. Count is operations per thread.
+	{ "memory", RunMemoryBenchmark, 100000 },
+	// Compares HashMap inserts and lookups against std::map. Count is the minimum number of operations timed per map size.
+	{ "hashMap", RunHashMapBenchmark, 100000 },
+};
+
+const size_t BENCHMARK_COUNT = sizeof( BENCHMARKS ) / sizeof( BENCHMARKS[ 0 ] );
+
+
+bool Benchmarks::Run( const std::string& name, int count )
+{
+	const BenchmarkEntry* benchmark = nullptr;
+
+	for( size_t i = 0; i < BENCHMARK_COUNT; ++i )
+	{
+		if( name == BENCHMARKS[ i ].Name )
+		{
+			benchmark = &BENCHMARKS[ i ];
+			break;
+		}
+	}
+
+	if( !benchmark )
+	{
+		WarnFail( "No benchmark named \"%s\"! Valid benchmarks are:", name.c_str() );
+
+		for( size_t i = 0; i < BENCHMARK_COUNT; ++i )
+		{
+			WarnFail( "  %s (default count %d)", BENCHMARKS[ i ].Name, BENCHMARKS[ i ].DefaultCount );
+		}
+
+		return false;
+	}
+
+	if( count <= 0 )
+	{
+		count = benchmark->DefaultCount;
+	}
+
+	DebugPrintf( "Running benchmark \"%s\" with a count of %d...", benchmark->Name, count );
+
+	// Install a NullRenderer first, so nothing the benchmark loads or draws touches the GPU.
+	NullRenderer headlessRenderer;
+	headlessRenderer.Start();
+
+	IRenderer* previousRenderer = SwapRenderer( &headlessRenderer );
+
+	benchmark->Run( count );
+
+	SwapRenderer( previousRenderer );
+	headlessRenderer.Stop();
+
+	DebugPrintf( "Finished benchmark \"%s\".", benchmark->Name );
+
+	return true;
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+namespace mage
+{
+	/**
+	 * The single entry point for every benchmark in the app, looked up by name.
+	 *
+	 * Benchmarks run from main() before the game starts, when the app is launched with a "benchmark" extra:
+	 *
+	 *   adb shell am start -n com.timechildgames.androidwars/.MainActivity -e benchmark aiMatches --ei benchmarkCount 8
+	 *
+	 * A NullRenderer is installed while a benchmark runs, so nothing it loads or draws touches the GPU.
+	 */
+	class Benchmarks
+	{
+	public:
+		typedef void( *Runner )( int count );
+
+		/**
+		 * Runs the benchmark with the given name. What count means depends on the benchmark, and a count
+		 * of 0 or less uses the benchmark's default. Returns false if there is no benchmark with that name.
+		 */
+		static bool Run( const std::string& name, int count = 0 );
+	};
+}
@@ -0,0 +1,258 @@
+#include "androidwars.h"
+
+using namespace mage;
+
+
+int CombatForecast::CalculateDamagePercentage( int baseDamagePercentage, int attackerHealth, int targetCoverBonus, int targetHealth )
+{
+	// Mirror Unit::CalculateDamagePercentage() and Unit::GetDefenseBonus() without any of the logging.
+	float healthScale = ( (float) attackerHealth / Unit::MAX_HEALTH );
+	float targetHealthScale = ( (float) targetHealth / Unit::MAX_HEALTH );
+	float targetDefenseBonus = Mathf::Clamp( ( targetCoverBonus * 0.1f ) * targetHealthScale, 0.0f, 1.0f );
+	float targetDefenseScale = Mathf::Clamp( 1.0f - targetDefenseBonus, 0.0f, 1.0f );
+
+	return (int) ( baseDamagePercentage * healthScale * targetDefenseScale );
+}
+
+
+float CombatForecast::CalculateExpectedDamage( int damagePercentage, int targetHealth )
+{
+	// Split the damage into the guaranteed amount and the chance of one extra point (see Unit::Attack()).
+	int guaranteedDamage = ( damagePercentage / 10 );
+	float extraDamageChance = ( ( damagePercentage % 10 ) * 0.1f );
+
+	// Damage past the target's remaining health is wasted.
+	float damageWithoutExtra = (float) std::min( guaranteedDamage, targetHealth );
+	float damageWithExtra = (float) std::min( guaranteedDamage + 1, targetHealth );
+
+	return ( ( 1.0f - extraDamageChance ) * damageWithoutExtra + extraDamageChance * damageWithExtra );
+}
+
+
+float CombatForecast::CalculateKillChance( int damagePercentage, int targetHealth )
+{
+	float result = 0.0f;
+
+	int guaranteedDamage = ( damagePercentage / 10 );
+
+	if( guaranteedDamage >= targetHealth )
+	{
+		// The guaranteed damage alone is enough to kill the target.
+		result = 1.0f;
+	}
+	else if( guaranteedDamage + 1 >= targetHealth )
+	{
+		// Only a successful extra damage roll will kill the target.
+		result = ( ( damagePercentage % 10 ) * 0.1f );
+	}
+
+	return result;
+}
+
+
+CombatForecast::CombatForecast() :
+	mUnit( nullptr )
+{ }
+
+
+CombatForecast::~CombatForecast() { }
+
+
+void CombatForecast::Calculate( const Unit* unit, const Map::TileSet& reachableTiles )
+{
+	assertion( unit, "Cannot calculate CombatForecast for null Unit!" );
+
+	// Clear the previous results (but keep the buffers around for reuse).
+	Clear();
+	mUnit = unit;
+
+	Map* map = unit->GetMap();
+	const UnitType* unitType = unit->GetUnitType();
+	const Faction* owner = unit->GetOwner();
+	const IntRange& attackRange = unitType->GetAttackRange();
+	int attackerHealth = unit->GetHealth();
+
+	for( int weaponIndex = 0, weaponCount = unitType->GetNumWeapons(); weaponIndex < weaponCount; ++weaponIndex )
+	{
+		if( unit->CanFireWeapon( weaponIndex ) )
+		{
+			// Only consider weapons that currently have enough ammo to fire.
+			mWeaponIndices.push_back( weaponIndex );
+		}
+	}
+
+	size_t weaponCount = mWeaponIndices.size();
+
+	if( weaponCount == 0 )
+	{
+		// If the Unit can't fire anything, there is nothing to forecast.
+		return;
+	}
+
+	const Map::UnitsByID& units = map->GetUnitsByID();
+
+	for( auto it = units.begin(); it != units.end(); ++it )
+	{
+		const Unit* target = it->second;
+
+		if( !target->IsAlive() || !target->GetTile().IsValid() || !map->AreEnemies( owner, target->GetOwner() ) )
+		{
+			// Skip anything that can't be attacked.
+			continue;
+		}
+
+		const UnitType* targetType = target->GetUnitType();
+
+		// Flatten the base damage of each usable weapon against this target, and pick the
+		// weapon Unit::GetBestAvailableWeaponAgainst() would choose.
+		size_t firstDamageIndex = mBaseDamagePercentages.size();
+		int preferredWeaponIndex = -1;
+		int bestDamagePercentage = 0;
+
+		for( size_t i = 0; i < weaponCount; ++i )
+		{
+			int weaponIndex = mWeaponIndices[ i ];
+			int baseDamagePercentage = unitType->GetWeaponByIndex( weaponIndex ).GetDamagePercentageAgainstUnitType( targetType );
+			mBaseDamagePercentages.push_back( baseDamagePercentage );
+
+			if( baseDamagePercentage > bestDamagePercentage )
+			{
+				bestDamagePercentage = baseDamagePercentage;
+				preferredWeaponIndex = weaponIndex;
+			}
+		}
+
+		if( preferredWeaponIndex < 0 )
+		{
+			// If no weapon can hit this target, forget about it.
+			mBaseDamagePercentages.resize( firstDamageIndex );
+			continue;
+		}
+
+		// Determine the best counter-attack the target could make against the attacking Unit.
+		int counterDamagePercentage = 0;
+
+		for( int weaponIndex = 0, targetWeaponCount = targetType->GetNumWeapons(); weaponIndex < targetWeaponCount; ++weaponIndex )
+		{
+			if( target->CanFireWeapon( weaponIndex ) )
+			{
+				int damagePercentage = targetType->GetWeaponByIndex( weaponIndex ).GetDamagePercentageAgainstUnitType( unitType );
+				counterDamagePercentage = std::max( counterDamagePercentage, damagePercentage );
+			}
+		}
+
+		Target targetStats;
+		targetStats.TilePos = target->GetTilePos();
+		targetStats.TargetID = target->GetID();
+		targetStats.Health = target->GetHealth();
+		targetStats.CoverBonus = target->GetTile()->GetTerrainType()->GetCoverBonus();
+		targetStats.CounterDamagePercentage = counterDamagePercentage;
+		targetStats.PreferredWeaponIndex = preferredWeaponIndex;
+		mTargets.push_back( targetStats );
+	}
+
+	size_t targetCount = mTargets.size();
+
+	for( auto it = reachableTiles.begin(); it != reachableTiles.end(); ++it )
+	{
+		const Map::Iterator& tile = *it;
+
+		if( !unit->CanOccupyTile( tile ) )
+		{
+			// The Unit can only attack from tiles it is able to stop in.
+			continue;
+		}
+
+		Vec2s tilePos = tile.GetPosition();
+		int tileCoverBonus = tile->GetTerrainType()->GetCoverBonus();
+
+		for( size_t targetIndex = 0; targetIndex < targetCount; ++targetIndex )
+		{
+			const Target& target = mTargets[ targetIndex ];
+
+			if( !attackRange.IsValueInRange( tilePos.GetManhattanDistanceTo( target.TilePos ) ) )
+			{
+				continue;
+			}
+
+			const int* baseDamagePercentages = &mBaseDamagePercentages[ targetIndex * weaponCount ];
+
+			for( size_t i = 0; i < weaponCount; ++i )
+			{
+				int baseDamagePercentage = baseDamagePercentages[ i ];
+
+				if( baseDamagePercentage <= 0 )
+				{
+					continue;
+				}
+
+				Option option;
+				option.TilePos = tilePos;
+				option.TargetID = target.TargetID;
+				option.WeaponIndex = mWeaponIndices[ i ];
+				option.IsPreferredWeapon = ( option.WeaponIndex == target.PreferredWeaponIndex );
+				option.DamagePercentage = CalculateDamagePercentage( baseDamagePercentage, attackerHealth, target.CoverBonus, target.Health );
+				option.ExpectedDamage = CalculateExpectedDamage( option.DamagePercentage, target.Health );
+				option.TargetKillChance = CalculateKillChance( option.DamagePercentage, target.Health );
+				option.KillsTarget = ( option.TargetKillChance >= 1.0f );
+				option.ExpectedCounterDamage = 0.0f;
+				option.AttackerKillChance = 0.0f;
+
+				if( target.CounterDamagePercentage > 0 )
+				{
+					// The target only counter-attacks if it survives, and how hard it hits back depends
+					// on whether the extra damage roll succeeded, so weigh both outcomes.
+					int guaranteedDamage = ( option.DamagePercentage / 10 );
+					float extraDamageChance = ( ( option.DamagePercentage % 10 ) * 0.1f );
+
+					int healthWithoutExtra = ( target.Health - guaranteedDamage );
+					int healthWithExtra = ( healthWithoutExtra - 1 );
+
+					if( healthWithoutExtra > 0 )
+					{
+						int counterPercentage = CalculateDamagePercentage( target.CounterDamagePercentage, healthWithoutExtra, tileCoverBonus, attackerHealth );
+						option.ExpectedCounterDamage += ( 1.0f - extraDamageChance ) * CalculateExpectedDamage( counterPercentage, attackerHealth );
+						option.AttackerKillChance += ( 1.0f - extraDamageChance ) * CalculateKillChance( counterPercentage, attackerHealth );
+					}
+
+					if( healthWithExtra > 0 )
+					{
+						int counterPercentage = CalculateDamagePercentage( target.CounterDamagePercentage, healthWithExtra, tileCoverBonus, attackerHealth );
+						option.ExpectedCounterDamage += extraDamageChance * CalculateExpectedDamage( counterPercentage, attackerHealth );
+						option.AttackerKillChance += extraDamageChance * CalculateKillChance( counterPercentage, attackerHealth );
+					}
+				}
+
+				mOptions.push_back( option );
+			}
+		}
+	}
+}
+
+
+void CombatForecast::Clear()
+{
+	mUnit = nullptr;
+	mTargets.clear();
+	mWeaponIndices.clear();
+	mBaseDamagePercentages.clear();
+	mOptions.clear();
+}
+
+
+const CombatForecast::Option* CombatForecast::FindPreferredOption( const Vec2s& tilePos, int targetID ) const
+{
+	const Option* result = nullptr;
+
+	for( auto it = mOptions.begin(); it != mOptions.end(); ++it )
+	{
+		if( it->IsPreferredWeapon && it->TargetID == targetID && it->TilePos == tilePos )
+		{
+			// Return the Option the rules would actually use for this attack.
+			result = &( *it );
+			break;
+		}
+	}
+
+	return result;
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+namespace mage
+{
+	/**
+	 * Predicts the outcome of every attack a Unit could make this turn.
+	 *
+	 * All stats needed for the prediction (weapon damage tables, health, cover) are flattened
+	 * up front so the (tile, target, weapon) loop is pure arithmetic. Calculate() does not log,
+	 * and once the internal buffers have grown to fit the largest query it does not allocate.
+	 */
+	class CombatForecast
+	{
+	public:
+		/**
+		 * The predicted result of attacking one target with one weapon from one tile.
+		 */
+		struct Option
+		{
+			Vec2s TilePos;
+			int TargetID;
+			int WeaponIndex;
+			bool IsPreferredWeapon;
+			bool KillsTarget;
+			int DamagePercentage;
+			float ExpectedDamage;
+			float ExpectedCounterDamage;
+			float TargetKillChance;
+			float AttackerKillChance;
+		};
+
+		typedef std::vector< Option > Options;
+
+		static int CalculateDamagePercentage( int baseDamagePercentage, int attackerHealth, int targetCoverBonus, int targetHealth );
+
+		CombatForecast();
+		~CombatForecast();
+
+		void Calculate( const Unit* unit, const Map::TileSet& reachableTiles );
+		void Clear();
+
+		const Unit* GetUnit() const;
+		const Options& GetOptions() const;
+		size_t GetOptionCount() const;
+		bool HasOptions() const;
+		const Option* FindPreferredOption( const Vec2s& tilePos, int targetID ) const;
+
+	private:
+		/**
+		 * Flattened stats for a single potential target.
+		 */
+		struct Target
+		{
+			Vec2s TilePos;
+			int TargetID;
+			int Health;
+			int CoverBonus;
+			int CounterDamagePercentage;
+			int PreferredWeaponIndex;
+		};
+
+		typedef std::vector< Target > Targets;
+
+		static float CalculateExpectedDamage( int damagePercentage, int targetHealth );
+		static float CalculateKillChance( int damagePercentage, int targetHealth );
+
+		const Unit* mUnit;
+		Targets mTargets;
+		std::vector< int > mWeaponIndices;
+		std::vector< int > mBaseDamagePercentages;
+		Options mOptions;
+	};
+
+
+	inline const Unit* CombatForecast::GetUnit() const
+	{
+		return mUnit;
+	}
+
+
+	inline const CombatForecast::Options& CombatForecast::GetOptions() const
+	{
+		return mOptions;
+	}
+
+
+	inline size_t CombatForecast::GetOptionCount() const
+	{
+		return mOptions.size();
+	}
+
+
+	inline bool CombatForecast::HasOptions() const
+	{
+		return ( mOptions.size() > 0 );
+	}
+}
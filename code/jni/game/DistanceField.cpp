@@ -0,0 +1,188 @@
+#include "androidwars.h"
+
+using namespace mage;
+
+
+DistanceField::DistanceField() :
+	mMap( nullptr ),
+	mMovementType( nullptr ),
+	mWidth( 0 ),
+	mHeight( 0 ),
+	mGoalCount( 0 ),
+	mIsDirty( true )
+{ }
+
+
+DistanceField::~DistanceField() { }
+
+
+void DistanceField::Build( const Map* map, const MovementType* movementType, const Goals& goals )
+{
+	assertion( map, "Cannot build DistanceField for null Map!" );
+
+	mMap = map;
+	mMovementType = movementType;
+	mWidth = map->GetWidth();
+	mHeight = map->GetHeight();
+	mGoalCount = 0;
+	mIsDirty = false;
+
+	size_t tileCount = ( (size_t) mWidth * (size_t) mHeight );
+	mCostsToEnter.resize( tileCount );
+	mDistances.assign( tileCount, UNREACHABLE );
+	mOpenList.clear();
+
+	for( short y = 0; y < mHeight; ++y )
+	{
+		for( short x = 0; x < mWidth; ++x )
+		{
+			// Cache the cost of entering each Tile so the search never has to look up movement costs.
+			// Without a MovementType, every Tile with terrain costs one point to enter.
+			Map::ConstIterator tile = map->GetTile( x, y );
+			TerrainType* terrainType = tile->GetTerrainType();
+			int costToEnter = UNREACHABLE;
+
+			if( terrainType )
+			{
+				costToEnter = ( movementType ? movementType->GetMovementCostAcrossTerrain( terrainType ) : 1 );
+			}
+
+			mCostsToEnter[ GetTileIndex( Vec2s( x, y ) ) ] = costToEnter;
+		}
+	}
+
+	for( auto it = goals.begin(); it != goals.end(); ++it )
+	{
+		const Vec2s& tilePos = *it;
+
+		if( IsValidTilePos( tilePos ) )
+		{
+			// Seed the search with every goal that can be entered.
+			int tileIndex = GetTileIndex( tilePos );
+
+			if( mCostsToEnter[ tileIndex ] >= 0 && mDistances[ tileIndex ] != 0 )
+			{
+				mDistances[ tileIndex ] = 0;
+				mOpenList.push_back( OpenEntry( 0, tileIndex ) );
+				++mGoalCount;
+			}
+		}
+	}
+
+	// Expand outward from all goals at once.
+	std::make_heap( mOpenList.begin(), mOpenList.end(), std::greater< OpenEntry >() );
+	Propagate();
+}
+
+
+void DistanceField::AddGoal( const Vec2s& tilePos )
+{
+	if( !mIsDirty && IsValidTilePos( tilePos ) )
+	{
+		int tileIndex = GetTileIndex( tilePos );
+
+		if( mCostsToEnter[ tileIndex ] >= 0 && mDistances[ tileIndex ] != 0 )
+		{
+			// A new goal can only make distances shorter, so only the Tiles that are now closer
+			// to the new goal than to any existing goal need to be revisited.
+			mDistances[ tileIndex ] = 0;
+			mOpenList.clear();
+			mOpenList.push_back( OpenEntry( 0, tileIndex ) );
+			++mGoalCount;
+
+			Propagate();
+		}
+	}
+}
+
+
+void DistanceField::Invalidate()
+{
+	mIsDirty = true;
+}
+
+
+void DistanceField::Clear()
+{
+	mMap = nullptr;
+	mMovementType = nullptr;
+	mWidth = 0;
+	mHeight = 0;
+	mGoalCount = 0;
+	mIsDirty = true;
+	mCostsToEnter.clear();
+	mDistances.clear();
+	mOpenList.clear();
+}
+
+
+PrimaryDirection DistanceField::GetDirectionToGoal( const Vec2s& tilePos ) const
+{
+	PrimaryDirection result = PrimaryDirection::NONE;
+	int distance = GetDistance( tilePos );
+
+	if( distance > 0 )
+	{
+		for( size_t i = 0; i < CARDINAL_DIRECTION_COUNT; ++i )
+		{
+			// Find an adjacent Tile that lies on a shortest path to the nearest goal.
+			PrimaryDirection direction = CARDINAL_DIRECTIONS[ i ];
+			Vec2s adjacentPos = Map::GetAdjacentTilePos( tilePos, direction );
+			int adjacentDistance = GetDistance( adjacentPos );
+
+			if( adjacentDistance != UNREACHABLE && ( adjacentDistance + mCostsToEnter[ GetTileIndex( adjacentPos ) ] ) == distance )
+			{
+				result = direction;
+				break;
+			}
+		}
+	}
+
+	return result;
+}
+
+
+void DistanceField::Propagate()
+{
+	std::greater< OpenEntry > compare;
+
+	while( !mOpenList.empty() )
+	{
+		// Pop the closest Tile off the open list.
+		std::pop_heap( mOpenList.begin(), mOpenList.end(), compare );
+		OpenEntry entry = mOpenList.back();
+		mOpenList.pop_back();
+
+		int distance = entry.first;
+		int tileIndex = entry.second;
+
+		if( distance > mDistances[ tileIndex ] )
+		{
+			// Skip stale entries for Tiles that were already reached more cheaply.
+			continue;
+		}
+
+		// Units on adjacent Tiles reach this Tile by paying its cost to enter.
+		int adjacentDistance = ( distance + mCostsToEnter[ tileIndex ] );
+		Vec2s tilePos( tileIndex % mWidth, tileIndex / mWidth );
+
+		for( size_t i = 0; i < CARDINAL_DIRECTION_COUNT; ++i )
+		{
+			Vec2s adjacentPos = Map::GetAdjacentTilePos( tilePos, CARDINAL_DIRECTIONS[ i ] );
+
+			if( IsValidTilePos( adjacentPos ) )
+			{
+				int adjacentIndex = GetTileIndex( adjacentPos );
+				int& bestDistance = mDistances[ adjacentIndex ];
+
+				if( mCostsToEnter[ adjacentIndex ] >= 0 && ( bestDistance == UNREACHABLE || adjacentDistance < bestDistance ) )
+				{
+					// If the adjacent Tile is passable and this is the shortest way to a goal found so far, record it.
+					bestDistance = adjacentDistance;
+					mOpenList.push_back( OpenEntry( adjacentDistance, adjacentIndex ) );
+					std::push_heap( mOpenList.begin(), mOpenList.end(), compare );
+				}
+			}
+		}
+	}
+}
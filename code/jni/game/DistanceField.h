@@ -0,0 +1,122 @@
+#pragma once
+
+namespace mage
+{
+	/**
+	 * Stores the cost of moving from every Tile on a Map to the nearest of a set of goal tiles.
+	 *
+	 * The field is built with a single multi-source Dijkstra search, after which the distance (and the next
+	 * step toward the nearest goal) can be looked up for any Tile in constant time. Goals added after the
+	 * field is built are merged in incrementally; removing a goal marks the field as dirty so it gets rebuilt.
+	 */
+	class DistanceField
+	{
+	public:
+		static const int UNREACHABLE = -1;
+
+		typedef std::vector< Vec2s > Goals;
+
+		DistanceField();
+		~DistanceField();
+
+		void Build( const Map* map, const MovementType* movementType, const Goals& goals );
+		void AddGoal( const Vec2s& tilePos );
+		void Invalidate();
+		void Clear();
+
+		int GetDistance( const Vec2s& tilePos ) const;
+		int GetDistance( short x, short y ) const;
+		bool IsReachable( const Vec2s& tilePos ) const;
+		PrimaryDirection GetDirectionToGoal( const Vec2s& tilePos ) const;
+
+		const Map* GetMap() const;
+		const MovementType* GetMovementType() const;
+		short GetWidth() const;
+		short GetHeight() const;
+		size_t GetGoalCount() const;
+		bool IsDirty() const;
+
+	private:
+		typedef std::pair< int, int > OpenEntry;
+
+		int GetTileIndex( const Vec2s& tilePos ) const;
+		bool IsValidTilePos( const Vec2s& tilePos ) const;
+		void Propagate();
+
+		const Map* mMap;
+		const MovementType* mMovementType;
+		short mWidth;
+		short mHeight;
+		size_t mGoalCount;
+		bool mIsDirty;
+		std::vector< int > mCostsToEnter;
+		std::vector< int > mDistances;
+		std::vector< OpenEntry > mOpenList;
+	};
+
+
+	inline int DistanceField::GetDistance( const Vec2s& tilePos ) const
+	{
+		return ( IsValidTilePos( tilePos ) ? mDistances[ GetTileIndex( tilePos ) ] : UNREACHABLE );
+	}
+
+
+	inline int DistanceField::GetDistance( short x, short y ) const
+	{
+		return GetDistance( Vec2s( x, y ) );
+	}
+
+
+	inline bool DistanceField::IsReachable( const Vec2s& tilePos ) const
+	{
+		return ( GetDistance( tilePos ) != UNREACHABLE );
+	}
+
+
+	inline const Map* DistanceField::GetMap() const
+	{
+		return mMap;
+	}
+
+
+	inline const MovementType* DistanceField::GetMovementType() const
+	{
+		return mMovementType;
+	}
+
+
+	inline short DistanceField::GetWidth() const
+	{
+		return mWidth;
+	}
+
+
+	inline short DistanceField::GetHeight() const
+	{
+		return mHeight;
+	}
+
+
+	inline size_t DistanceField::GetGoalCount() const
+	{
+		return mGoalCount;
+	}
+
+
+	inline bool DistanceField::IsDirty() const
+	{
+		return mIsDirty;
+	}
+
+
+	inline int DistanceField::GetTileIndex( const Vec2s& tilePos ) const
+	{
+		return ( tilePos.y * mWidth + tilePos.x );
+	}
+
+
+	inline bool DistanceField::IsValidTilePos( const Vec2s& tilePos ) const
+	{
+		return ( tilePos.x >= 0 && tilePos.y >= 0 && tilePos.x < mWidth && tilePos.y < mHeight );
+	}
+}
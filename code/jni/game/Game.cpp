@@ -4,10 +4,12 @@ using namespace mage;
 
 
 Game::Game() :
-	mStatus( STATUS_NOT_STARTED ),
-	mCamera( nullptr ),
 	mCurrentTurnIndex( -1 ),
-	mCurrentFactionIndex( -1 )
+	mCurrentFactionIndex( -1 ),
+	mMap( nullptr ),
+	mCamera( nullptr ),
+	mLocalPlayer( nullptr ),
+	mStatus( STATUS_NOT_STARTED )
 { }
 
 
@@ -77,7 +79,14 @@ bool Game::IsGameOver() const
 
 void Game::Destroy()
 {
-	// TODO
+	// Release all Factions and destroy all Players.
+	mFactionControllerMappings.clear();
+	mLocalPlayer = nullptr;
+	DestroyAllPlayers();
+
+	// Forget the Map.
+	mMap = nullptr;
+	mStatus = STATUS_NOT_STARTED;
 }
 
 
@@ -148,6 +157,9 @@ void Game::StartTurn()
 
 	// Let the current Faction process the next turn.
 	faction->OnTurnStart( mCurrentTurnIndex );
+
+	// Fire the turn start callback.
+	OnTurnStart.Invoke( mCurrentTurnIndex, faction );
 }
 
 
@@ -161,6 +173,9 @@ void Game::EndTurn()
 
 	// Notify the current Faction that the turn is over.
 	faction->OnTurnEnd( mCurrentTurnIndex );
+
+	// Fire the turn end callback.
+	OnTurnEnd.Invoke( mCurrentTurnIndex, faction );
 }
 
 
@@ -496,6 +511,12 @@ Scenario* Game::GetScenario() const
 }
 
 
+int Game::GetTurnNumber() const
+{
+	return mCurrentTurnIndex;
+}
+
+
 void Game::NextTurn()
 {
 	assertion( mStatus == STATUS_IN_PROGRESS, "Cannot advance turn for Game that is not in progress!" );
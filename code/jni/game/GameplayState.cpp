@@ -6,6 +6,7 @@ using namespace mage;
 GameplayState::GameplayState() :
 	GameState(),
 	mIsNetworkGame( false ),
+	mShowFrontline( false ),
 	mSelectUnitInputState( nullptr ),
 	mMoveUnitInputState( nullptr ),
 	mSelectActionInputState( nullptr ),
@@ -43,140 +44,52 @@ void GameplayState::OnEnter( const Dictionary& parameters )
 	bool success = mScenario.LoadDataFromFile( "data/Data.json" );
 	assertion( success, "The Scenario file \"%s\" could not be opened!" );
 
-	// Create a new Map and paint it with default tiles.
+	// Create a new Map.
 	mMap.Init( &mScenario );
-	mMap.Resize( 16, 12 );
-	mMap.FillWithDefaultTerrainType();
 
-	// Hacky map generation stuff (for testing).
-	// TODO: Remove this.
-	Tile tile;
-	RectS area;
-
-	TerrainType* seaTerrainType  = mScenario.TerrainTypes.FindByName( "Sea" );
-	TerrainType* roadTerrainType = mScenario.TerrainTypes.FindByName( "Road" );
-	TerrainType* cityTerrainType = mScenario.TerrainTypes.FindByName( "City" );
-
-	tile.SetTerrainType( seaTerrainType );
-	area.Left = 6;
-	area.Top = 0;
-	area.Right = 10;
-	area.Bottom = 5;
-	mMap.Fill( tile, area );
-
-	area.Left = 6;
-	area.Top = 7;
-	area.Right = 10;
-	area.Bottom = 12;
-	mMap.Fill( tile, area );
-
-	area.Left = 0;
-	area.Top = 4;
-	area.Right = 2;
-	area.Bottom = 8;
-	mMap.Fill( tile, area );
-
-	area.Left = 14;
-	area.Top = 4;
-	area.Right = 16;
-	area.Bottom = 8;
-	mMap.Fill( tile, area );
-
-	tile.SetTerrainType( roadTerrainType );
-	area.Left = 0;
-	area.Top = 3;
-	area.Right = 16;
-	area.Bottom = 4;
-	mMap.Fill( tile, area );
-
-	area.Left = 0;
-	area.Top = 8;
-	area.Right = 16;
-	area.Bottom = 9;
-	mMap.Fill( tile, area );
-
-	area.Left = 2;
-	area.Top = 0;
-	area.Right = 3;
-	area.Bottom = 12;
-	mMap.Fill( tile, area );
-
-	area.Left = 13;
-	area.Top = 0;
-	area.Right = 14;
-	area.Bottom = 12;
-	mMap.Fill( tile, area );
-
-	tile.SetTerrainType( cityTerrainType );
-	area.Left = 5;
-	area.Top = 5;
-	area.Right = 6;
-	area.Bottom = 7;
-	mMap.Fill( tile, area );
-
-	area.Left = 10;
-	area.Top = 5;
-	area.Right = 11;
-	area.Bottom = 7;
-	mMap.Fill( tile, area );
-
-	area.Left = 3;
-	area.Top = 2;
-	area.Right = 5;
-	area.Bottom = 3;
-	mMap.Fill( tile, area );
-
-	area.Left = 11;
-	area.Top = 2;
-	area.Right = 13;
-	area.Bottom = 3;
-	mMap.Fill( tile, area );
+	// Build the test Map.
+	// TODO: Load this from a file.
+	GenerateTestMap( &mMap );
 
-	area.Left = 3;
-	area.Top = 9;
-	area.Right = 5;
-	area.Bottom = 10;
-	mMap.Fill( tile, area );
-
-	area.Left = 11;
-	area.Top = 9;
-	area.Right = 13;
-	area.Bottom = 10;
-	mMap.Fill( tile, area );
+	// Create a local Player.
+	Player* localPlayer = mGame.CreatePlayer();
+	mGame.SetLocalPlayer( localPlayer );
 
-	area.Left = 7;
-	area.Top = 5;
-	area.Right = 9;
-	area.Bottom = 7;
-	mMap.Fill( tile, area );
+	// Determine how many Factions should be played by the computer (counting back from the last Faction).
+	// By default, the local Player controls all Factions.
+	int computerFactionCount = parameters.Get( "computerFactionCount", 0 );
+	const Map::Factions& factions = mMap.GetFactions();
+	Player* computerPlayer = nullptr;
 
-	// Create Factions.
-	Faction* redFaction = mMap.CreateFaction();
-	redFaction->SetControllable( true );
-	redFaction->SetColor( Color::RED );
+	for( size_t i = 0, factionCount = factions.size(); i < factionCount; ++i )
+	{
+		Faction* faction = factions[ i ];
 
-	Faction* blueFaction = mMap.CreateFaction();
-	blueFaction->SetControllable( true );
-	blueFaction->SetColor( Color::BLUE );
+		if( (int) ( factionCount - i ) <= computerFactionCount )
+		{
+			if( !computerPlayer )
+			{
+				// Create a Player to represent the computer.
+				computerPlayer = mGame.CreatePlayer();
+			}
 
-	// Create two test Units.
-	// TODO: Remove this.
-	UnitType* testUnitType = mScenario.UnitTypes.FindByName( "Tank" );
+			// Give the computer control of the Faction and create an AI to play it.
+			mGame.GivePlayerControlOfFaction( computerPlayer, faction );
+			mAIControllers.push_back( new AIController( &mMap, faction ) );
+		}
+		else
+		{
+			// Give the local Player control of the Faction.
+			mGame.GivePlayerControlOfFaction( localPlayer, faction );
+		}
+	}
 
-	mMap.CreateUnit( testUnitType, redFaction, 5, 5 );
-	mMap.CreateUnit( testUnitType, redFaction, 3, 3 );
-	mMap.CreateUnit( testUnitType, redFaction, 3, 7 );
+	// Optionally highlight the frontline of whichever Faction is taking its turn.
+	mShowFrontline = ( parameters.Get( "showFrontline", 0 ) != 0 );
 
-	mMap.CreateUnit( testUnitType, blueFaction, 10, 5, 9 );
-	mMap.CreateUnit( testUnitType, blueFaction, 12, 3 );
-	mMap.CreateUnit( testUnitType, blueFaction, 12, 7 );
-
-	// Create a local Player controlling both Factions.
-	Player* localPlayer = mGame.CreatePlayer();
-	mGame.SetLocalPlayer( localPlayer );
-
-	mGame.GivePlayerControlOfFaction( localPlayer, redFaction );
-	mGame.GivePlayerControlOfFaction( localPlayer, blueFaction );
+	// Let the AI know when its turns start and end.
+	mGame.OnTurnStart.AddCallback( this, &GameplayState::TurnStarted );
+	mGame.OnTurnEnd.AddCallback( this, &GameplayState::TurnEnded );
 
 	// Initialize the Game.
 	mGame.Init( &mMap );
@@ -203,8 +116,11 @@ void GameplayState::OnEnter( const Dictionary& parameters )
 			// Bind the next turn callback to the next turn button.
 			nextTurnButton->SetOnClickDelegate( [this]()
 			{
-				// Go to the next turn.
-				mGame.NextTurn();
+				if( !GetAIControllerForFaction( mGame.GetCurrentFaction() ) )
+				{
+					// Go to the next turn (unless the computer is still playing its turn).
+					mGame.NextTurn();
+				}
 			});
 		}
 	}
@@ -267,6 +183,9 @@ void GameplayState::OnUpdate( float elapsedTime )
 		mMapView.Update( elapsedTime );
 	}
 
+	// Let the computer play its turn.
+	UpdateAIControllers();
+
 	// Update all Widgets.
 	GameState::OnUpdate( elapsedTime );
 }
@@ -285,8 +204,171 @@ void GameplayState::OnDraw()
 }
 
 
+float GameplayState::GetIdleTime() const
+{
+	float result = -1.0f;
+
+	if( HasPendingStateChange() || ( mGame.IsInProgress() && GetAIControllerForFaction( mGame.GetCurrentFaction() ) ) )
+	{
+		// Keep running frames while the computer is taking its turn.
+		result = 0.0f;
+	}
+	else if( mMapView.IsInitialized() )
+	{
+		// Otherwise, wait for the MapView to animate.
+		result = mMapView.GetIdleTime();
+	}
+
+	return result;
+}
+
+
+void GameplayState::GenerateTestMap( Map* map )
+{
+	assertion( map, "Cannot generate test Map for null Map!" );
+
+	Scenario* scenario = map->GetScenario();
+	assertion( scenario, "Cannot generate test Map for Map without a Scenario!" );
+
+	// Paint the Map with default tiles.
+	map->Resize( 16, 12 );
+	map->FillWithDefaultTerrainType();
+
+	// Hacky map generation stuff (for testing).
+	// TODO: Remove this.
+	Tile tile;
+	RectS area;
+
+	TerrainType* seaTerrainType  = scenario->TerrainTypes.FindByName( "Sea" );
+	TerrainType* roadTerrainType = scenario->TerrainTypes.FindByName( "Road" );
+	TerrainType* cityTerrainType = scenario->TerrainTypes.FindByName( "City" );
+
+	tile.SetTerrainType( seaTerrainType );
+	area.Left = 6;
+	area.Top = 0;
+	area.Right = 10;
+	area.Bottom = 5;
+	map->Fill( tile, area );
+
+	area.Left = 6;
+	area.Top = 7;
+	area.Right = 10;
+	area.Bottom = 12;
+	map->Fill( tile, area );
+
+	area.Left = 0;
+	area.Top = 4;
+	area.Right = 2;
+	area.Bottom = 8;
+	map->Fill( tile, area );
+
+	area.Left = 14;
+	area.Top = 4;
+	area.Right = 16;
+	area.Bottom = 8;
+	map->Fill( tile, area );
+
+	tile.SetTerrainType( roadTerrainType );
+	area.Left = 0;
+	area.Top = 3;
+	area.Right = 16;
+	area.Bottom = 4;
+	map->Fill( tile, area );
+
+	area.Left = 0;
+	area.Top = 8;
+	area.Right = 16;
+	area.Bottom = 9;
+	map->Fill( tile, area );
+
+	area.Left = 2;
+	area.Top = 0;
+	area.Right = 3;
+	area.Bottom = 12;
+	map->Fill( tile, area );
+
+	area.Left = 13;
+	area.Top = 0;
+	area.Right = 14;
+	area.Bottom = 12;
+	map->Fill( tile, area );
+
+	tile.SetTerrainType( cityTerrainType );
+	area.Left = 5;
+	area.Top = 5;
+	area.Right = 6;
+	area.Bottom = 7;
+	map->Fill( tile, area );
+
+	area.Left = 10;
+	area.Top = 5;
+	area.Right = 11;
+	area.Bottom = 7;
+	map->Fill( tile, area );
+
+	area.Left = 3;
+	area.Top = 2;
+	area.Right = 5;
+	area.Bottom = 3;
+	map->Fill( tile, area );
+
+	area.Left = 11;
+	area.Top = 2;
+	area.Right = 13;
+	area.Bottom = 3;
+	map->Fill( tile, area );
+
+	area.Left = 3;
+	area.Top = 9;
+	area.Right = 5;
+	area.Bottom = 10;
+	map->Fill( tile, area );
+
+	area.Left = 11;
+	area.Top = 9;
+	area.Right = 13;
+	area.Bottom = 10;
+	map->Fill( tile, area );
+
+	area.Left = 7;
+	area.Top = 5;
+	area.Right = 9;
+	area.Bottom = 7;
+	map->Fill( tile, area );
+
+	// Create Factions.
+	Faction* redFaction = map->CreateFaction();
+	redFaction->SetControllable( true );
+	redFaction->SetColor( Color::RED );
+
+	Faction* blueFaction = map->CreateFaction();
+	blueFaction->SetControllable( true );
+	blueFaction->SetColor( Color::BLUE );
+
+	// Create two test Units.
+	// TODO: Remove this.
+	UnitType* testUnitType = scenario->UnitTypes.FindByName( "Tank" );
+
+	map->CreateUnit( testUnitType, redFaction, 5, 5 );
+	map->CreateUnit( testUnitType, redFaction, 3, 3 );
+	map->CreateUnit( testUnitType, redFaction, 3, 7 );
+
+	map->CreateUnit( testUnitType, blueFaction, 10, 5, 9 );
+	map->CreateUnit( testUnitType, blueFaction, 12, 3 );
+	map->CreateUnit( testUnitType, blueFaction, 12, 7 );
+}
+
+
 void GameplayState::OnExit()
 {
+	for( auto it = mAIControllers.begin(); it != mAIControllers.end(); ++it )
+	{
+		// Destroy all AIControllers (stopping their worker threads).
+		delete *it;
+	}
+
+	mAIControllers.clear();
+
 	if( mGameplayInterface )
 	{
 		// Destroy the gameplay interface.
@@ -299,6 +381,20 @@ void GameplayState::OnExit()
 		gWidgetManager->DestroyWidget( mUnitInfoOverlay );
 	}
 
+	if( mMapView.IsInitialized() )
+	{
+		// Destroy the MapView before the Map it shows.
+		mMapView.Destroy();
+	}
+
+	// Destroy the Game and the Map (and all of their Units).
+	mGame.Destroy();
+
+	if( mMap.IsInitialized() )
+	{
+		mMap.Destroy();
+	}
+
 	DebugPrintf( "GameplayState exited!" );
 }
 
@@ -336,6 +432,80 @@ void GameplayState::PerformAction( Ability::Action* action )
 }
 
 
+AIController* GameplayState::GetAIControllerForFaction( Faction* faction ) const
+{
+	AIController* result = nullptr;
+
+	for( auto it = mAIControllers.begin(); it != mAIControllers.end(); ++it )
+	{
+		if( ( *it )->GetFaction() == faction )
+		{
+			result = *it;
+			break;
+		}
+	}
+
+	return result;
+}
+
+
+void GameplayState::TurnStarted( int turnIndex, Faction* faction )
+{
+	if( mShowFrontline )
+	{
+		// Show where the current Faction's Units meet the enemy.
+		mMapView.SetFrontlineFaction( faction );
+	}
+
+	AIController* aiController = GetAIControllerForFaction( faction );
+
+	if( aiController )
+	{
+		// If the computer controls this Faction, let it start thinking.
+		aiController->StartTurn();
+	}
+}
+
+
+void GameplayState::TurnEnded( int turnIndex, Faction* faction )
+{
+	AIController* aiController = GetAIControllerForFaction( faction );
+
+	if( aiController )
+	{
+		// Stop the computer from thinking once its turn is over.
+		aiController->EndTurn();
+	}
+}
+
+
+void GameplayState::UpdateAIControllers()
+{
+	AIController* aiController = GetAIControllerForFaction( mGame.GetCurrentFaction() );
+
+	// Only let the computer act while the game is waiting for a Unit to be selected
+	// (i.e. not while the previous Action is still being animated).
+	bool isIdle = ( GetActiveState() == mSelectUnitInputState && !HasPendingStateChange() && !mMapView.IsPlayingMapAnimation() );
+
+	if( aiController && isIdle && mGame.IsInProgress() )
+	{
+		// Give the AI a slice of this frame.
+		Ability::Action* action = aiController->Update();
+
+		if( action )
+		{
+			// Perform the Action the AI chose.
+			PerformAction( action );
+		}
+		else if( aiController->IsTurnFinished() )
+		{
+			// End the turn once the AI is out of things to do.
+			mGame.NextTurn();
+		}
+	}
+}
+
+
 Game* GameplayState::GetGame()
 {
 	return &mGame;
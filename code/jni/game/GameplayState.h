@@ -14,6 +14,8 @@ namespace mage
 	class GameplayState : public GameState
 	{
 	public:
+		static void GenerateTestMap( Map* map );
+
 		GameplayState();
 		virtual ~GameplayState();
 
@@ -25,6 +27,7 @@ namespace mage
 		const MapView* GetMapView() const;
 
 		void PerformAction( Ability::Action* action );
+		AIController* GetAIControllerForFaction( Faction* faction ) const;
 
 		SelectUnitInputState* GetSelectUnitInputState() const;
 		MoveUnitInputState* GetMoveUnitInputState() const;
@@ -48,8 +51,14 @@ namespace mage
 		virtual bool OnPointerDown( const Pointer& pointer );
 		virtual bool OnPointerUp( const Pointer& pointer );
 		virtual bool OnPointerMotion( const Pointer& activePointer, const PointersByID& pointersByID );
+		virtual float GetIdleTime() const;
+
+		void TurnStarted( int turnIndex, Faction* faction );
+		void TurnEnded( int turnIndex, Faction* faction );
+		void UpdateAIControllers();
 
 		bool mIsNetworkGame;
+		bool mShowFrontline;
 		Widget* mGameplayInterface;
 		Widget* mUnitInfoOverlay;
 		SelectUnitInputState* mSelectUnitInputState;
@@ -57,6 +66,7 @@ namespace mage
 		SelectActionInputState* mSelectActionInputState;
 		SelectTargetInputState* mSelectTargetInputState;
 		PerformActionInputState* mPerformActionInputState;
+		std::vector< AIController* > mAIControllers;
 		Scenario mScenario;
 		Game mGame;
 		Map mMap;
@@ -212,10 +212,35 @@ Map::Map() :
 	mScenario( nullptr ),
 	mNextSearchIndex( 0 ),
 	mNextUnitID( 0 )
-{ }
+{
+	ForEachTileInMaxArea( [ this ]( const Iterator& tile )
+	{
+		// Hook up the tile callbacks once, so the Map can be initialized and destroyed repeatedly.
+		tile->OnChanged.AddCallback( [ this, tile ]()
+		{
+			// When the Tile changes, notify the Map that the Tile has changed.
+			TileChanged( tile );
+		});
 
+		tile->OnOwnerChanged.AddCallback( [ this, tile ]( Faction* formerOwner, Faction* owner )
+		{
+			// When the Tile changes hands, update any cached DistanceFields.
+			TileOwnerChanged( tile );
+		});
+	});
+}
 
-Map::~Map() { }
+
+Map::~Map()
+{
+	if( mIsInitialized )
+	{
+		// Destroy the Units through the Map, so they are never left for the Unit pool to clean up.
+		Destroy();
+	}
+
+	DestroyAllDistanceFields();
+}
 
 
 void Map::Init( Scenario* scenario )
@@ -242,16 +267,10 @@ void Map::Init( Scenario* scenario )
 	// Get the default TerrainType for the Scenario.
 	TerrainType* defaultTerrainType = mScenario->GetDefaultTerrainType();
 
-	ForEachTileInMaxArea( [ this, defaultTerrainType ]( const Iterator& tile )
+	ForEachTileInMaxArea( [ defaultTerrainType ]( const Iterator& tile )
 	{
 		// Initialize all tiles to the default TerrainType.
 		tile->SetTerrainType( defaultTerrainType );
-
-		tile->OnChanged.AddCallback( [ this, tile ]()
-		{
-			// When the Tile changes, notify the Map that the Tile has changed.
-			TileChanged( tile );
-		});
 	});
 }
 
@@ -260,6 +279,16 @@ void Map::Destroy()
 {
 	assertion( mIsInitialized, "Cannot destroy Map that has not been initialized!" );
 
+	// Destroy all Units and Factions.
+	DestroyAllUnits();
+	DestroyAllFaction();
+
+	// Destroy all Abilities.
+	UnregisterAllAbilities();
+
+	// Destroy all cached DistanceFields.
+	DestroyAllDistanceFields();
+
 	// Clear the scenario.
 	mScenario = nullptr;
 
@@ -268,6 +297,12 @@ void Map::Destroy()
 }
 
 
+bool Map::IsInitialized() const
+{
+	return mIsInitialized;
+}
+
+
 void Map::SaveToJSON( rapidjson::Document& document, rapidjson::Value& object )
 {
 	/*
@@ -548,6 +583,18 @@ void Map::DestroyFaction( Faction* faction )
 }
 
 
+void Map::DestroyAllFaction()
+{
+	for( auto it = mFactions.begin(); it != mFactions.end(); ++it )
+	{
+		// Destroy each Faction.
+		delete *it;
+	}
+
+	mFactions.clear();
+}
+
+
 bool Map::AreFriends( const Faction* first, const Faction* second ) const
 {
 	bool result = false;
@@ -585,8 +632,8 @@ Unit* Map::CreateUnit( UnitType* unitType, Faction* owner, const Vec2s& tilePos,
 	{
 		if( tile->IsEmpty() )
 		{
-			// Create a new Unit.
-			unit = new Unit();
+			// Create a new Unit (recycling the memory of destroyed Units).
+			unit = mUnitPool.Create();
 
 			// Load Unit properties.
 			unit->SetUnitType( unitType );
@@ -633,6 +680,9 @@ Unit* Map::CreateUnit( UnitType* unitType, Faction* owner, const Vec2s& tilePos,
 			assertion( mUnitsByID.find( unitID ) == mUnitsByID.end(), "Cannot create Unit because a Unit with the same ID (%d) already exists!", unitID );
 			mUnitsByID[ unitID ] = unit;
 
+			// Let any DistanceFields that track Units know that a Unit appeared.
+			UnitTileChanged( unit );
+
 			if( mIsInitialized )
 			{
 				// Call the Unit created callback.
@@ -689,35 +739,57 @@ Ability* Map::GetAbilityByType( const HashString& name ) const
 }
 
 
-void Map::DetermineAvailableActions( const Unit* unit, const Path& movementPath, Actions& result )
+size_t Map::GetAbilityCount() const
 {
-	// Clear the list of results.
-	result.clear();
+	return mAbilities.size();
+}
 
-	for( auto it = mAbilitiesByType.begin(); it != mAbilitiesByType.end(); ++it )
+
+Ability* Map::GetAbilityByIndex( size_t index ) const
+{
+	Ability* result = nullptr;
+
+	if( index < mAbilities.size() )
 	{
-		// Try to cast each Ability to a UnitAbility.
-		Ability* ability = it->second;
-		UnitAbility* unitAbility = dynamic_cast< UnitAbility* >( ability );
+		result = mAbilities[ index ];
+	}
 
-		if( unitAbility )
-		{
-			// Ask each UnitAbility for a list of possible actions after the Unit moves along the path.
-			unitAbility->DetermineAvailableActions( unit, movementPath, result );
-		}
+	return result;
+}
+
+
+void Map::DetermineAvailableActions( const Unit* unit, const Path& movementPath, ActionArena& arena, Actions& result )
+{
+	// Clear the list of results and destroy the Actions from the previous query.
+	result.clear();
+	arena.Reset();
+
+	// Share a single copy of the movement Path between all Actions.
+	arena.SharePath( movementPath );
+
+	for( auto it = mUnitAbilities.begin(); it != mUnitAbilities.end(); ++it )
+	{
+		// Ask each UnitAbility for a list of possible actions after the Unit moves along the path.
+		UnitAbility* unitAbility = *it;
+		unitAbility->DetermineAvailableActions( unit, arena, result );
 	}
 }
 
 
 void Map::PerformAction( Ability::Action* action )
 {
-	// Find the Ability to activate for the specified Action.
-	auto it = mAbilitiesByType.find( action->GetType() );
+	// Try to dispatch the Action directly to the Ability that created it.
+	Ability* ability = GetAbilityByIndex( action->AbilityIndex );
 
-	if( it != mAbilitiesByType.end() )
+	if( !ability || !ability->CanProcessAction( action ) )
+	{
+		// If the Action wasn't created by a registered Ability (e.g. it was loaded from JSON), look up the Ability by type.
+		ability = GetAbilityByType( action->GetType() );
+	}
+
+	if( ability )
 	{
 		// If an Ability was found that can process the Action, activate the ability.
-		Ability* ability = it->second;
 		ability->ProcessAction( action );
 	}
 	else
@@ -728,6 +800,13 @@ void Map::PerformAction( Ability::Action* action )
 
 
 void Map::FindReachableTiles( const Unit* unit, TileSet& result )
+{
+	FindReachableTilesInto( unit, result );
+}
+
+
+template< class TileContainer >
+void Map::FindReachableTilesInto( const Unit* unit, TileContainer& result )
 {
 	int searchIndex = ReserveSearchIndex();
 
@@ -758,7 +837,7 @@ void Map::FindReachableTiles( const Unit* unit, TileSet& result )
 
 		// Close the tile and add it to the result.
 		tile->Close( searchIndex );
-		result.insert( tile );
+		result.insert( result.end(), tile );
 
 		for( int i = 0; i < CARDINAL_DIRECTION_COUNT; ++i )
 		{
@@ -809,14 +888,18 @@ void Map::ForEachReachableTile( const Unit* unit, ForEachReachableTileCallback c
 	assertion( unit, "Cannot find reachable tiles for null Unit!" );
 	assertion( callback.IsValid(), "Cannot call invalid callback on reachable tiles!" );
 
-	// Find all reachable tiles for the Unit.
-	TileSet reachableTiles;
-	FindReachableTiles( unit, reachableTiles );
+	// Find all reachable tiles for the Unit (reusing the scratch list so this doesn't allocate every call).
+	// Each tile is only closed once, so the list never contains duplicates.
+	// The callback must not start another reachable tile search on this Map while the list is being visited.
+	FindReachableTilesInto( unit, mReachableTilesScratch );
 
-	for( auto it = reachableTiles.begin(); it != reachableTiles.end(); ++it )
+	// Visit the tiles in the same order as a TileSet would.
+	std::sort( mReachableTilesScratch.begin(), mReachableTilesScratch.end() );
+
+	for( size_t i = 0; i < mReachableTilesScratch.size(); ++i )
 	{
 		// Invoke the callback on all reachable tiles.
-		callback.Invoke( *it, unit );
+		callback.Invoke( mReachableTilesScratch[ i ], unit );
 	}
 }
 
@@ -987,11 +1070,10 @@ void Map::FindUnitsInRange( const Vec2s& tilePos, const IntRange& range, Units&
 	// Clear the result.
 	result.clear();
 
-	// Find all tiles in range of the specified position.
-	Tiles tilesInRange;
-	FindTilesInRange( tilePos, range, tilesInRange );
+	// Find all tiles in range of the specified position (reusing the scratch list so this doesn't allocate every call).
+	FindTilesInRange( tilePos, range, mTilesInRangeScratch );
 
-	for( auto it = tilesInRange.begin(); it != tilesInRange.end(); ++it )
+	for( auto it = mTilesInRangeScratch.begin(); it != mTilesInRangeScratch.end(); ++it )
 	{
 		// Get the Unit at each Tile in range (if any).
 		Iterator tile = *it;
@@ -1006,6 +1088,191 @@ void Map::FindUnitsInRange( const Vec2s& tilePos, const IntRange& range, Units&
 }
 
 
+const DistanceField& Map::GetDistanceField( const Faction* faction, DistanceGoal goal, const MovementType* movementType )
+{
+	// Look up the cached field for this goal set.
+	DistanceFieldKey key;
+	key.Owner = faction;
+	key.Goal = goal;
+	key.Movement = movementType;
+
+	DistanceField*& field = mDistanceFields[ key ];
+
+	if( !field )
+	{
+		// If the field hasn't been requested before, create it.
+		field = new DistanceField();
+	}
+
+	if( field->IsDirty() || field->GetWidth() != GetWidth() || field->GetHeight() != GetHeight() )
+	{
+		// If the field is out of date, rebuild it from scratch.
+		std::vector< Vec2s > goals;
+		FindDistanceGoals( faction, goal, goals );
+		field->Build( this, movementType, goals );
+	}
+
+	return *field;
+}
+
+
+int Map::GetInfluence( const Faction* faction, const Vec2s& tilePos )
+{
+	// Distances to units are measured in tiles, regardless of terrain.
+	const DistanceField& enemyField = GetDistanceField( faction, DISTANCE_GOAL_ENEMY_UNITS );
+	const DistanceField& friendlyField = GetDistanceField( faction, DISTANCE_GOAL_FRIENDLY_UNITS );
+
+	// Treat Units that can't reach the Tile as being as far away as possible.
+	int maxDistance = ( GetWidth() + GetHeight() );
+	int enemyDistance = enemyField.GetDistance( tilePos );
+	int friendlyDistance = friendlyField.GetDistance( tilePos );
+
+	if( enemyDistance == DistanceField::UNREACHABLE )
+	{
+		enemyDistance = maxDistance;
+	}
+
+	if( friendlyDistance == DistanceField::UNREACHABLE )
+	{
+		friendlyDistance = maxDistance;
+	}
+
+	// Positive values are closer to friendly Units, negative values are closer to enemy Units.
+	return ( enemyDistance - friendlyDistance );
+}
+
+
+bool Map::IsFrontline( const Faction* faction, const Vec2s& tilePos )
+{
+	bool result = false;
+
+	if( GetDistanceField( faction, DISTANCE_GOAL_ENEMY_UNITS ).IsReachable( tilePos ) &&
+		GetDistanceField( faction, DISTANCE_GOAL_FRIENDLY_UNITS ).IsReachable( tilePos ) )
+	{
+		// The frontline is made up of the tiles that are (about) as close to enemy Units as to friendly Units.
+		int influence = GetInfluence( faction, tilePos );
+		result = ( influence >= -1 && influence <= 1 );
+	}
+
+	return result;
+}
+
+
+void Map::DestroyAllDistanceFields()
+{
+	for( auto it = mDistanceFields.begin(); it != mDistanceFields.end(); ++it )
+	{
+		delete it->second;
+	}
+
+	mDistanceFields.clear();
+}
+
+
+bool Map::DistanceFieldKey::operator<( const DistanceFieldKey& other ) const
+{
+	bool result;
+
+	if( Owner != other.Owner )
+	{
+		result = ( Owner < other.Owner );
+	}
+	else if( Goal != other.Goal )
+	{
+		result = ( Goal < other.Goal );
+	}
+	else
+	{
+		result = ( Movement < other.Movement );
+	}
+
+	return result;
+}
+
+
+bool Map::IsDistanceGoal( const Faction* faction, DistanceGoal goal, const ConstIterator& tile ) const
+{
+	bool result = false;
+
+	if( goal == DISTANCE_GOAL_ENEMY_HEADQUARTERS )
+	{
+		for( auto it = mFactions.begin(); it != mFactions.end() && !result; ++it )
+		{
+			// Check whether the Tile is the (uncaptured) headquarters of an enemy Faction.
+			const Faction* other = *it;
+
+			if( AreEnemies( faction, other ) && other->HasHeadquarters() && tile->GetOwner() != faction )
+			{
+				result = ( other->GetHeadquarters().GetPosition() == tile.GetPosition() );
+			}
+		}
+	}
+	else if( goal == DISTANCE_GOAL_CAPTURABLE_TILES )
+	{
+		// Any capturable Tile that the Faction doesn't already own is a goal.
+		result = ( tile->IsCapturable() && tile->GetOwner() != faction );
+	}
+	else
+	{
+		// Otherwise, check the Unit in the Tile.
+		const Unit* unit = tile->GetUnit();
+
+		if( unit && unit->IsAlive() )
+		{
+			bool isFriendly = AreFriends( faction, unit->GetOwner() );
+			result = ( goal == DISTANCE_GOAL_FRIENDLY_UNITS ? isFriendly : !isFriendly );
+		}
+	}
+
+	return result;
+}
+
+
+void Map::FindDistanceGoals( const Faction* faction, DistanceGoal goal, std::vector< Vec2s >& result ) const
+{
+	result.clear();
+
+	if( goal == DISTANCE_GOAL_ENEMY_UNITS || goal == DISTANCE_GOAL_FRIENDLY_UNITS )
+	{
+		for( auto it = mUnitsByID.begin(); it != mUnitsByID.end(); ++it )
+		{
+			// Only look at the Tiles that contain Units.
+			const Unit* unit = it->second;
+			ConstIterator tile = unit->GetTile();
+
+			if( tile.IsValid() && IsDistanceGoal( faction, goal, tile ) )
+			{
+				result.push_back( tile.GetPosition() );
+			}
+		}
+	}
+	else
+	{
+		ForEachTile( [ this, faction, goal, &result ]( const ConstIterator& tile )
+		{
+			if( IsDistanceGoal( faction, goal, tile ) )
+			{
+				result.push_back( tile.GetPosition() );
+			}
+		});
+	}
+}
+
+
+void Map::InvalidateDistanceFields( bool unitGoalsOnly )
+{
+	for( auto it = mDistanceFields.begin(); it != mDistanceFields.end(); ++it )
+	{
+		const DistanceFieldKey& key = it->first;
+
+		if( !unitGoalsOnly || key.Goal == DISTANCE_GOAL_ENEMY_UNITS || key.Goal == DISTANCE_GOAL_FRIENDLY_UNITS )
+		{
+			it->second->Invalidate();
+		}
+	}
+}
+
+
 Unit* Map::GetUnitByID( int unitID ) const
 {
 	Unit* result = nullptr;
@@ -1061,15 +1328,22 @@ void Map::DestroyUnit( Unit* unit )
 		tile->ClearUnit();
 	}
 
+	// Let any DistanceFields that track Units know that the Unit disappeared.
+	UnitTileChanged( unit );
+
 	// Destroy the Unit.
 	unit->Destroy();
-	delete unit;
+	mUnitPool.Destroy( unit );
 }
 
 
 void Map::DestroyAllUnits()
 {
-	// TODO
+	while( !mUnitsByID.empty() )
+	{
+		// Destroy each Unit (which removes it from the list).
+		DestroyUnit( mUnitsByID.begin()->second );
+	}
 }
 
 
@@ -1079,6 +1353,24 @@ Scenario* Map::GetScenario() const
 }
 
 
+void Map::SetRandomSeed( unsigned long seed )
+{
+	mRandom.SetRandomSeed( seed );
+}
+
+
+unsigned long Map::GetRandomSeed() const
+{
+	return mRandom.GetSeed();
+}
+
+
+RNGStream& Map::GetRandom()
+{
+	return mRandom;
+}
+
+
 int Map::ReserveSearchIndex()
 {
 	return mNextSearchIndex++;
@@ -1100,11 +1392,49 @@ void Map::TileChanged( const Iterator& tile )
 		}
 	}
 
+	// Movement costs may have changed, so all DistanceFields need to be rebuilt.
+	InvalidateDistanceFields( false );
+
 	// Fire the change callback.
 	OnTileChanged.Invoke( tile );
 }
 
 
+void Map::TileOwnerChanged( const Iterator& tile )
+{
+	for( auto it = mDistanceFields.begin(); it != mDistanceFields.end(); ++it )
+	{
+		const DistanceFieldKey& key = it->first;
+		DistanceField* field = it->second;
+
+		if( !field->IsDirty() && ( key.Goal == DISTANCE_GOAL_ENEMY_HEADQUARTERS || key.Goal == DISTANCE_GOAL_CAPTURABLE_TILES ) )
+		{
+			bool isGoal = IsDistanceGoal( key.Owner, key.Goal, tile );
+			bool wasGoal = ( field->GetDistance( tile.GetPosition() ) == 0 );
+
+			if( isGoal && !wasGoal )
+			{
+				// New goals can be merged into the existing field.
+				field->AddGoal( tile.GetPosition() );
+			}
+			else if( wasGoal && !isGoal )
+			{
+				// Removing a goal can make distances longer anywhere, so rebuild the field on the next query.
+				field->Invalidate();
+			}
+		}
+	}
+}
+
+
+void Map::UnitTileChanged( Unit* unit )
+{
+	// Units only ever move a few tiles at a time, but a Unit leaving a Tile can make distances longer,
+	// so rebuild the fields that track Units on the next query.
+	InvalidateDistanceFields( true );
+}
+
+
 void Map::UnitMoved( Unit* unit, const Path& path )
 {
 	// TODO
@@ -1127,5 +1457,7 @@ void Map::UnregisterAllAbilities()
 	}
 
 	mAbilitiesByType.clear();
+	mAbilities.clear();
+	mUnitAbilities.clear();
 }
 
@@ -2,6 +2,9 @@
 
 namespace mage
 {
+	class DistanceField;
+
+
 	class Tile
 	{
 	public:
@@ -61,6 +64,10 @@ namespace mage
 
 	/**
 	 * Holds information about each tile on the map and allows tile data to be manipulated.
+	 *
+	 * All game state (including search scratch data and the random number generator) belongs to the Map,
+	 * and the Scenario is only ever read, so separate Maps can be simulated on separate threads as long as
+	 * each Map is only used by one thread at a time.
 	 */
 	class Map : public Grid< Tile, MAP_SIZE_POWER_OF_TWO >
 	{
@@ -76,6 +83,19 @@ namespace mage
 		typedef std::vector< Iterator > Tiles;
 		typedef std::set< Iterator > TileSet;
 		typedef HashMap< Ability* > AbilitiesByType;
+		typedef std::vector< Ability* > Abilities;
+		typedef std::vector< UnitAbility* > UnitAbilities;
+
+		/**
+		 * The kinds of goal tiles that a Map can build a DistanceField toward (from the point of view of a Faction).
+		 */
+		enum DistanceGoal
+		{
+			DISTANCE_GOAL_ENEMY_HEADQUARTERS,
+			DISTANCE_GOAL_CAPTURABLE_TILES,
+			DISTANCE_GOAL_ENEMY_UNITS,
+			DISTANCE_GOAL_FRIENDLY_UNITS
+		};
 
 		typedef Delegate< void, const Map::Iterator& > OnTileChangedCallback;
 
@@ -92,6 +112,7 @@ namespace mage
 
 		void Init( Scenario* scenario );
 		void Destroy();
+		bool IsInitialized() const;
 
 		void SaveToJSON( rapidjson::Document& document, rapidjson::Value& object );
 
@@ -124,7 +145,9 @@ namespace mage
 		void ForEachUnit( ForEachConstUnitCallback callback ) const;
 
 		Ability* GetAbilityByType( const HashString& name ) const;
-		void DetermineAvailableActions( const Unit* unit, const Path& movementPath, Actions& result );
+		size_t GetAbilityCount() const;
+		Ability* GetAbilityByIndex( size_t index ) const;
+		void DetermineAvailableActions( const Unit* unit, const Path& movementPath, ActionArena& arena, Actions& result );
 		void PerformAction( Ability::Action* action );
 
 		void FindReachableTiles( const Unit* unit, TileSet& result );
@@ -133,17 +156,49 @@ namespace mage
 		void FindTilesInRange( const Vec2s& tilePos, const IntRange& range, Tiles& result );
 		void FindUnitsInRange( const Vec2s& tilePos, const IntRange& range, Units& result );
 
+		const DistanceField& GetDistanceField( const Faction* faction, DistanceGoal goal, const MovementType* movementType = nullptr );
+		int GetInfluence( const Faction* faction, const Vec2s& tilePos );
+		bool IsFrontline( const Faction* faction, const Vec2s& tilePos );
+		void DestroyAllDistanceFields();
+
 		Scenario* GetScenario() const;
 
+		void SetRandomSeed( unsigned long seed );
+		unsigned long GetRandomSeed() const;
+		RNGStream& GetRandom();
+
 		int ReserveSearchIndex();
 
 	private:
 		typedef FixedSizeMinHeap< MAX_TILES, int, Iterator > OpenList;
 
+		/**
+		 * Identifies a cached DistanceField.
+		 */
+		struct DistanceFieldKey
+		{
+			const Faction* Owner;
+			DistanceGoal Goal;
+			const MovementType* Movement;
+
+			bool operator<( const DistanceFieldKey& other ) const;
+		};
+
+		typedef std::map< DistanceFieldKey, DistanceField* > DistanceFields;
+
+		bool IsDistanceGoal( const Faction* faction, DistanceGoal goal, const ConstIterator& tile ) const;
+		void FindDistanceGoals( const Faction* faction, DistanceGoal goal, std::vector< Vec2s >& result ) const;
+		void InvalidateDistanceFields( bool unitGoalsOnly );
+
 		void TileChanged( const Iterator& tile );
+		void TileOwnerChanged( const Iterator& tile );
+		void UnitTileChanged( Unit* unit );
 		void UnitMoved( Unit* unit, const Path& path );
 		void UnitDied( Unit* unit );
 
+		template< class TileContainer >
+		void FindReachableTilesInto( const Unit* unit, TileContainer& result );
+
 		template< class AbilitySubclass >
 		void RegisterAbility();
 		void UnregisterAllAbilities();
@@ -152,10 +207,17 @@ namespace mage
 		int mNextSearchIndex;
 		int mNextUnitID;
 		Scenario* mScenario;
+		ObjectPool< Unit > mUnitPool;
 		UnitsByID mUnitsByID;
 		AbilitiesByType mAbilitiesByType;
+		Abilities mAbilities;
+		UnitAbilities mUnitAbilities;
 		Factions mFactions;
 		OpenList mOpenList;
+		Tiles mReachableTilesScratch;
+		Tiles mTilesInRangeScratch;
+		DistanceFields mDistanceFields;
+		RNGStream mRandom;
 
 	public:
 		Event< const Iterator& > OnTileChanged;
@@ -178,5 +240,17 @@ namespace mage
 		// Add it to the list of abilities.
 		assertion( mAbilitiesByType.find( ability->GetType() ) == mAbilitiesByType.end(), "Could not register Ability because an Ability of the type \"%s\" already exists!", ability->GetType().GetCString() );
 		mAbilitiesByType[ ability->GetType() ] = ability;
+
+		// Give the Ability a dense index so Actions can be dispatched to it without a lookup.
+		ability->mIndex = mAbilities.size();
+		mAbilities.push_back( ability );
+
+		// Sort UnitAbilities into their own list once, so they don't need to be cast on every query.
+		UnitAbility* unitAbility = dynamic_cast< UnitAbility* >( ability );
+
+		if( unitAbility )
+		{
+			mUnitAbilities.push_back( unitAbility );
+		}
 	}
 }
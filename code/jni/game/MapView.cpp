@@ -7,6 +7,9 @@ const float MapView::INVERSE_TILE_WORLD_SCALE = ( 1.0f / TILE_WORLD_SCALE );
 
 const float MapView::MAP_BORDER_SCALE = ( TILE_WORLD_SCALE * 5.0f );
 
+// Sprites can extend past the edges of their Tile, so also process a Tile beyond each edge of the screen.
+const short MapView::VISIBLE_TILE_MARGIN = 1;
+
 
 MapView::MapView() :
 	mMap( nullptr ),
@@ -14,7 +17,9 @@ MapView::MapView() :
 	mCamera( gWindowWidth, gWindowHeight ),
 	mSelectedUnitSprite( nullptr ),
 	mTargetedUnitSprite( nullptr ),
-	mCurrentMapAnimation( nullptr )
+	mCurrentMapAnimation( nullptr ),
+	mFrontlineFaction( nullptr ),
+	mTerrainChunkColumns( 0 )
 { }
 
 
@@ -70,13 +75,25 @@ void MapView::Init( Map* map )
 
 void MapView::Destroy()
 {
-	assertion( !IsInitialized(), "Cannot destroy MapView that is not initialized!" );
+	assertion( IsInitialized(), "Cannot destroy MapView that is not initialized!" );
 
 	// Remove the callbacks.
 	mMap->OnResize.RemoveCallback( this, &MapView::MapResized );
 	mMap->OnUnitCreated.RemoveCallback( this, &MapView::UnitCreated );
 	mMap->OnTileChanged.RemoveCallback( this, &MapView::TileChanged );
 
+	// Destroy all UnitSprites, so none are left listening to Units that outlive the MapView.
+	mSelectedUnitSprite = nullptr;
+
+	while( !mUnitSprites.empty() )
+	{
+		DestroyUnitSprite( mUnitSprites.back() );
+	}
+
+	// Release the cached terrain.
+	mTerrainChunks.clear();
+	mTerrainChunkColumns = 0;
+
 	// Reset the Map reference.
 	mMap = nullptr;
 }
@@ -84,7 +101,22 @@ void MapView::Destroy()
 
 void MapView::Update( float elapsedTime )
 {
-	mTileSprites.ForEachTile( [ this, elapsedTime ]( const TileSpritesGrid::Iterator& tileSprite )
+	if( mFrontlineFaction )
+	{
+		// Keep the frontline overlay in sync with the Map.
+		UpdateFrontline();
+	}
+
+	for( auto it = mUnitSprites.begin(); it != mUnitSprites.end(); ++it )
+	{
+		// Start each update from where the UnitSprites were drawn, so they can be interpolated.
+		( *it )->SavePreviousPosition();
+	}
+
+	// Only Sprites the Camera can see need to animate.
+	RectS visibleArea = GetVisibleTileArea();
+
+	mTileSprites.ForEachTileInArea( visibleArea, [ this, elapsedTime ]( const TileSpritesGrid::Iterator& tileSprite )
 	{
 		// Update the TileSprite that represents this Tile.
 		tileSprite->Update( elapsedTime );
@@ -93,7 +125,11 @@ void MapView::Update( float elapsedTime )
 	for( auto it = mUnitSprites.begin(); it != mUnitSprites.end(); ++it )
 	{
 		UnitSprite* unitSprite = *it;
-		unitSprite->Update( elapsedTime );
+
+		if( IsUnitSpriteInArea( unitSprite, visibleArea ) )
+		{
+			unitSprite->Update( elapsedTime );
+		}
 	}
 
 	if( mCurrentMapAnimation )
@@ -140,18 +176,47 @@ void MapView::Update( float elapsedTime )
 
 void MapView::Draw()
 {
-	mTileSprites.ForEachTile( [ this ]( const TileSpritesGrid::Iterator& tileSprite )
+	// Determine which Tiles the Camera can see.
+	RectS visibleArea = GetVisibleTileArea();
+
+	// Queue everything so Sprites that share a sheet are drawn together.
+	BeginRenderQueue();
+
+	// Terrain and Units never overlap within their own layers, so they can be grouped by texture.
+	SetRenderLayer( RENDER_LAYER_TERRAIN );
+
+	if( visibleArea.Width() > 0 && visibleArea.Height() > 0 )
 	{
-		// Draw the TileSprite that represents this Tile.
-		tileSprite->Draw();
-	});
+		// Draw the cached terrain for every chunk that overlaps the visible area.
+		short firstColumn = ( visibleArea.Left / TerrainChunk::SIZE );
+		short lastColumn = ( ( visibleArea.Right - 1 ) / TerrainChunk::SIZE );
+		short firstRow = ( visibleArea.Top / TerrainChunk::SIZE );
+		short lastRow = ( ( visibleArea.Bottom - 1 ) / TerrainChunk::SIZE );
+
+		for( short row = firstRow; row <= lastRow; ++row )
+		{
+			for( short column = firstColumn; column <= lastColumn; ++column )
+			{
+				mTerrainChunks[ row * mTerrainChunkColumns + column ].Draw( mCamera );
+			}
+		}
+	}
+
+	if( !mReachableTiles.empty() || !mAttackableTilePositions.empty() )
+	{
+		// Highlight where the selected Unit can move and attack on top of the terrain.
+		SetRenderLayer( RENDER_LAYER_TILE_HIGHLIGHTS );
+		DrawTileHighlights( visibleArea );
+	}
+
+	SetRenderLayer( RENDER_LAYER_UNITS );
 
 	for( auto it = mUnitSprites.begin(); it != mUnitSprites.end(); ++it )
 	{
-		// Draw all non-selected UnitSprites.
+		// Draw all non-selected UnitSprites the Camera can see.
 		UnitSprite* unitSprite = *it;
 
-		if( unitSprite != mSelectedUnitSprite )
+		if( unitSprite != mSelectedUnitSprite && IsUnitSpriteInArea( unitSprite, visibleArea ) )
 		{
 			unitSprite->Draw( mCamera );
 		}
@@ -160,20 +225,72 @@ void MapView::Draw()
 	if( mArrowSprite.IsInitialized() )
 	{
 		// If there is a selected Unit, draw the arrow path.
+		// Arrow segments overlap each other, so keep them in order.
+		SetRenderLayer( RENDER_LAYER_ARROW, true );
 		mArrowSprite.Draw( mCamera );
 	}
 
 	if( mSelectedUnitSprite )
 	{
 		// Draw the selected Unit.
+		SetRenderLayer( RENDER_LAYER_SELECTED_UNIT );
 		mSelectedUnitSprite->Draw( mCamera );
 	}
 
 	if( mTargetSprite.IsInitialized() )
 	{
 		// Draw the target over the targeted UnitSprite.
+		SetRenderLayer( RENDER_LAYER_TARGET, true );
 		mTargetSprite.Draw( mCamera );
 	}
+
+	// Sort and submit everything that was drawn.
+	EndRenderQueue();
+}
+
+
+float MapView::GetIdleTime() const
+{
+	if( IsPlayingMapAnimation() || !mScheduledMapAnimations.empty() )
+	{
+		// Keep running frames while MapAnimations are playing.
+		return 0.0f;
+	}
+
+	// Find the soonest any visible Sprite changes frame (negative times mean never).
+	float result = -1.0f;
+
+	auto waitForFrame = [ &result ]( float timeUntilNextFrame )
+	{
+		if( timeUntilNextFrame >= 0.0f && ( result < 0.0f || timeUntilNextFrame < result ) )
+		{
+			result = timeUntilNextFrame;
+		}
+	};
+
+	RectS visibleArea = GetVisibleTileArea();
+
+	mTileSprites.ForEachTileInArea( visibleArea, [ &waitForFrame ]( const TileSpritesGrid::ConstIterator& tileSprite )
+	{
+		waitForFrame( tileSprite->GetTimeUntilNextFrame() );
+	});
+
+	for( auto it = mUnitSprites.begin(); it != mUnitSprites.end(); ++it )
+	{
+		UnitSprite* unitSprite = *it;
+
+		if( IsUnitSpriteInArea( unitSprite, visibleArea ) )
+		{
+			waitForFrame( unitSprite->GetSprite()->GetTimeUntilNextFrame() );
+		}
+	}
+
+	if( mTargetSprite.IsInitialized() )
+	{
+		waitForFrame( mTargetSprite.GetTimeUntilNextFrame() );
+	}
+
+	return result;
 }
 
 
@@ -222,6 +339,27 @@ void MapView::CenterCamera()
 }
 
 
+RectS MapView::GetVisibleTileArea() const
+{
+	// Find the Tiles under the corners of the Camera.
+	const Vec2f& cameraPos = mCamera.GetPosition();
+	int left = (int) std::floor( cameraPos.x * INVERSE_TILE_WORLD_SCALE ) - VISIBLE_TILE_MARGIN;
+	int top = (int) std::floor( cameraPos.y * INVERSE_TILE_WORLD_SCALE ) - VISIBLE_TILE_MARGIN;
+	int right = (int) std::ceil( ( cameraPos.x + mCamera.GetViewWidth() ) * INVERSE_TILE_WORLD_SCALE ) + VISIBLE_TILE_MARGIN;
+	int bottom = (int) std::ceil( ( cameraPos.y + mCamera.GetViewHeight() ) * INVERSE_TILE_WORLD_SCALE ) + VISIBLE_TILE_MARGIN;
+
+	// Keep the area on the Map (the area may be empty if the Camera is looking at the border).
+	short width = mTileSprites.GetWidth();
+	short height = mTileSprites.GetHeight();
+	left = Mathi::Clamp( left, 0, width );
+	top = Mathi::Clamp( top, 0, height );
+	right = Mathi::Clamp( right, left, width );
+	bottom = Mathi::Clamp( bottom, top, height );
+
+	return RectS( left, top, right, bottom );
+}
+
+
 void MapView::SetDefaultFont( BitmapFont* font )
 {
 	mDefaultFont = font;
@@ -248,6 +386,21 @@ const MapView::TileSpritesGrid& MapView::GetTileSprites() const
 }
 
 
+void MapView::InvalidateTerrain( const Vec2s& tilePos )
+{
+	if( mTerrainChunkColumns > 0 && tilePos.x >= 0 && tilePos.y >= 0 )
+	{
+		// Mark the chunk containing the Tile as dirty (if the chunk exists yet).
+		size_t chunkIndex = ( ( tilePos.y / TerrainChunk::SIZE ) * mTerrainChunkColumns + ( tilePos.x / TerrainChunk::SIZE ) );
+
+		if( tilePos.x < mTerrainChunkColumns * TerrainChunk::SIZE && chunkIndex < mTerrainChunks.size() )
+		{
+			mTerrainChunks[ chunkIndex ].Invalidate();
+		}
+	}
+}
+
+
 TileSprite* MapView::GetTileSpriteAtScreenCoords( float screenX, float screenY )
 {
 	return GetTileSpriteAtScreenCoords( Vec2f( screenX, screenY ) );
@@ -348,8 +501,8 @@ UnitSprite* MapView::CreateUnitSprite( Unit* unit )
 {
 	DebugPrintf( "Creating UnitSprite at (%d,%d)!", unit->GetTileX(), unit->GetTileY() );
 
-	// Create and initialize a new UnitSprite.
-	UnitSprite* unitSprite = new UnitSprite( this, unit );
+	// Create and initialize a new UnitSprite (recycling the memory of destroyed UnitSprites).
+	UnitSprite* unitSprite = mUnitSpritePool.Create( this, unit );
 	unitSprite->Init();
 
 	// Add the UnitSprite to the list of UnitSprites.
@@ -384,7 +537,7 @@ void MapView::DestroyUnitSprite( UnitSprite* unitSprite )
 
 	// Destroy the UnitSprite.
 	unitSprite->Destroy();
-	delete unitSprite;
+	mUnitSpritePool.Destroy( unitSprite );
 }
 
 
@@ -539,6 +692,33 @@ bool MapView::HasTargetedUnitSprite() const
 }
 
 
+void MapView::SetFrontlineFaction( const Faction* faction )
+{
+	mFrontlineFaction = faction;
+
+	if( !mFrontlineFaction )
+	{
+		mTileSprites.ForEachTile( []( const TileSpritesGrid::Iterator& tileSprite )
+		{
+			// Hide the overlay.
+			tileSprite->SetFrontline( false );
+		});
+	}
+}
+
+
+void MapView::ClearFrontlineFaction()
+{
+	SetFrontlineFaction( nullptr );
+}
+
+
+const Faction* MapView::GetFrontlineFaction() const
+{
+	return mFrontlineFaction;
+}
+
+
 const ArrowSprite& MapView::GetArrowSprite() const
 {
 	return mArrowSprite;
@@ -566,7 +746,7 @@ void MapView::DetermineAvailableActionsForSelectedUnit()
 		const Path& path = mArrowSprite.GetPath();
 
 		// Determine the available actions for the selected Unit and store them for later use.
-		mMap->DetermineAvailableActions( unit, path, mSelectedUnitActions );
+		mMap->DetermineAvailableActions( unit, path, mSelectedUnitActionArena, mSelectedUnitActions );
 	}
 	else
 	{
@@ -581,6 +761,12 @@ const Actions& MapView::GetAvailableActionsForSelectedUnit() const
 }
 
 
+const CombatForecast& MapView::GetCombatForecastForSelectedUnit() const
+{
+	return mCombatForecast;
+}
+
+
 MapAnimation* MapView::ScheduleAnimationForAction( Ability::Action* action )
 {
 	DebugPrintf( "Scheduling animation..." );
@@ -601,7 +787,7 @@ MapAnimation* MapView::ScheduleAnimationForAction( Ability::Action* action )
 
 		// Schedule a new move Action following the movement path.
 		// TODO: Allow for traps.
-		result = ScheduleMapAnimation< UnitMoveMapAnimation >( unitSprite, unitAction->MovementPath );
+		result = ScheduleMapAnimation< UnitMoveMapAnimation >( unitSprite, unitAction->GetMovementPath() );
 	}
 
 	return result;
@@ -692,11 +878,47 @@ void MapView::MapResized( const Vec2s& oldSize, const Vec2s& newSize )
 	// Resize the TileSprites grid.
 	mTileSprites.Resize( newSize );
 
+	// Split the new Map into chunks of terrain.
+	CreateTerrainChunks( newSize );
+
 	// Refresh the Camera bounds.
 	mCamera.SetWorldBounds( GetCameraBounds() );
 }
 
 
+void MapView::CreateTerrainChunks( const Vec2s& mapSize )
+{
+	mTerrainChunkColumns = ( ( mapSize.x + TerrainChunk::SIZE - 1 ) / TerrainChunk::SIZE );
+	short rows = ( ( mapSize.y + TerrainChunk::SIZE - 1 ) / TerrainChunk::SIZE );
+
+	mTerrainChunks.clear();
+	mTerrainChunks.resize( mTerrainChunkColumns * rows );
+
+	for( short y = 0; y < rows; ++y )
+	{
+		for( short x = 0; x < mTerrainChunkColumns; ++x )
+		{
+			// Give each chunk its area of the Map (chunks along the right and bottom edges may be smaller).
+			RectS area( x * TerrainChunk::SIZE, y * TerrainChunk::SIZE,
+			            std::min< short >( ( x + 1 ) * TerrainChunk::SIZE, mapSize.x ),
+			            std::min< short >( ( y + 1 ) * TerrainChunk::SIZE, mapSize.y ) );
+			mTerrainChunks[ y * mTerrainChunkColumns + x ].Init( this, area );
+		}
+	}
+}
+
+
+bool MapView::IsUnitSpriteInArea( const UnitSprite* unitSprite, const RectS& area ) const
+{
+	// Use the position of the Sprite rather than the Unit, since Units can be animating between Tiles.
+	Vec2f worldPos = unitSprite->GetPosition();
+	short tileX = (short) std::floor( worldPos.x * INVERSE_TILE_WORLD_SCALE );
+	short tileY = (short) std::floor( worldPos.y * INVERSE_TILE_WORLD_SCALE );
+
+	return ( tileX >= area.Left && tileX < area.Right && tileY >= area.Top && tileY < area.Bottom );
+}
+
+
 void MapView::UnitCreated( Unit* unit )
 {
 	if( IsInitialized() )
@@ -757,26 +979,92 @@ void MapView::UnitSpriteSelected( UnitSprite* unitSprite, bool showArrow )
 
 void MapView::SelectAllReachableTilesForUnit( Unit* unit )
 {
-	// Select all reachable tiles for the Unit.
-	mMap->ForEachReachableTile( unit, [this]( const Map::Iterator& tile, const Unit* unit )
+	// Find all reachable tiles for the Unit.
+	mMap->FindReachableTiles( unit, mReachableTiles );
+
+	for( auto it = mReachableTiles.begin(); it != mReachableTiles.end(); ++it )
 	{
 		// Get the TileSprite for this position.
-		MapView::TileSpritesGrid::Iterator tileSpriteIt = mTileSprites.GetTile( tile.GetPosition() );
+		MapView::TileSpritesGrid::Iterator tileSpriteIt = mTileSprites.GetTile( it->GetPosition() );
 
 		if( tileSpriteIt.IsValid() )
 		{
 			// Select the TileSprite.
 			tileSpriteIt->Select();
 		}
-	});
+	}
+
+	// Forecast every attack the Unit could make from the reachable tiles (for attack previews).
+	mCombatForecast.Calculate( unit, mReachableTiles );
+
+	const CombatForecast::Options& options = mCombatForecast.GetOptions();
+
+	for( auto it = options.begin(); it != options.end(); ++it )
+	{
+		// Highlight the tile of every Unit that can be attacked (once per target).
+		Vec2s targetTilePos = mMap->GetUnitByID( it->TargetID )->GetTilePos();
+
+		if( std::find( mAttackableTilePositions.begin(), mAttackableTilePositions.end(), targetTilePos ) == mAttackableTilePositions.end() )
+		{
+			mAttackableTilePositions.push_back( targetTilePos );
+		}
+	}
 }
 
 
 void MapView::DeselectAllTiles()
 {
-	mTileSprites.ForEachTile( [this]( const TileSpritesGrid::Iterator& tile )
+	for( auto it = mReachableTiles.begin(); it != mReachableTiles.end(); ++it )
+	{
+		// Only the reachable tiles were selected, so only they need to be deselected.
+		MapView::TileSpritesGrid::Iterator tileSpriteIt = mTileSprites.GetTile( it->GetPosition() );
+
+		if( tileSpriteIt.IsValid() )
+		{
+			tileSpriteIt->Deselect();
+		}
+	}
+
+	// Forget the reachable tiles and the attack forecast for the previous Unit.
+	// (Clearing the attackable tiles keeps their storage for the next selection.)
+	mReachableTiles.clear();
+	mAttackableTilePositions.clear();
+	mCombatForecast.Clear();
+}
+
+
+void MapView::DrawTileHighlights( const RectS& visibleArea )
+{
+	for( auto it = mReachableTiles.begin(); it != mReachableTiles.end(); ++it )
+	{
+		// Tint each visible reachable tile.
+		Vec2s tilePos = it->GetPosition();
+
+		if( tilePos.x >= visibleArea.Left && tilePos.x < visibleArea.Right && tilePos.y >= visibleArea.Top && tilePos.y < visibleArea.Bottom )
+		{
+			mTileSprites.GetTile( tilePos )->DrawHighlight( TileSprite::SELECTED_COLOR );
+		}
+	}
+
+	for( auto it = mAttackableTilePositions.begin(); it != mAttackableTilePositions.end(); ++it )
+	{
+		// Tint each visible tile with a Unit that can be attacked.
+		Vec2s tilePos = *it;
+
+		if( tilePos.x >= visibleArea.Left && tilePos.x < visibleArea.Right && tilePos.y >= visibleArea.Top && tilePos.y < visibleArea.Bottom )
+		{
+			mTileSprites.GetTile( tilePos )->DrawHighlight( TileSprite::ATTACKABLE_COLOR );
+		}
+	}
+}
+
+
+void MapView::UpdateFrontline()
+{
+	mTileSprites.ForEachTile( [this]( const TileSpritesGrid::Iterator& tileSprite )
 	{
-		// Deselect all tiles.
-		tile->Deselect();
+		// The Map caches the distance fields behind the frontline, so this only costs a lookup per tile
+		// unless Units moved or tiles changed since the last frame.
+		tileSprite->SetFrontline( mMap->IsFrontline( mFrontlineFaction, tileSprite.GetPosition() ) );
 	});
 }
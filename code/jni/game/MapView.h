@@ -9,10 +9,28 @@ namespace mage
 		static const float INVERSE_TILE_WORLD_SCALE;
 
 		static const float MAP_BORDER_SCALE;
+		static const short VISIBLE_TILE_MARGIN;
+
+		/**
+		 * Render queue layers for everything drawn by the MapView, from back to front.
+		 * Each Unit's health is drawn in the layer just above the Unit itself.
+		 */
+		enum RenderLayer
+		{
+			RENDER_LAYER_TERRAIN,
+			RENDER_LAYER_TILE_HIGHLIGHTS,
+			RENDER_LAYER_UNITS,
+			RENDER_LAYER_UNIT_LABELS,
+			RENDER_LAYER_ARROW,
+			RENDER_LAYER_SELECTED_UNIT,
+			RENDER_LAYER_SELECTED_UNIT_LABEL,
+			RENDER_LAYER_TARGET
+		};
 
 		typedef Grid< TileSprite, MAP_SIZE_POWER_OF_TWO > TileSpritesGrid;
 		typedef std::vector< UnitSprite* > UnitSprites;
 		typedef std::deque< MapAnimation* > MapAnimations;
+		typedef std::vector< TerrainChunk > TerrainChunks;
 
 		MapView();
 		~MapView();
@@ -22,6 +40,7 @@ namespace mage
 
 		void Update( float elapsedTime );
 		void Draw();
+		float GetIdleTime() const;
 
 		Map* GetMap() const;
 		RectF GetMapBounds() const;
@@ -30,6 +49,7 @@ namespace mage
 		Camera* GetCamera();
 		const Camera* GetCamera() const;
 		void CenterCamera();
+		RectS GetVisibleTileArea() const;
 
 		void SetDefaultFont( BitmapFont* font );
 		BitmapFont* GetDefaultFont() const;
@@ -48,6 +68,7 @@ namespace mage
 		const TileSprite* GetTileSpriteAtTileCoords( const Vec2s& tilePos ) const;
 		TileSpritesGrid& GetTileSprites();
 		const TileSpritesGrid& GetTileSprites() const;
+		void InvalidateTerrain( const Vec2s& tilePos );
 
 		UnitSprite* GetUnitSpriteForUnit( Unit* unit ) const;
 		UnitSprite* GetUnitSpriteAtScreenCoords( float screenX, float screenY ) const;
@@ -67,11 +88,16 @@ namespace mage
 		UnitSprite* GetTargetedUnitSprite() const;
 		bool HasTargetedUnitSprite() const;
 
+		void SetFrontlineFaction( const Faction* faction );
+		void ClearFrontlineFaction();
+		const Faction* GetFrontlineFaction() const;
+
 		const ArrowSprite& GetArrowSprite() const;
 		Path& GetSelectedUnitPath();
 		const Path& GetSelectedUnitPath() const;
 		void DetermineAvailableActionsForSelectedUnit();
 		const Actions& GetAvailableActionsForSelectedUnit() const;
+		const CombatForecast& GetCombatForecastForSelectedUnit() const;
 
 		template< class MapAnimationSubclass, typename... ParameterTypes >
 		MapAnimationSubclass* ScheduleMapAnimation( ParameterTypes... parameters );
@@ -100,21 +126,34 @@ namespace mage
 		void TileChanged( const Map::Iterator& tile );
 		void UnitSpriteSelected( UnitSprite* unitSprite, bool showArrow );
 
+		void CreateTerrainChunks( const Vec2s& mapSize );
+		bool IsUnitSpriteInArea( const UnitSprite* unitSprite, const RectS& area ) const;
+
 		void SelectAllReachableTilesForUnit( Unit* unit );
 		void DeselectAllTiles();
+		void DrawTileHighlights( const RectS& visibleArea );
+		void UpdateFrontline();
 
 		Map* mMap;
 		UnitSprite* mSelectedUnitSprite;
 		UnitSprite* mTargetedUnitSprite;
 		BitmapFont* mDefaultFont;
 		MapAnimation* mCurrentMapAnimation;
+		const Faction* mFrontlineFaction;
 		Camera mCamera;
+		ActionArena mSelectedUnitActionArena;
 		Actions mSelectedUnitActions;
+		Map::TileSet mReachableTiles;
+		std::vector< Vec2s > mAttackableTilePositions;
+		CombatForecast mCombatForecast;
 		TargetSprite mTargetSprite;
 		ArrowSprite mArrowSprite;
+		ObjectPool< UnitSprite > mUnitSpritePool;
 		UnitSprites mUnitSprites;
 		MapAnimations mScheduledMapAnimations;
 		TileSpritesGrid mTileSprites;
+		TerrainChunks mTerrainChunks;
+		short mTerrainChunkColumns;
 
 		friend class UnitSprite;
 	};
@@ -0,0 +1,231 @@
+#include "androidwars.h"
+
+using namespace mage;
+
+
+const short RenderBenchmark::DEFAULT_MAP_WIDTH;
+const short RenderBenchmark::DEFAULT_MAP_HEIGHT;
+
+
+bool RenderBenchmark::RunHeadless( const char* scenarioFile, const char* fontFile, int frameCount, int viewportWidth, int viewportHeight )
+{
+	// Install the NullRenderer first, so every texture loaded below is created by it instead of the GPU.
+	NullRenderer headlessRenderer;
+	headlessRenderer.Start();
+
+	IRenderer* previousRenderer = SwapRenderer( &headlessRenderer );
+
+	bool success = false;
+
+	{
+		Scenario scenario;
+
+		if( scenario.LoadDataFromFile( scenarioFile ) )
+		{
+			BitmapFont font( fontFile );
+
+			RenderBenchmark benchmark( &scenario, &font );
+			benchmark.SetViewportSize( viewportWidth, viewportHeight );
+			benchmark.Run( frameCount );
+			benchmark.PrintResults();
+
+			success = true;
+		}
+		else
+		{
+			WarnFail( "Could not run headless render benchmark because the Scenario \"%s\" could not be loaded!", scenarioFile );
+		}
+	}
+
+	SwapRenderer( previousRenderer );
+	headlessRenderer.Stop();
+
+	return success;
+}
+
+
+RenderBenchmark::RenderBenchmark( Scenario* scenario, BitmapFont* font ) :
+	mScenario( scenario ),
+	mFont( font ),
+	mMapWidth( DEFAULT_MAP_WIDTH ),
+	mMapHeight( DEFAULT_MAP_HEIGHT ),
+	mViewportWidth( 1 ),
+	mViewportHeight( 1 ),
+	mChecksum( 0 ),
+	mFrameCount( 0 ),
+	mDuration( 0.0 )
+{
+	assertion( mScenario, "Cannot create RenderBenchmark without a Scenario!" );
+	assertion( mFont, "Cannot create RenderBenchmark without a Font!" );
+	memset( &mTotalStats, 0, sizeof( mTotalStats ) );
+}
+
+
+RenderBenchmark::~RenderBenchmark() { }
+
+
+void RenderBenchmark::SetMapSize( short width, short height )
+{
+	assertion( width > 0 && height > 0, "Cannot set RenderBenchmark Map size to %dx%d!", width, height );
+	mMapWidth = width;
+	mMapHeight = height;
+}
+
+
+void RenderBenchmark::SetViewportSize( int width, int height )
+{
+	assertion( width > 0 && height > 0, "Cannot set RenderBenchmark viewport size to %dx%d!", width, height );
+	mViewportWidth = width;
+	mViewportHeight = height;
+}
+
+
+void RenderBenchmark::Run( int frameCount )
+{
+	memset( &mTotalStats, 0, sizeof( mTotalStats ) );
+	mChecksum = 0;
+	mFrameCount = 0;
+	mDuration = 0.0;
+
+	// Build the Map before swapping renderers, since loading Sprites creates textures.
+	// The Map and MapView are large, so keep them off the stack.
+	Map* map = new Map();
+	map->Init( mScenario );
+	GenerateMap( map );
+
+	MapView* mapView = new MapView();
+	mapView->GetCamera()->SetViewport( (float) mViewportWidth, (float) mViewportHeight );
+	mapView->SetDefaultFont( mFont );
+	mapView->Init( map );
+
+	// Draw everything into a NullRenderer instead of the real one.
+	NullRenderer nullRenderer;
+	nullRenderer.SetChecksumEnabled( true );
+	nullRenderer.Start();
+
+	IRenderer* previousRenderer = SwapRenderer( &nullRenderer );
+
+	// Pan the Camera from the top left corner of the Map to the bottom right.
+	RectF mapBounds = mapView->GetMapBounds();
+	Camera* camera = mapView->GetCamera();
+
+	const float elapsedTime = ( 1.0f / 60.0f );
+	double startTime = Clock::QueryTime( Clock::TIME_SEC );
+
+	for( int i = 0; i < frameCount; ++i )
+	{
+		float progress = ( frameCount > 1 ? ( (float) i / ( frameCount - 1 ) ) : 0.0f );
+		camera->LookAt( Vec2f( mapBounds.Left + progress * mapBounds.Width(), mapBounds.Top + progress * mapBounds.Height() ) );
+
+		// Update and draw a frame the same way GameplayState does.
+		mapView->Update( elapsedTime );
+		mapView->Draw();
+
+		// Finish the frame, which latches its stats.
+		FlushRenderer();
+		SwapBuffers();
+
+		AddFrameStats( GetFrameStats() );
+		++mFrameCount;
+	}
+
+	mDuration = ( Clock::QueryTime( Clock::TIME_SEC ) - startTime );
+
+	// Go back to drawing with the real renderer.
+	SwapRenderer( previousRenderer );
+	nullRenderer.Stop();
+
+	// Clean up.
+	mapView->Destroy();
+	delete mapView;
+	map->Destroy();
+	delete map;
+}
+
+
+void RenderBenchmark::PrintResults() const
+{
+	float frames = (float) std::max( mFrameCount, 1 );
+
+	DebugPrintf( "Render benchmark: %dx%d Map, %dx%d viewport, %d frames in %.2f sec (%.3f ms/frame)",
+		mMapWidth, mMapHeight, mViewportWidth, mViewportHeight, mFrameCount, mDuration, GetMillisecondsPerFrame() );
+	DebugPrintf( "Render benchmark: per frame %.1f draw calls, %.1f flushes, %.0f quads, %.0f verticies, %.1f texture switches, %.1f effect changes (checksum %08x)",
+		mTotalStats.DrawCalls / frames, mTotalStats.Flushes / frames, mTotalStats.Quads / frames, mTotalStats.Verticies / frames,
+		mTotalStats.TextureSwitches / frames, mTotalStats.EffectChanges / frames, mChecksum );
+}
+
+
+float RenderBenchmark::GetMillisecondsPerFrame() const
+{
+	return ( mFrameCount > 0 ? (float) ( mDuration * 1000.0 / mFrameCount ) : 0.0f );
+}
+
+
+void RenderBenchmark::GenerateMap( Map* map )
+{
+	// Build a single copy of the test Map to repeat.
+	Map* testMap = new Map();
+	testMap->Init( mScenario );
+	GameplayState::GenerateTestMap( testMap );
+
+	map->Resize( mMapWidth, mMapHeight );
+	map->FillWithDefaultTerrainType();
+
+	// Copy the Factions, so Units can be copied with the same owners.
+	const Map::Factions& testFactions = testMap->GetFactions();
+
+	for( auto it = testFactions.begin(); it != testFactions.end(); ++it )
+	{
+		Faction* faction = map->CreateFaction();
+		faction->SetControllable( ( *it )->IsControllable() );
+		faction->SetColor( ( *it )->GetColor() );
+	}
+
+	const Map::Factions& factions = map->GetFactions();
+	short testMapWidth = testMap->GetWidth();
+	short testMapHeight = testMap->GetHeight();
+
+	for( short blockY = 0; blockY < mMapHeight; blockY += testMapHeight )
+	{
+		for( short blockX = 0; blockX < mMapWidth; blockX += testMapWidth )
+		{
+			// Copy the terrain of the test Map to this block (clipped to the edges of the Map).
+			RectS blockArea( 0, 0, std::min< short >( testMapWidth, mMapWidth - blockX ), std::min< short >( testMapHeight, mMapHeight - blockY ) );
+
+			testMap->ForEachTileInArea( blockArea, [ map, blockX, blockY ]( const Map::Iterator& tile )
+			{
+				Vec2s tilePos = tile.GetPosition();
+				short x = ( blockX + tilePos.x );
+				short y = ( blockY + tilePos.y );
+				map->Fill( *tile, RectS( x, y, x + 1, y + 1 ) );
+			});
+
+			// Copy the Units in this block.
+			testMap->ForEachUnit( [ map, &factions, &testFactions, &blockArea, blockX, blockY ]( Unit* unit )
+			{
+				if( unit->GetTileX() < blockArea.Right && unit->GetTileY() < blockArea.Bottom )
+				{
+					size_t factionIndex = ( std::find( testFactions.begin(), testFactions.end(), unit->GetOwner() ) - testFactions.begin() );
+					map->CreateUnit( unit->GetUnitType(), factions[ factionIndex ], blockX + unit->GetTileX(), blockY + unit->GetTileY(), unit->GetHealth() );
+				}
+			});
+		}
+	}
+
+	testMap->Destroy();
+	delete testMap;
+}
+
+
+void RenderBenchmark::AddFrameStats( const IRenderer::FrameStats& frameStats )
+{
+	mTotalStats.DrawCalls += frameStats.DrawCalls;
+	mTotalStats.Flushes += frameStats.Flushes;
+	mTotalStats.Verticies += frameStats.Verticies;
+	mTotalStats.Quads += frameStats.Quads;
+	mTotalStats.TextureSwitches += frameStats.TextureSwitches;
+	mTotalStats.EffectChanges += frameStats.EffectChanges;
+
+	// Fold each frame's checksum into one value for the whole run.
+	mChecksum = ( ( mChecksum * 31 ) ^ frameStats.Checksum );
+}
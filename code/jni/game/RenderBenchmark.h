@@ -0,0 +1,97 @@
+#pragma once
+
+namespace mage
+{
+	/**
+	 * Draws a large Map through a MapView for a number of frames with a NullRenderer,
+	 * so the CPU cost of rendering can be measured without waiting on the GPU.
+	 *
+	 * The Map is made by repeating the test Map from GameplayState, Units included, and the Camera pans
+	 * across it diagonally so chunk rebuilding and culling are exercised along with drawing.
+	 *
+	 * RunHeadless() needs no GPU and none of the app's UI. Benchmarks runs it as "renderFrames".
+	 */
+	class RenderBenchmark
+	{
+	public:
+		static const short DEFAULT_MAP_WIDTH = 256;
+		static const short DEFAULT_MAP_HEIGHT = 192;
+
+		/**
+		 * Installs a NullRenderer before loading anything, then loads the Scenario and Font through it, so every
+		 * texture gets a stub handle and nothing touches the GPU. Returns false if the files could not be loaded.
+		 * The loaded textures and Sprite animations stay cached with their stub handles, so only call this in a
+		 * process that doesn't render anything for real.
+		 */
+		static bool RunHeadless( const char* scenarioFile, const char* fontFile, int frameCount, int viewportWidth, int viewportHeight );
+
+		RenderBenchmark( Scenario* scenario, BitmapFont* font );
+		~RenderBenchmark();
+
+		void SetMapSize( short width, short height );
+		short GetMapWidth() const;
+		short GetMapHeight() const;
+
+		void SetViewportSize( int width, int height );
+
+		void Run( int frameCount );
+
+		const IRenderer::FrameStats& GetTotalStats() const;
+		uint32 GetChecksum() const;
+		int GetFrameCount() const;
+		double GetDuration() const;
+		float GetMillisecondsPerFrame() const;
+
+	private:
+		void GenerateMap( Map* map );
+		void AddFrameStats( const IRenderer::FrameStats& frameStats );
+		void PrintResults() const;
+
+		Scenario* mScenario;
+		BitmapFont* mFont;
+		short mMapWidth;
+		short mMapHeight;
+		int mViewportWidth;
+		int mViewportHeight;
+		IRenderer::FrameStats mTotalStats;
+		uint32 mChecksum;
+		int mFrameCount;
+		double mDuration;
+	};
+
+
+	inline short RenderBenchmark::GetMapWidth() const
+	{
+		return mMapWidth;
+	}
+
+
+	inline short RenderBenchmark::GetMapHeight() const
+	{
+		return mMapHeight;
+	}
+
+
+	inline const IRenderer::FrameStats& RenderBenchmark::GetTotalStats() const
+	{
+		return mTotalStats;
+	}
+
+
+	inline uint32 RenderBenchmark::GetChecksum() const
+	{
+		return mChecksum;
+	}
+
+
+	inline int RenderBenchmark::GetFrameCount() const
+	{
+		return mFrameCount;
+	}
+
+
+	inline double RenderBenchmark::GetDuration() const
+	{
+		return mDuration;
+	}
+}
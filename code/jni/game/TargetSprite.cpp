@@ -63,6 +63,13 @@ void TargetSprite::Update( float elapsedTime )
 }
 
 
+float TargetSprite::GetTimeUntilNextFrame() const
+{
+	assertion( IsInitialized(), "Cannot get animation timing for TargetSprite that is not initialized!" );
+	return mSprite->GetTimeUntilNextFrame();
+}
+
+
 void TargetSprite::Draw( const Camera& camera )
 {
 	assertion( IsInitialized(), "Cannot draw TargetSprite that is not initialized!" );
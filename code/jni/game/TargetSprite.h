@@ -20,6 +20,7 @@ namespace mage
 
 		void Update( float elapsedTime );
 		void Draw( const Camera& camera );
+		float GetTimeUntilNextFrame() const;
 
 		void SetPosition( const Vec2f& position );
 		Vec2f GetPosition() const;
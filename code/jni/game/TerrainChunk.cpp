@@ -0,0 +1,85 @@
+#include "androidwars.h"
+
+using namespace mage;
+
+
+const short TerrainChunk::SIZE;
+
+
+TerrainChunk::TerrainChunk() :
+	mMapView( nullptr ),
+	mIsDirty( true )
+{ }
+
+
+TerrainChunk::~TerrainChunk() { }
+
+
+void TerrainChunk::Init( MapView* mapView, const RectS& area )
+{
+	mMapView = mapView;
+	assertion( mMapView, "Cannot initialize TerrainChunk without a valid MapView!" );
+
+	mArea = area;
+
+	// Build the geometry the next time the chunk is drawn.
+	Invalidate();
+}
+
+
+void TerrainChunk::Invalidate()
+{
+	mIsDirty = true;
+}
+
+
+void TerrainChunk::Draw( const Camera& camera )
+{
+	if( mIsDirty )
+	{
+		// Recapture the terrain if any TileSprite changed.
+		Rebuild();
+	}
+
+	// Draw the cached terrain relative to the Camera.
+	const Vec2f& cameraPos = camera.GetPosition();
+	DrawQuadList( mQuads, -cameraPos.x, -cameraPos.y );
+
+	for( auto it = mAnimatedTileSprites.begin(); it != mAnimatedTileSprites.end(); ++it )
+	{
+		// Draw animated terrain every frame.
+		TileSprite* tileSprite = *it;
+		tileSprite->Draw();
+	}
+}
+
+
+void TerrainChunk::Rebuild()
+{
+	mAnimatedTileSprites.clear();
+
+	// Capture the quads for all static terrain in World space.
+	PushMatrix();
+	LoadIdentity();
+	BeginQuadCapture( &mQuads );
+
+	MapView::TileSpritesGrid& tileSprites = mMapView->GetTileSprites();
+
+	tileSprites.ForEachTileInArea( mArea, [ this ]( const MapView::TileSpritesGrid::Iterator& tileSprite )
+	{
+		if( tileSprite->IsAnimated() )
+		{
+			// Animated terrain can't be cached, so remember to draw it separately.
+			mAnimatedTileSprites.push_back( &( *tileSprite ) );
+		}
+		else
+		{
+			tileSprite->DrawInWorldSpace();
+		}
+	});
+
+	EndQuadCapture();
+	PopMatrix();
+
+	mIsDirty = false;
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+namespace mage
+{
+	class MapView;
+	class TileSprite;
+
+	/**
+	 * A square block of TileSprites whose terrain is drawn from cached geometry.
+	 *
+	 * The quads for every TileSprite with a static animation are captured once and redrawn as-is every frame,
+	 * until one of the TileSprites in the chunk changes. TileSprites with animated terrain are still drawn
+	 * individually, on top of the cached geometry.
+	 */
+	class TerrainChunk
+	{
+	public:
+		static const short SIZE = 16;
+
+		TerrainChunk();
+		~TerrainChunk();
+
+		void Init( MapView* mapView, const RectS& area );
+
+		void Invalidate();
+		void Draw( const Camera& camera );
+
+		const RectS& GetArea() const;
+		bool IsDirty() const;
+
+	private:
+		void Rebuild();
+
+		MapView* mMapView;
+		RectS mArea;
+		bool mIsDirty;
+		QuadList mQuads;
+		std::vector< TileSprite* > mAnimatedTileSprites;
+	};
+
+
+	inline const RectS& TerrainChunk::GetArea() const
+	{
+		return mArea;
+	}
+
+
+	inline bool TerrainChunk::IsDirty() const
+	{
+		return mIsDirty;
+	}
+}
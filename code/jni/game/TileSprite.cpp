@@ -5,6 +5,8 @@ using namespace mage;
 
 const Color TileSprite::DEFAULT_COLOR = Color( 1.0f, 1.0f, 1.0f, 1.0f );
 const Color TileSprite::SELECTED_COLOR = Color( 0.5f, 0.8f, 1.0f, 1.0f );
+const Color TileSprite::ATTACKABLE_COLOR = Color( 1.0f, 0.5f, 0.4f, 1.0f );
+const Color TileSprite::FRONTLINE_COLOR = Color( 1.0f, 0.6f, 0.6f, 1.0f );
 
 
 HashString TileSprite::ChooseTileVariation( const Map::ConstIterator& tile )
@@ -19,20 +21,43 @@ HashString TileSprite::ChooseTileVariation( const Map::ConstIterator& tile )
 		// Get the TerrainType for the Tile.
 		TerrainType* terrainType = tile->GetTerrainType();
 
-		// Get the variations for the TerrainType.
-		const TerrainType::Variations& variations = terrainType->GetVariations();
-
-		for( auto it = variations.rbegin(); it != variations.rend(); ++it )
+		if( terrainType->IsVariationLookupCompiled() )
 		{
-			// Find the last variation that matches the tile.
-			const Variation* variation = *it;
-			//DebugPrintf( "Testing variation \"%s\"...", variation->GetAnimationName().GetCString() );
+			TerrainType::NeighborTerrainIndices neighborTerrainIndices;
 
-			if( TileMatchesVariation( tile, variation ) )
+			for( size_t i = 0; i < PRIMARY_DIRECTION_COUNT; ++i )
+			{
+				// Get the terrain index of each neighboring tile.
+				Map::ConstIterator adjacent = tile.GetAdjacent( PRIMARY_DIRECTIONS[ i ] );
+				neighborTerrainIndices[ i ] = ( adjacent.IsValid() && adjacent->HasTerrainType() ? adjacent->GetTerrainType()->GetTerrainIndex() : TerrainType::NO_TERRAIN_INDEX );
+			}
+
+			// Look up the Variation from the compiled rules.
+			const Variation* variation = terrainType->ChooseVariation( neighborTerrainIndices );
+
+			if( variation )
 			{
 				// Get the name of the animation to use for the tile.
 				result = variation->GetAnimationName();
-				break;
+			}
+		}
+		else
+		{
+			// Get the variations for the TerrainType.
+			const TerrainType::Variations& variations = terrainType->GetVariations();
+
+			for( auto it = variations.rbegin(); it != variations.rend(); ++it )
+			{
+				// Find the last variation that matches the tile.
+				const Variation* variation = *it;
+				//DebugPrintf( "Testing variation \"%s\"...", variation->GetAnimationName().GetCString() );
+
+				if( TileMatchesVariation( tile, variation ) )
+				{
+					// Get the name of the animation to use for the tile.
+					result = variation->GetAnimationName();
+					break;
+				}
 			}
 		}
 	}
@@ -64,7 +89,7 @@ bool TileSprite::TileMatchesVariation( const Map::ConstIterator& tile, const Var
 
 			// Determine what type to test.
 			Map::ConstIterator adjacent = tile.GetAdjacent( direction );
-			HashString expressionToTest = ( adjacent.IsValid() && adjacent->HasTerrainType() ? adjacent->GetTerrainType()->GetName() : "None" );
+			HashString expressionToTest = ( adjacent.IsValid() && adjacent->HasTerrainType() ? adjacent->GetTerrainType()->GetName() : TerrainType::NO_TERRAIN_EXPRESSION );
 			//DebugPrintf( "Testing whether %s expression matches the tile (%d,%d) with type \"%s\"...", direction.GetName().GetCString(), adjacent.GetX(), adjacent.GetY(), expressionToTest.GetCString() );
 
 			if( !condition->HasExpression( direction, expressionToTest ) )
@@ -90,7 +115,9 @@ bool TileSprite::TileMatchesVariation( const Map::ConstIterator& tile, const Var
 TileSprite::TileSprite() :
 	mMapView( nullptr ),
 	mSprite( nullptr ),
-	mIsSelected( false )
+	mIsSelected( false ),
+	mIsFrontline( false ),
+	mIsAnimated( false )
 { }
 
 
@@ -118,9 +145,9 @@ void TileSprite::Init( MapView* mapView, const Vec2s& tilePos )
 
 void TileSprite::Update( float elapsedTime )
 {
-	if( mSprite )
+	if( mIsAnimated )
 	{
-		// Update the Sprite.
+		// Update the Sprite. Static terrain never changes frames, so it doesn't need updating.
 		mSprite->OnUpdate( elapsedTime );
 	}
 }
@@ -136,6 +163,32 @@ void TileSprite::Draw()
 }
 
 
+void TileSprite::DrawInWorldSpace()
+{
+	if( mSprite )
+	{
+		// Draw the Sprite at its World position (without culling), e.g. to capture it for a TerrainChunk.
+		bool isRelativeToCamera = mSprite->RelativeToCamera;
+		mSprite->RelativeToCamera = false;
+		mSprite->OnDraw( *mMapView->GetCamera() );
+		mSprite->RelativeToCamera = isRelativeToCamera;
+	}
+}
+
+
+void TileSprite::DrawHighlight( const Color& tint )
+{
+	if( mSprite )
+	{
+		// Redraw the Sprite with the tint applied on top of the cached terrain, then restore its color.
+		Color color = mSprite->DrawColor;
+		mSprite->DrawColor = ( color * tint );
+		mSprite->OnDraw( *mMapView->GetCamera() );
+		mSprite->DrawColor = color;
+	}
+}
+
+
 Map::Iterator TileSprite::GetTile() const
 {
 	return mTile;
@@ -167,7 +220,7 @@ void TileSprite::SetSelected( bool selected )
 		//DebugPrintf( "%s TileSprite at (%d,%d)!", ( selected ? "Selecting" : "Deselecting" ), mTile.GetX(), mTile.GetY() );
 		mIsSelected = selected;
 
-		UpdateSprite();
+		// The MapView draws selected tiles as a highlight overlay, so the Sprite and cached terrain stay as they are.
 	}
 }
 
@@ -190,6 +243,39 @@ bool TileSprite::IsSelected() const
 }
 
 
+void TileSprite::SetFrontline( bool isFrontline )
+{
+	if( mIsFrontline != isFrontline )
+	{
+		mIsFrontline = isFrontline;
+
+		if( mSprite )
+		{
+			// Only the color depends on the frontline, so keep the current Sprite.
+			UpdateColor();
+		}
+	}
+}
+
+
+bool TileSprite::IsFrontline() const
+{
+	return mIsFrontline;
+}
+
+
+bool TileSprite::IsAnimated() const
+{
+	return mIsAnimated;
+}
+
+
+float TileSprite::GetTimeUntilNextFrame() const
+{
+	return ( mIsAnimated ? mSprite->GetTimeUntilNextFrame() : -1.0f );
+}
+
+
 void TileSprite::UpdateSprite()
 {
 	DestroySprite();
@@ -211,10 +297,14 @@ void TileSprite::UpdateSprite()
 
 			// Create a new Sprite.
 			mSprite = SpriteManager::CreateSprite( animationSetName, worldPos, animation );
+			mIsAnimated = !mSprite->IsCurrentAnimationStatic();
 
 			// Update color.
 			UpdateColor();
 		}
+
+		// Let the MapView know the terrain for this Tile needs to be redrawn.
+		mMapView->InvalidateTerrain( mTile.GetPosition() );
 	}
 }
 
@@ -226,6 +316,8 @@ void TileSprite::DestroySprite()
 		// If there was a previous Sprite, destroy it.
 		SpriteManager::DestroySprite( mSprite );
 	}
+
+	mIsAnimated = false;
 }
 
 
@@ -249,12 +341,15 @@ void TileSprite::UpdateColor()
 		color = tile->GetOwner()->GetColor();
 	}
 
-	if( mIsSelected )
+	if( mIsFrontline )
 	{
-		// If the Tile is selected, use the selected color.
-		color *= SELECTED_COLOR;
+		// If the Tile is on the frontline, tint it.
+		color *= FRONTLINE_COLOR;
 	}
 
-	// Set the color of the Sprite based on selection state.
+	// Set the color of the Sprite based on ownership and frontline state.
 	mSprite->DrawColor = color;
+
+	// Let the MapView know the terrain for this Tile needs to be redrawn.
+	mMapView->InvalidateTerrain( mTile.GetPosition() );
 }
@@ -12,6 +12,8 @@ namespace mage
 	public:
 		static const Color DEFAULT_COLOR;
 		static const Color SELECTED_COLOR;
+		static const Color ATTACKABLE_COLOR;
+		static const Color FRONTLINE_COLOR;
 
 		static HashString ChooseTileVariation( const Map::ConstIterator& tile );
 
@@ -22,6 +24,8 @@ namespace mage
 
 		void Update( float elapsedTime );
 		void Draw();
+		void DrawInWorldSpace();
+		void DrawHighlight( const Color& tint );
 
 		void UpdateSprite();
 
@@ -35,6 +39,12 @@ namespace mage
 		void Deselect();
 		bool IsSelected() const;
 
+		void SetFrontline( bool isFrontline );
+		bool IsFrontline() const;
+
+		bool IsAnimated() const;
+		float GetTimeUntilNextFrame() const;
+
 	private:
 		void DestroySprite();
 
@@ -45,6 +55,8 @@ namespace mage
 		static bool TileMatchesVariation( const Map::ConstIterator& tile, const Variation* variation );
 
 		bool mIsSelected;
+		bool mIsFrontline;
+		bool mIsAnimated;
 		MapView* mMapView;
 		Sprite* mSprite;
 		Map::Iterator mTile;
@@ -443,6 +443,9 @@ void Unit::SetTile( Map::Iterator tile )
 			mTile->SetUnit( this );
 		}
 
+		// Let the Map know that the Unit moved.
+		mMap->UnitTileChanged( this );
+
 		// Fire the tile changed event.
 		OnTileChanged.Invoke( mTile );
 	}
@@ -515,7 +518,7 @@ void Unit::Attack( Unit* target )
 	int totalDamage = guaranteedDamage;
 
 	// Roll a 10-sided die to see if extra damage should be applied.
-	int extraDamageRoll = RNG::RandomInRange( 1, 10 );
+	int extraDamageRoll = mMap->GetRandom().RandomInRange( 1, 10 );
 	bool success = ( extraDamageChance >= extraDamageRoll );
 	DebugPrintf( "Extra damage roll %s! (Rolled a %d, needed %d or lower to pass.)", ( success ? "SUCCEEDED" : "FAILED" ), extraDamageRoll, extraDamageChance );
 
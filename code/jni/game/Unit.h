@@ -137,5 +137,6 @@ namespace mage
 
 		friend class Map;
 		friend class Faction;
+		friend class ObjectPool< Unit >;
 	};
 }
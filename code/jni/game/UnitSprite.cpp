@@ -57,6 +57,15 @@ void UnitSprite::Destroy()
 	assertion( IsInitialized(), "Cannot destroy UnitSprite that has not been initialized!" );
 	mIsInitialized = false;
 
+	// Stop listening to the Unit, which may outlive this UnitSprite.
+	mUnit->OnOwnerChanged.RemoveCallback( this, &UnitSprite::OnUnitOwnerChanged );
+	mUnit->OnTileChanged.RemoveCallback( this, &UnitSprite::OnUnitTileChanged );
+	mUnit->OnTakeDamage.RemoveCallback( this, &UnitSprite::OnUnitTakeDamage );
+	mUnit->OnHealthChanged.RemoveCallback( this, &UnitSprite::OnUnitHealthChanged );
+	mUnit->OnDestroyed.RemoveCallback( this, &UnitSprite::OnUnitDestroyed );
+	mUnit->OnActivate.RemoveCallback( this, &UnitSprite::OnUnitActivate );
+	mUnit->OnDeactivate.RemoveCallback( this, &UnitSprite::OnUnitDeactivate );
+
 	// Destroy the sprite.
 	SpriteManager::DestroySprite( mSprite );
 }
@@ -79,30 +88,59 @@ void UnitSprite::Draw( const Camera& camera )
 {
 	if( mIsVisible )
 	{
+		// Draw the Sprite between its last two positions, so movement is smooth at any frame rate.
+		Vec2f drawPos = GetInterpolatedPosition( GetFrameInterpolation() );
+		mSprite->Position = drawPos;
+
 		// If the UnitSprite is visible, draw the internal Sprite.
 		mSprite->OnDraw( camera );
 
 		if( mUnit->IsDamaged() )
 		{
-			// Draw health.
+			// Draw health in the layer above the Unit, so all health labels can be batched together.
 			BitmapFont* font = mMapView->GetDefaultFont();
-			Vec2f textPos = ( GetPosition() - camera.GetPosition() );
+			Vec2f textPos = ( drawPos - camera.GetPosition() );
 			float height = ( mSprite->GetClippingRectForCurrentAnimation().Height() * 0.5f );
+			uint8 layer = GetRenderLayer();
+
+			SetRenderLayer( layer + 1 );
 			DrawTextFormat( textPos.x, textPos.y + height - font->GetLineHeight(), font, "%d", mUnit->GetHealth() );
+			SetRenderLayer( layer );
 		}
 	}
 }
 
 
-void UnitSprite::SetPosition( const Vec2f& position )
+void UnitSprite::SetPosition( const Vec2f& position, bool interpolate )
 {
+	mPosition = position;
+
+	if( !interpolate )
+	{
+		// Jump straight to the new position instead of sliding there over the next frame.
+		mPreviousPosition = position;
+	}
+
 	mSprite->Position = position;
 }
 
 
 Vec2f UnitSprite::GetPosition() const
 {
-	return mSprite->Position;
+	return mPosition;
+}
+
+
+Vec2f UnitSprite::GetInterpolatedPosition( float interpolation ) const
+{
+	return ( mPreviousPosition + ( mPosition - mPreviousPosition ) * interpolation );
+}
+
+
+void UnitSprite::SavePreviousPosition()
+{
+	// Remember where the UnitSprite was before this update.
+	mPreviousPosition = mPosition;
 }
 
 
@@ -124,7 +162,7 @@ RectF UnitSprite::GetWorldBounds() const
 	RectF bounds = mSprite->GetClippingRectForCurrentAnimation();
 
 	// Offset the bounds by the current Sprite position.
-	Vec2f position = mSprite->Position;
+	Vec2f position = mPosition;
 
 	bounds.Left   += position.x;
 	bounds.Top    += position.y;
@@ -241,6 +279,6 @@ void UnitSprite::UpdateTilePosition()
 	if( mIsVisible )
 	{
 		// If the UnitSprite is still visible, update its position.
-		SetPosition( mMapView->TileToWorldCoords( mUnit->GetTilePos() ) );
+		SetPosition( mMapView->TileToWorldCoords( mUnit->GetTilePos() ), false );
 	}
 }
@@ -15,8 +15,10 @@ namespace mage
 		void Update( float elapsedTime );
 		void Draw( const Camera& camera );
 
-		void SetPosition( const Vec2f& position );
+		void SetPosition( const Vec2f& position, bool interpolate = true );
 		Vec2f GetPosition() const;
+		Vec2f GetInterpolatedPosition( float interpolation ) const;
+		void SavePreviousPosition();
 
 		void SetUnit( Unit* unit );
 		Unit* GetUnit() const;
@@ -47,6 +49,8 @@ namespace mage
 		MapView* mMapView;
 		Unit* mUnit;
 		Sprite* mSprite;
+		Vec2f mPosition;
+		Vec2f mPreviousPosition;
 
 		friend class MapView;
 	};
@@ -3,8 +3,12 @@
 using namespace mage;
 
 
+const size_t Ability::INVALID_INDEX;
+
+
 Ability::Ability( Map* map ) :
-	mMap( map )
+	mMap( map ),
+	mIndex( INVALID_INDEX )
 {
 	assertion( mMap, "Cannot create Ability without a Map!" );
 }
@@ -31,6 +35,12 @@ Map* Ability::GetMap() const
 }
 
 
+size_t Ability::GetIndex() const
+{
+	return mIndex;
+}
+
+
 SingleTargetComponent::Action::Action() :
 	TargetID( -1 )
 { }
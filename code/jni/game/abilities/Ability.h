@@ -31,6 +31,8 @@ namespace mage
 	public:
 		class Action;
 
+		static const size_t INVALID_INDEX = (size_t) -1;
+
 		Ability( Map* map );
 		virtual ~Ability();
 
@@ -39,9 +41,13 @@ namespace mage
 		virtual void ProcessAction( Action* action ) = 0;
 		virtual const HashString& GetType() const = 0;
 		Map* GetMap() const;
+		size_t GetIndex() const;
 
 	private:
 		Map* mMap;
+		size_t mIndex;
+
+		friend class Map;
 	};
 
 
@@ -51,7 +57,9 @@ namespace mage
 	class Ability::Action
 	{
 	public:
-		Action() { }
+		Action() :
+			AbilityIndex( Ability::INVALID_INDEX )
+		{ }
 		virtual ~Action() { }
 
 		virtual void SaveToJSON( rapidjson::Document& document, rapidjson::Value& object ) const = 0;
@@ -59,6 +67,8 @@ namespace mage
 
 		virtual const HashString& GetType() const = 0;
 		bool IsType( const HashString& type ) const;
+
+		size_t AbilityIndex;
 	};
 
 
@@ -0,0 +1,92 @@
+#include "androidwars.h"
+
+using namespace mage;
+
+
+const size_t ActionArena::DEFAULT_BLOCK_SIZE;
+
+
+ActionArena::ActionArena( size_t blockSize ) :
+	mBlockSize( blockSize ),
+	mCurrentBlockIndex( 0 ),
+	mCurrentOffset( 0 )
+{
+	assertion( mBlockSize > 0, "Cannot create ActionArena with a block size of zero!" );
+}
+
+
+ActionArena::~ActionArena()
+{
+	// Destroy all Actions.
+	Reset();
+
+	for( auto it = mBlocks.begin(); it != mBlocks.end(); ++it )
+	{
+		// Free all memory blocks.
+		delete[] *it;
+	}
+
+	mBlocks.clear();
+}
+
+
+void ActionArena::Reset()
+{
+	for( auto it = mActions.begin(); it != mActions.end(); ++it )
+	{
+		// Destroy each Action in place (the memory belongs to the arena).
+		Ability::Action* action = *it;
+		action->~Action();
+	}
+
+	mActions.clear();
+
+	// Rewind to the start of the first block, but hold on to all memory for the next query.
+	mCurrentBlockIndex = 0;
+	mCurrentOffset = 0;
+}
+
+
+const Path& ActionArena::SharePath( const Path& path )
+{
+	// Copy the Path into the arena so that every Action from this query can reference it.
+	// (Assigning over the previous Path reuses its storage.)
+	mSharedPath = path;
+	return mSharedPath;
+}
+
+
+void* ActionArena::Allocate( size_t size, size_t alignment )
+{
+	assertion( size <= mBlockSize, "Cannot allocate %d bytes from ActionArena with a block size of %d bytes!", size, mBlockSize );
+
+	void* result = nullptr;
+
+	while( !result )
+	{
+		if( mCurrentBlockIndex >= mBlocks.size() )
+		{
+			// If all blocks are full, add a new one.
+			mBlocks.push_back( new char[ mBlockSize ] );
+		}
+
+		// Align the allocation within the current block.
+		char* block = mBlocks[ mCurrentBlockIndex ];
+		size_t offset = ( ( mCurrentOffset + alignment - 1 ) / alignment ) * alignment;
+
+		if( offset + size <= mBlockSize )
+		{
+			// If the allocation fits in the current block, claim the memory.
+			result = ( block + offset );
+			mCurrentOffset = ( offset + size );
+		}
+		else
+		{
+			// Otherwise, move on to the next block.
+			++mCurrentBlockIndex;
+			mCurrentOffset = 0;
+		}
+	}
+
+	return result;
+}
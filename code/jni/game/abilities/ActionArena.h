@@ -0,0 +1,76 @@
+#pragma once
+
+namespace mage
+{
+	/**
+	 * Owns all Ability::Actions created during a single available actions query.
+	 *
+	 * Actions are constructed in place inside large reusable memory blocks, and every Action
+	 * created by a query shares a single copy of the movement Path. Reset() destroys all Actions
+	 * but keeps the memory around, so once the arena has grown to fit the largest query,
+	 * determining available actions never touches the general heap.
+	 */
+	class ActionArena
+	{
+	public:
+		static const size_t DEFAULT_BLOCK_SIZE = 4096;
+
+		ActionArena( size_t blockSize = DEFAULT_BLOCK_SIZE );
+		~ActionArena();
+
+		template< class ActionSubclass >
+		ActionSubclass* Create();
+		void Reset();
+
+		const Path& SharePath( const Path& path );
+		const Path& GetSharedPath() const;
+
+		size_t GetActionCount() const;
+		size_t GetBlockCount() const;
+
+	private:
+		ActionArena( const ActionArena& other );
+		void operator=( const ActionArena& other );
+
+		void* Allocate( size_t size, size_t alignment );
+
+		size_t mBlockSize;
+		size_t mCurrentBlockIndex;
+		size_t mCurrentOffset;
+		std::vector< char* > mBlocks;
+		Actions mActions;
+		Path mSharedPath;
+	};
+
+
+	template< class ActionSubclass >
+	ActionSubclass* ActionArena::Create()
+	{
+		// Construct the Action in place inside the arena.
+		void* memory = Allocate( sizeof( ActionSubclass ), alignof( ActionSubclass ) );
+		ActionSubclass* action = new( memory ) ActionSubclass();
+
+		// Keep track of the Action so it can be destroyed when the arena is reset.
+		mActions.push_back( action );
+
+		return action;
+	}
+
+
+	inline const Path& ActionArena::GetSharedPath() const
+	{
+		return mSharedPath;
+	}
+
+
+	inline size_t ActionArena::GetActionCount() const
+	{
+		return mActions.size();
+	}
+
+
+	inline size_t ActionArena::GetBlockCount() const
+	{
+		return mBlocks.size();
+	}
+}
@@ -23,7 +23,7 @@ void UnitAbility::ProcessAction( Ability::Action* action )
 	if( unit )
 	{
 		// Move the Unit along the movement path.
-		unitAction->MoveWasSuccessful = unit->Move( unitAction->MovementPath );
+		unitAction->MoveWasSuccessful = unit->Move( unitAction->GetMovementPath() );
 
 		if( unitAction->MoveWasSuccessful )
 		{
@@ -41,9 +41,21 @@ void UnitAbility::ProcessAction( Ability::Action* action )
 }
 
 
+void UnitAbility::InitAction( UnitAbility::Action* action, const Unit* unit, ActionArena& arena ) const
+{
+	// Remember which Ability created the Action so the Map can dispatch it directly.
+	action->AbilityIndex = GetIndex();
+	action->UnitID = unit->GetID();
+
+	// Reference the movement Path shared by all Actions in the arena instead of copying it.
+	action->ShareMovementPath( &arena.GetSharedPath() );
+}
+
+
 UnitAbility::Action::Action() :
 	UnitID( -1 ),
-	MoveWasSuccessful( false )
+	MoveWasSuccessful( false ),
+	mMovementPath( &mOwnMovementPath )
 { }
 
 
@@ -61,7 +73,7 @@ void UnitAbility::Action::SaveToJSON( rapidjson::Document& document, rapidjson::
 	rapidjson::Value pathJSON;
 	pathJSON.SetObject();
 
-	MovementPath.SaveToJSON( document, pathJSON );
+	mMovementPath->SaveToJSON( document, pathJSON );
 
 	object.AddMember( "movementPath", pathJSON, document.GetAllocator() );
 }
@@ -78,10 +90,28 @@ void UnitAbility::Action::LoadFromJSON( const rapidjson::Value& object )
 	{
 		// Load the movement path.
 		const rapidjson::Value& pathJSON = object[ "movementPath" ];
-		MovementPath.LoadFromJSON( pathJSON );
+		mOwnMovementPath.LoadFromJSON( pathJSON );
+		mMovementPath = &mOwnMovementPath;
 	}
 	else
 	{
 		WarnFail( "No \"movementPath\" object found in JSON for UnitAbility::Action!" );
 	}
 }
+
+
+void UnitAbility::Action::SetMovementPath( const Path& movementPath )
+{
+	// Keep a private copy of the Path.
+	mOwnMovementPath = movementPath;
+	mMovementPath = &mOwnMovementPath;
+}
+
+
+void UnitAbility::Action::ShareMovementPath( const Path* movementPath )
+{
+	assertion( movementPath, "Cannot share null movement Path with UnitAbility::Action!" );
+
+	// Reference a Path owned by someone else (which must outlive this Action).
+	mMovementPath = movementPath;
+}
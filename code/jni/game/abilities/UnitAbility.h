@@ -16,11 +16,15 @@ namespace mage
 		UnitAbility( Map* map );
 		virtual ~UnitAbility();
 
-		virtual void DetermineAvailableActions( const Unit* unit, const Path& movementPath, Actions& result ) const = 0;
+		virtual void DetermineAvailableActions( const Unit* unit, ActionArena& arena, Actions& result ) const = 0;
 		virtual void ProcessAction( Ability::Action* action );
 
 	protected:
 		virtual void ProcessUnitAction( UnitAbility::Action* action ) = 0;
+
+		template< class ActionSubclass >
+		ActionSubclass* CreateAction( const Unit* unit, ActionArena& arena ) const;
+		void InitAction( UnitAbility::Action* action, const Unit* unit, ActionArena& arena ) const;
 	};
 
 
@@ -36,8 +40,34 @@ namespace mage
 		void SaveToJSON( rapidjson::Document& document, rapidjson::Value& object ) const;
 		void LoadFromJSON( const rapidjson::Value& object );
 
+		void SetMovementPath( const Path& movementPath );
+		void ShareMovementPath( const Path* movementPath );
+		const Path& GetMovementPath() const;
+
 		bool MoveWasSuccessful;
 		int UnitID;
-		Path MovementPath;
+
+	private:
+		Action( const Action& other );
+		void operator=( const Action& other );
+
+		const Path* mMovementPath;
+		Path mOwnMovementPath;
 	};
+
+
+	template< class ActionSubclass >
+	ActionSubclass* UnitAbility::CreateAction( const Unit* unit, ActionArena& arena ) const
+	{
+		// Create the Action inside the arena and fill in the data shared by all UnitAbility actions.
+		ActionSubclass* action = arena.Create< ActionSubclass >();
+		InitAction( action, unit, arena );
+		return action;
+	}
+
+
+	inline const Path& UnitAbility::Action::GetMovementPath() const
+	{
+		return *mMovementPath;
+	}
 }
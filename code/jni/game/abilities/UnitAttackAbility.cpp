@@ -14,7 +14,7 @@ UnitAttackAbility::UnitAttackAbility( Map* map ) :
 UnitAttackAbility::~UnitAttackAbility() { }
 
 
-void UnitAttackAbility::DetermineAvailableActions( const Unit* unit, const Path& movementPath, Actions& result ) const
+void UnitAttackAbility::DetermineAvailableActions( const Unit* unit, ActionArena& arena, Actions& result ) const
 {
 	// Get the UnitType of the Unit.
 	UnitType* unitType = unit->GetUnitType();
@@ -22,27 +22,26 @@ void UnitAttackAbility::DetermineAvailableActions( const Unit* unit, const Path&
 	if( unitType->HasWeapons() )
 	{
 		// If this Unit has weapons, determine whether the Unit can wait in the destination square.
+		const Path& movementPath = arena.GetSharedPath();
 		Map* map = unit->GetMap();
 		Map::Iterator destinationTile = map->GetTile( movementPath.GetDestination() );
 
 		if( unit->CanOccupyTile( destinationTile ) )
 		{
 			// If the Unit can stop here, get the list of Units in attack range from this location.
-			Map::Units unitsInRange;
-			map->FindUnitsInRange( destinationTile.GetPosition(), unitType->GetAttackRange(), unitsInRange );
+			// (The list is kept around between queries so it doesn't need to be reallocated.)
+			mUnitsInRange.clear();
+			map->FindUnitsInRange( destinationTile.GetPosition(), unitType->GetAttackRange(), mUnitsInRange );
 
-			for( auto it = unitsInRange.begin(); it != unitsInRange.end(); ++it )
+			for( auto it = mUnitsInRange.begin(); it != mUnitsInRange.end(); ++it )
 			{
 				Unit* target = *it;
 
 				if( unit->CanAttack( target ) )
 				{
 					// Add an attack action to the list of actions.
-					UnitAttackAbility::Action* attackAction = new UnitAttackAbility::Action();
-
-					attackAction->UnitID = unit->GetID();
+					UnitAttackAbility::Action* attackAction = CreateAction< UnitAttackAbility::Action >( unit, arena );
 					attackAction->TargetID = target->GetID();
-					attackAction->MovementPath = movementPath;
 
 					result.push_back( attackAction );
 				}
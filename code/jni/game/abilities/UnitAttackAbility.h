@@ -13,10 +13,13 @@ namespace mage
 		UnitAttackAbility( Map* map );
 		virtual ~UnitAttackAbility();
 
-		virtual void DetermineAvailableActions( const Unit* unit, const Path& movementPath, Actions& result ) const;
+		virtual void DetermineAvailableActions( const Unit* unit, ActionArena& arena, Actions& result ) const;
 
 	protected:
 		virtual void ProcessUnitAction( UnitAbility::Action* action );
+
+	private:
+		mutable std::vector< Unit* > mUnitsInRange;
 	};
 
 
@@ -14,10 +14,10 @@ UnitCaptureAbility::UnitCaptureAbility( Map* map ) :
 UnitCaptureAbility::~UnitCaptureAbility() { }
 
 
-void UnitCaptureAbility::DetermineAvailableActions( const Unit* unit, const Path& movementPath, Actions& result ) const
+void UnitCaptureAbility::DetermineAvailableActions( const Unit* unit, ActionArena& arena, Actions& result ) const
 {
 	// Get the destination Tile.
-	Map::Iterator destinationTile = GetMap()->GetTile( movementPath.GetDestination() );
+	Map::Iterator destinationTile = GetMap()->GetTile( arena.GetSharedPath().GetDestination() );
 
 	if( destinationTile.IsValid() && destinationTile->HasTerrainType() )
 	{
@@ -28,11 +28,7 @@ void UnitCaptureAbility::DetermineAvailableActions( const Unit* unit, const Path
 		if( destinationTile->IsCapturable() && GetMap()->AreEnemies( unitOwner, tileOwner ) )
 		{
 			// If the tile can be captured by the Unit, add a capture action.
-			UnitCaptureAbility::Action* captureAction = new UnitCaptureAbility::Action();
-
-			captureAction->UnitID = unit->GetID();
-			captureAction->MovementPath = movementPath;
-
+			UnitCaptureAbility::Action* captureAction = CreateAction< UnitCaptureAbility::Action >( unit, arena );
 			result.push_back( captureAction );
 		}
 	}
@@ -50,7 +46,7 @@ void UnitCaptureAbility::ProcessUnitAction( UnitAbility::Action* unitAction )
 	assertion( unit, "Invalid Unit ID (%d) specified for UnitCaptureAbility::Action!", captureAction->UnitID );
 
 	// Get the destination Tile.
-	Map::Iterator destinationTile = GetMap()->GetTile( unitAction->MovementPath.GetDestination() );
+	Map::Iterator destinationTile = GetMap()->GetTile( unitAction->GetMovementPath().GetDestination() );
 	assertion( destinationTile.IsValid() && destinationTile->HasTerrainType(), "Invalid Tile (%d,%d) specified for UnitCaptureAbility::Action!", destinationTile.GetX(), destinationTile.GetY() );
 
 	// Capture the Tile.
@@ -10,7 +10,7 @@ namespace mage
 		UnitCaptureAbility( Map* map );
 		virtual ~UnitCaptureAbility();
 
-		virtual void DetermineAvailableActions( const Unit* unit, const Path& movementPath, Actions& result ) const;
+		virtual void DetermineAvailableActions( const Unit* unit, ActionArena& arena, Actions& result ) const;
 
 	private:
 		virtual void ProcessUnitAction( UnitAbility::Action* unitAction );
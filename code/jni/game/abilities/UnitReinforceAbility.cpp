@@ -14,10 +14,10 @@ UnitReinforceAbility::UnitReinforceAbility( Map* map ) :
 UnitReinforceAbility::~UnitReinforceAbility() { }
 
 
-void UnitReinforceAbility::DetermineAvailableActions( const Unit* unit, const Path& movementPath, Actions& result ) const
+void UnitReinforceAbility::DetermineAvailableActions( const Unit* unit, ActionArena& arena, Actions& result ) const
 {
 	// Get the destination Tile.
-	Map::Iterator destinationTile = GetMap()->GetTile( movementPath.GetDestination() );
+	Map::Iterator destinationTile = GetMap()->GetTile( arena.GetSharedPath().GetDestination() );
 
 	if( destinationTile.IsValid() && unit->CanEnterTile( destinationTile ) )
 	{
@@ -27,11 +27,9 @@ void UnitReinforceAbility::DetermineAvailableActions( const Unit* unit, const Pa
 		if( target && unit->CanReinforce( target ) )
 		{
 			// If there is a Unit in the destination tile and this Unit can reinforce it, add a reinforce action.
-			UnitReinforceAbility::Action* reinforceAction = new UnitReinforceAbility::Action();
+			UnitReinforceAbility::Action* reinforceAction = CreateAction< UnitReinforceAbility::Action >( unit, arena );
 
 			// Add necessary data to the action.
-			reinforceAction->UnitID = unit->GetID();
-			reinforceAction->MovementPath = movementPath;
 			reinforceAction->TargetUnitID = target->GetID();
 
 			// Calculate the amount of health, supplies, and ammo that the reinforced Unit will have.
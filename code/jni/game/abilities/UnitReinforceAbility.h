@@ -10,7 +10,7 @@ namespace mage
 		UnitReinforceAbility( Map* map );
 		virtual ~UnitReinforceAbility();
 
-		virtual void DetermineAvailableActions( const Unit* unit, const Path& movementPath, Actions& result ) const;
+		virtual void DetermineAvailableActions( const Unit* unit, ActionArena& arena, Actions& result ) const;
 
 	protected:
 		virtual void ProcessUnitAction( UnitAbility::Action* action );
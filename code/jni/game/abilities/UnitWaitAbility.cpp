@@ -14,20 +14,17 @@ UnitWaitAbility::UnitWaitAbility( Map* map ) :
 UnitWaitAbility::~UnitWaitAbility() { }
 
 
-void UnitWaitAbility::DetermineAvailableActions( const Unit* unit, const Path& movementPath, Actions& result ) const
+void UnitWaitAbility::DetermineAvailableActions( const Unit* unit, ActionArena& arena, Actions& result ) const
 {
 	// Determine whether the Unit can wait in the destination square.
+	const Path& movementPath = arena.GetSharedPath();
 	Map* map = unit->GetMap();
 	Map::Iterator destinationTile = map->GetTile( movementPath.GetDestination() );
 
 	if( unit->CanOccupyTile( destinationTile ) )
 	{
 		// If the Unit can wait in the destination tile, add a new action for it.
-		Action* waitAction = new Action();
-
-		waitAction->UnitID = unit->GetID();
-		waitAction->MovementPath = movementPath;
-
+		Action* waitAction = CreateAction< Action >( unit, arena );
 		result.push_back( waitAction );
 	}
 }
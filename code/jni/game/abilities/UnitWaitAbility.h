@@ -13,7 +13,7 @@ namespace mage
 		UnitWaitAbility( Map* map );
 		virtual ~UnitWaitAbility();
 
-		virtual void DetermineAvailableActions( const Unit* unit, const Path& movementPath, Actions& result ) const;
+		virtual void DetermineAvailableActions( const Unit* unit, ActionArena& arena, Actions& result ) const;
 
 	protected:
 		virtual void ProcessUnitAction( UnitAbility::Action* action );
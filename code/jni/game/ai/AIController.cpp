@@ -0,0 +1,578 @@
+#include "androidwars.h"
+
+using namespace mage;
+
+
+const float AIController::DEFAULT_FRAME_BUDGET = 0.004f;
+const float AIController::DEFAULT_THINK_TIME = 0.75f;
+const float AIController::EXPLORATION_FACTOR = 0.7f;
+const int AIController::DEFAULT_ROLLOUT_TURN_COUNT;
+
+
+int AIController::GetActionTargetID( const Ability::Action* action )
+{
+	int result = -1;
+
+	const SingleTargetComponent::Action* singleTargetAction = dynamic_cast< const SingleTargetComponent::Action* >( action );
+	const UnitReinforceAbility::Action* reinforceAction = dynamic_cast< const UnitReinforceAbility::Action* >( action );
+
+	if( singleTargetAction )
+	{
+		result = singleTargetAction->TargetID;
+	}
+	else if( reinforceAction )
+	{
+		result = reinforceAction->TargetUnitID;
+	}
+
+	return result;
+}
+
+
+void AIController::WorkerMain( void* userData )
+{
+	Worker* worker = (Worker*) userData;
+
+	while( worker->Controller->RunRollout( worker->Simulation ) )
+	{
+		// Keep playing out random games until the search is stopped.
+	}
+}
+
+
+AIController::AIController( Map* map, Faction* faction ) :
+	mMap( map ),
+	mFaction( faction ),
+	mEvaluator( &mDefaultEvaluator ),
+	mPhase( PHASE_IDLE ),
+	mFrameBudget( DEFAULT_FRAME_BUDGET ),
+	mThinkTime( DEFAULT_THINK_TIME ),
+	mWorkerCount( 0 ),
+	mRolloutTurnCount( DEFAULT_ROLLOUT_TURN_COUNT ),
+	mUnitIndex( 0 ),
+	mTileIndex( 0 ),
+	mHasReachableTiles( false ),
+	mIsSearching( false ),
+	mFactionIndex( 0 ),
+	mTotalVisits( 0 ),
+	mNextSeed( 1 ),
+	mNodeCount( 0 ),
+	mRolloutCount( 0 ),
+	mSearchStartTime( 0.0 ),
+	mTotalSearchTime( 0.0 )
+{
+	assertion( mMap, "Cannot create AIController without a Map!" );
+	assertion( mFaction, "Cannot create AIController without a Faction to control!" );
+
+	// Leave one core free for the main thread.
+	int processorCount = (int) Thread::GetMaxThreadConcurrency();
+	mWorkerCount = std::max( processorCount - 1, 0 );
+}
+
+
+AIController::~AIController()
+{
+	// Make sure no workers are left running.
+	StopSearch();
+}
+
+
+void AIController::SetEvaluator( const AIEvaluator* evaluator )
+{
+	assertion( !IsThinking(), "Cannot change the AIEvaluator while the AIController is thinking!" );
+	mEvaluator = ( evaluator ? evaluator : &mDefaultEvaluator );
+}
+
+
+void AIController::SetFrameBudget( float frameBudget )
+{
+	mFrameBudget = std::max( frameBudget, 0.0f );
+}
+
+
+void AIController::SetThinkTime( float thinkTime )
+{
+	mThinkTime = std::max( thinkTime, 0.0f );
+}
+
+
+void AIController::SetWorkerCount( int workerCount )
+{
+	assertion( !IsThinking(), "Cannot change the number of AI workers while the AIController is thinking!" );
+	mWorkerCount = std::max( workerCount, 0 );
+}
+
+
+void AIController::SetRolloutTurnCount( int rolloutTurnCount )
+{
+	assertion( !IsThinking(), "Cannot change the rollout length while the AIController is thinking!" );
+	mRolloutTurnCount = std::max( rolloutTurnCount, 0 );
+}
+
+
+void AIController::StartTurn()
+{
+	// Stop anything left over from the previous turn.
+	StopSearch();
+
+	// Flatten the rules of the Map for the simulations.
+	mRules.Build( mMap );
+
+	// Reset the statistics.
+	mNodeCount = 0;
+	mRolloutCount = 0;
+	mTotalSearchTime = 0.0;
+	mSkippedUnitIDs.clear();
+
+	// Start looking for the first Action.
+	BeginEnumeration();
+}
+
+
+Ability::Action* AIController::Update()
+{
+	Ability::Action* result = nullptr;
+
+	double deadline = ( Clock::QueryTime( Clock::TIME_SEC ) + mFrameBudget );
+
+	if( mPhase == PHASE_ACTION_CHOSEN )
+	{
+		// The last chosen Action has been performed by now, so gather the Units that can still act.
+		BeginEnumeration();
+	}
+
+	if( mPhase == PHASE_ENUMERATING )
+	{
+		if( EnumerateCandidates( deadline ) )
+		{
+			if( mCandidates.empty() )
+			{
+				// If there is nothing left to do, the turn is over.
+				mPhase = PHASE_FINISHED;
+				DebugPrintf( "AI finished its turn. (%lu rollouts, %lu nodes, %.0f nodes/sec)", GetRolloutCount(), GetNodeCount(), GetNodesPerSecond() );
+			}
+			else
+			{
+				// Otherwise, start searching for the best candidate.
+				StartSearch();
+			}
+		}
+	}
+	else if( mPhase == PHASE_SEARCHING )
+	{
+		if( mWorkers.empty() )
+		{
+			// If there are no worker threads, run playouts on this thread until the frame budget runs out.
+			do
+			{
+				RunRollout( mMainThreadSimulation );
+			}
+			while( Clock::QueryTime( Clock::TIME_SEC ) < deadline );
+		}
+
+		double searchTime = ( Clock::QueryTime( Clock::TIME_SEC ) - mSearchStartTime );
+
+		if( searchTime >= mThinkTime || mCandidates.size() == 1 )
+		{
+			// Once time is up (or there was only one choice), commit to the best candidate.
+			result = FinishSearch();
+		}
+	}
+
+	return result;
+}
+
+
+void AIController::EndTurn()
+{
+	// Stop searching and go idle.
+	StopSearch();
+	mCandidates.clear();
+	mPhase = PHASE_IDLE;
+}
+
+
+unsigned long AIController::GetNodeCount() const
+{
+	CriticalBlock( mMutex );
+	return mNodeCount;
+}
+
+
+unsigned long AIController::GetRolloutCount() const
+{
+	CriticalBlock( mMutex );
+	return mRolloutCount;
+}
+
+
+float AIController::GetNodesPerSecond() const
+{
+	CriticalBlock( mMutex );
+
+	double searchTime = mTotalSearchTime;
+
+	if( mIsSearching )
+	{
+		// Include the time spent on the current search.
+		searchTime += ( Clock::QueryTime( Clock::TIME_SEC ) - mSearchStartTime );
+	}
+
+	return ( searchTime > 0.0 ? (float) ( mNodeCount / searchTime ) : 0.0f );
+}
+
+
+void AIController::BeginEnumeration()
+{
+	mCandidates.clear();
+	mUnitIDs.clear();
+	mUnitIndex = 0;
+	mTileIndex = 0;
+	mHasReachableTiles = false;
+
+	const Faction::Units& units = mFaction->GetUnits();
+
+	for( auto it = units.begin(); it != units.end(); ++it )
+	{
+		const Unit* unit = *it;
+
+		if( unit->IsAlive() && unit->IsActive() &&
+			std::find( mSkippedUnitIDs.begin(), mSkippedUnitIDs.end(), unit->GetID() ) == mSkippedUnitIDs.end() )
+		{
+			// Consider every Unit that can still act this turn.
+			mUnitIDs.push_back( unit->GetID() );
+		}
+	}
+
+	// Enumerate the Units closest to the enemy first, so they get the most search time.
+	std::vector< std::pair< int, int > > unitOrder;
+
+	for( auto it = mUnitIDs.begin(); it != mUnitIDs.end(); ++it )
+	{
+		const Unit* unit = mMap->GetUnitByID( *it );
+		const DistanceField& field = mMap->GetDistanceField( mFaction, Map::DISTANCE_GOAL_ENEMY_UNITS, unit->GetMovementType() );
+		int distance = field.GetDistance( unit->GetTilePos() );
+		unitOrder.push_back( std::make_pair( ( distance == DistanceField::UNREACHABLE ? Mathi::MAX_REAL : distance ), *it ) );
+	}
+
+	std::sort( unitOrder.begin(), unitOrder.end() );
+
+	for( size_t i = 0; i < unitOrder.size(); ++i )
+	{
+		mUnitIDs[ i ] = unitOrder[ i ].second;
+	}
+
+	mPhase = PHASE_ENUMERATING;
+}
+
+
+bool AIController::EnumerateCandidates( double deadline )
+{
+	bool isFinished = true;
+
+	while( mUnitIndex < mUnitIDs.size() )
+	{
+		const Unit* unit = mMap->GetUnitByID( mUnitIDs[ mUnitIndex ] );
+
+		if( unit && !( unit->IsAlive() && unit->IsActive() ) )
+		{
+			// Skip Units that can no longer act this turn.
+			unit = nullptr;
+		}
+
+		if( unit && !mHasReachableTiles )
+		{
+			// Gather all tiles the Unit can reach.
+			mReachableTilePositions.clear();
+			mMap->ForEachReachableTile( unit, Map::ForEachReachableTileCallback( this, &AIController::AddReachableTile ) );
+			mHasReachableTiles = true;
+			mTileIndex = 0;
+		}
+
+		while( unit && mTileIndex < mReachableTilePositions.size() )
+		{
+			// Add a candidate for each Action the Unit could take from each tile.
+			AddCandidatesForTile( unit, mReachableTilePositions[ mTileIndex ] );
+			++mTileIndex;
+
+			if( Clock::QueryTime( Clock::TIME_SEC ) >= deadline )
+			{
+				// Pick up where we left off next frame.
+				isFinished = false;
+				break;
+			}
+		}
+
+		if( !isFinished )
+		{
+			break;
+		}
+
+		// Move on to the next Unit.
+		++mUnitIndex;
+		mHasReachableTiles = false;
+	}
+
+	return isFinished;
+}
+
+
+void AIController::AddReachableTile( const Map::Iterator& tile, const Unit* /*unit*/ )
+{
+	mReachableTilePositions.push_back( tile.GetPosition() );
+}
+
+
+void AIController::AddCandidatesForTile( const Unit* unit, const Vec2s& tilePos )
+{
+	// Find the path to the tile and the Actions available at the end of it.
+	mMap->FindBestPathToTile( unit, tilePos, mPath );
+	mMap->DetermineAvailableActions( unit, mPath, mActionArena, mActions );
+
+	for( auto it = mActions.begin(); it != mActions.end(); ++it )
+	{
+		const Ability::Action* action = *it;
+
+		Candidate candidate;
+		candidate.UnitID = unit->GetID();
+		candidate.TargetID = GetActionTargetID( action );
+		candidate.Destination = tilePos;
+		candidate.ActionType = action->GetType();
+		candidate.MovementPath = mPath;
+		candidate.Visits = 0;
+		candidate.PendingVisits = 0;
+		candidate.TotalScore = 0.0f;
+		mCandidates.push_back( candidate );
+	}
+}
+
+
+void AIController::StartSearch()
+{
+	assertion( mWorkers.empty(), "Cannot start AI search because the previous search is still running!" );
+
+	// Take a snapshot of the game for the playouts.
+	mRootSimulation.LoadFromMap( mMap, &mRules, mFaction );
+	mFactionIndex = mRootSimulation.GetCurrentFactionIndex();
+	mMainThreadSimulation.SetRandomSeed( mNextSeed++ );
+
+	mTotalVisits = 0;
+	mSearchStartTime = Clock::QueryTime( Clock::TIME_SEC );
+	mIsSearching = true;
+	mPhase = PHASE_SEARCHING;
+
+	for( int i = 0; i < mWorkerCount; ++i )
+	{
+		// Start the worker threads.
+		Worker* worker = new Worker();
+		worker->Controller = this;
+		worker->Simulation.SetRandomSeed( mNextSeed++ );
+		worker->WorkerThread = new Thread( &AIController::WorkerMain, worker );
+		mWorkers.push_back( worker );
+	}
+}
+
+
+void AIController::StopSearch()
+{
+	BeginCriticalSection( mMutex );
+
+	if( mIsSearching )
+	{
+		// Tell the workers to stop, and keep track of how long we searched.
+		mIsSearching = false;
+		mTotalSearchTime += ( Clock::QueryTime( Clock::TIME_SEC ) - mSearchStartTime );
+	}
+
+	EndCriticalSection();
+
+	for( auto it = mWorkers.begin(); it != mWorkers.end(); ++it )
+	{
+		// Wait for each worker to finish its current playout.
+		Worker* worker = *it;
+		worker->WorkerThread->Join();
+		delete worker->WorkerThread;
+		delete worker;
+	}
+
+	mWorkers.clear();
+}
+
+
+bool AIController::RunRollout( AISimulation& simulation )
+{
+	int candidateIndex;
+
+	BeginCriticalSection( mMutex );
+
+	if( !mIsSearching )
+	{
+		return false;
+	}
+
+	// Pick a candidate and count it as a pending loss, so other workers spread out to other candidates.
+	candidateIndex = SelectCandidate();
+	++mCandidates[ candidateIndex ].PendingVisits;
+
+	EndCriticalSection();
+
+	// Play the candidate out from the root state.
+	const Candidate& candidate = mCandidates[ candidateIndex ];
+	simulation.CopyStateFrom( mRootSimulation );
+
+	int nodeCount = ApplyCandidate( simulation, candidate );
+	nodeCount += simulation.PlayOut( mRolloutTurnCount );
+
+	float score = mEvaluator->Evaluate( simulation, mFactionIndex );
+
+	BeginCriticalSection( mMutex );
+
+	// Record the result.
+	Candidate& result = mCandidates[ candidateIndex ];
+	--result.PendingVisits;
+	++result.Visits;
+	result.TotalScore += score;
+
+	++mTotalVisits;
+	++mRolloutCount;
+	mNodeCount += nodeCount;
+
+	EndCriticalSection();
+
+	return true;
+}
+
+
+int AIController::SelectCandidate() const
+{
+	int result = 0;
+	float bestValue = -1.0f;
+	float logTotalVisits = logf( (float) ( mTotalVisits + 1 ) );
+
+	for( int i = 0, count = (int) mCandidates.size(); i < count; ++i )
+	{
+		const Candidate& candidate = mCandidates[ i ];
+		unsigned int visits = ( candidate.Visits + candidate.PendingVisits );
+
+		if( visits == 0 )
+		{
+			// Try every candidate at least once.
+			result = i;
+			break;
+		}
+
+		// UCB1 (pending playouts count as losses).
+		float averageScore = ( candidate.TotalScore / visits );
+		float value = averageScore + EXPLORATION_FACTOR * sqrtf( logTotalVisits / visits );
+
+		if( value > bestValue )
+		{
+			bestValue = value;
+			result = i;
+		}
+	}
+
+	return result;
+}
+
+
+int AIController::ApplyCandidate( AISimulation& simulation, const Candidate& candidate ) const
+{
+	int nodeCount = 0;
+
+	int unitIndex = simulation.FindUnitIndexByID( candidate.UnitID );
+
+	if( unitIndex != AISimulation::NO_UNIT )
+	{
+		// Move the Unit and carry out its Action.
+		simulation.MoveUnit( unitIndex, candidate.Destination );
+
+		if( candidate.ActionType == UnitAttackAbility::TYPE )
+		{
+			int targetIndex = simulation.FindUnitIndexByID( candidate.TargetID );
+
+			if( targetIndex != AISimulation::NO_UNIT )
+			{
+				simulation.Attack( unitIndex, targetIndex );
+			}
+		}
+		else if( candidate.ActionType == UnitCaptureAbility::TYPE )
+		{
+			simulation.Capture( unitIndex );
+		}
+
+		simulation.DeactivateUnit( unitIndex );
+		++nodeCount;
+	}
+
+	return nodeCount;
+}
+
+
+Ability::Action* AIController::FinishSearch()
+{
+	StopSearch();
+
+	// Choose the most thoroughly explored candidate (breaking ties by average score).
+	int bestIndex = 0;
+
+	for( int i = 1, count = (int) mCandidates.size(); i < count; ++i )
+	{
+		const Candidate& candidate = mCandidates[ i ];
+		const Candidate& best = mCandidates[ bestIndex ];
+
+		if( candidate.Visits > best.Visits ||
+			( candidate.Visits == best.Visits && candidate.TotalScore > best.TotalScore ) )
+		{
+			bestIndex = i;
+		}
+	}
+
+	const Candidate& best = mCandidates[ bestIndex ];
+
+	DebugPrintf( "AI chose \"%s\" for Unit %d at (%d,%d) out of %d candidates. (%lu rollouts, %lu nodes, %.0f nodes/sec)",
+				 best.ActionType.GetCString(), best.UnitID, best.Destination.x, best.Destination.y, (int) mCandidates.size(),
+				 GetRolloutCount(), GetNodeCount(), GetNodesPerSecond() );
+
+	// Turn the candidate back into a real Action.
+	Ability::Action* result = CreateActionForCandidate( best );
+
+	if( !result )
+	{
+		// Don't get stuck on a Unit whose Action can no longer be performed.
+		WarnFail( "AI could not recreate \"%s\" Action for Unit %d!", best.ActionType.GetCString(), best.UnitID );
+		mSkippedUnitIDs.push_back( best.UnitID );
+	}
+
+	// Look for the next Action once this one has been performed (so the Unit that acted is no longer active).
+	mPhase = PHASE_ACTION_CHOSEN;
+
+	return result;
+}
+
+
+Ability::Action* AIController::CreateActionForCandidate( const Candidate& candidate )
+{
+	Ability::Action* result = nullptr;
+
+	const Unit* unit = mMap->GetUnitByID( candidate.UnitID );
+
+	if( unit )
+	{
+		// Determine the Actions at the end of the path again (they live in the arena until the next query).
+		mMap->DetermineAvailableActions( unit, candidate.MovementPath, mActionArena, mActions );
+
+		for( auto it = mActions.begin(); it != mActions.end(); ++it )
+		{
+			Ability::Action* action = *it;
+
+			if( action->IsType( candidate.ActionType ) && GetActionTargetID( action ) == candidate.TargetID )
+			{
+				result = action;
+				break;
+			}
+		}
+	}
+
+	return result;
+}
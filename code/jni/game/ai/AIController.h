@@ -0,0 +1,196 @@
+#pragma once
+
+namespace mage
+{
+	/**
+	 * Computer player that controls a single Faction.
+	 *
+	 * Each decision is made by an anytime Monte-Carlo search: every Action available to every active Unit
+	 * (found with Map::ForEachReachableTile() and Map::DetermineAvailableActions()) is treated as a candidate,
+	 * and candidates are chosen for random playouts of an AISimulation using UCB1. Playouts run on worker
+	 * threads while the main thread keeps drawing frames; Update() only ever does a bounded slice of work,
+	 * so it can be called every frame without dropping frames.
+	 */
+	class AIController
+	{
+	public:
+		static const float DEFAULT_FRAME_BUDGET;
+		static const float DEFAULT_THINK_TIME;
+		static const float EXPLORATION_FACTOR;
+		static const int DEFAULT_ROLLOUT_TURN_COUNT = 2;
+
+		AIController( Map* map, Faction* faction );
+		~AIController();
+
+		void SetEvaluator( const AIEvaluator* evaluator );
+		const AIEvaluator* GetEvaluator() const;
+
+		void SetFrameBudget( float frameBudget );
+		float GetFrameBudget() const;
+		void SetThinkTime( float thinkTime );
+		float GetThinkTime() const;
+		void SetWorkerCount( int workerCount );
+		int GetWorkerCount() const;
+		void SetRolloutTurnCount( int rolloutTurnCount );
+		int GetRolloutTurnCount() const;
+
+		void StartTurn();
+		Ability::Action* Update();
+		void EndTurn();
+		bool IsThinking() const;
+		bool IsTurnFinished() const;
+
+		Map* GetMap() const;
+		Faction* GetFaction() const;
+
+		unsigned long GetNodeCount() const;
+		unsigned long GetRolloutCount() const;
+		float GetNodesPerSecond() const;
+
+	private:
+		enum Phase
+		{
+			PHASE_IDLE,
+			PHASE_ACTION_CHOSEN,	// Waiting for the chosen Action to be performed before looking for the next one.
+			PHASE_ENUMERATING,
+			PHASE_SEARCHING,
+			PHASE_FINISHED
+		};
+
+		/**
+		 * A single Action that the AI could take next, along with its search statistics.
+		 */
+		struct Candidate
+		{
+			int UnitID;
+			int TargetID;
+			Vec2s Destination;
+			HashString ActionType;
+			Path MovementPath;
+			unsigned int Visits;
+			unsigned int PendingVisits;
+			float TotalScore;
+		};
+
+		typedef std::vector< Candidate > Candidates;
+
+		/**
+		 * State owned by a single search thread.
+		 */
+		struct Worker
+		{
+			AIController* Controller;
+			Thread* WorkerThread;
+			AISimulation Simulation;
+		};
+
+		typedef std::vector< Worker* > Workers;
+
+		static int GetActionTargetID( const Ability::Action* action );
+		static void WorkerMain( void* userData );
+
+		void BeginEnumeration();
+		bool EnumerateCandidates( double deadline );
+		void AddReachableTile( const Map::Iterator& tile, const Unit* unit );
+		void AddCandidatesForTile( const Unit* unit, const Vec2s& tilePos );
+
+		void StartSearch();
+		void StopSearch();
+		bool RunRollout( AISimulation& simulation );
+		int SelectCandidate() const;
+		int ApplyCandidate( AISimulation& simulation, const Candidate& candidate ) const;
+		Ability::Action* FinishSearch();
+		Ability::Action* CreateActionForCandidate( const Candidate& candidate );
+
+		Map* mMap;
+		Faction* mFaction;
+		const AIEvaluator* mEvaluator;
+		MaterialAIEvaluator mDefaultEvaluator;
+		Phase mPhase;
+		float mFrameBudget;
+		float mThinkTime;
+		int mWorkerCount;
+		int mRolloutTurnCount;
+
+		// Candidate enumeration.
+		std::vector< int > mUnitIDs;
+		std::vector< int > mSkippedUnitIDs;
+		std::vector< Vec2s > mReachableTilePositions;
+		size_t mUnitIndex;
+		size_t mTileIndex;
+		bool mHasReachableTiles;
+		Path mPath;
+		ActionArena mActionArena;
+		Actions mActions;
+
+		// Search state (shared with the workers and guarded by mMutex while searching).
+		mutable Mutex mMutex;
+		bool mIsSearching;
+		int mFactionIndex;
+		unsigned int mTotalVisits;
+		unsigned long mNextSeed;
+		unsigned long mNodeCount;
+		unsigned long mRolloutCount;
+		double mSearchStartTime;
+		double mTotalSearchTime;
+		AIRules mRules;
+		AISimulation mRootSimulation;
+		AISimulation mMainThreadSimulation;
+		Candidates mCandidates;
+		Workers mWorkers;
+	};
+
+
+	inline const AIEvaluator* AIController::GetEvaluator() const
+	{
+		return mEvaluator;
+	}
+
+
+	inline float AIController::GetFrameBudget() const
+	{
+		return mFrameBudget;
+	}
+
+
+	inline float AIController::GetThinkTime() const
+	{
+		return mThinkTime;
+	}
+
+
+	inline int AIController::GetWorkerCount() const
+	{
+		return mWorkerCount;
+	}
+
+
+	inline int AIController::GetRolloutTurnCount() const
+	{
+		return mRolloutTurnCount;
+	}
+
+
+	inline bool AIController::IsThinking() const
+	{
+		return ( mPhase == PHASE_ACTION_CHOSEN || mPhase == PHASE_ENUMERATING || mPhase == PHASE_SEARCHING );
+	}
+
+
+	inline bool AIController::IsTurnFinished() const
+	{
+		return ( mPhase == PHASE_FINISHED );
+	}
+
+
+	inline Map* AIController::GetMap() const
+	{
+		return mMap;
+	}
+
+
+	inline Faction* AIController::GetFaction() const
+	{
+		return mFaction;
+	}
+}
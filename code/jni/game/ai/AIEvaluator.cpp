@@ -0,0 +1,63 @@
+#include "androidwars.h"
+
+using namespace mage;
+
+
+const float MaterialAIEvaluator::DEFAULT_HEALTH_PER_INCOME = 0.03f;
+
+
+MaterialAIEvaluator::MaterialAIEvaluator( float healthPerIncome ) :
+	mHealthPerIncome( healthPerIncome )
+{ }
+
+
+MaterialAIEvaluator::~MaterialAIEvaluator() { }
+
+
+float MaterialAIEvaluator::Evaluate( const AISimulation& simulation, int factionIndex ) const
+{
+	float friendlyValue = 0.0f;
+	float enemyValue = 0.0f;
+
+	// Add up the health of every living Unit.
+	const AISimulation::Units& units = simulation.GetUnits();
+
+	for( auto it = units.begin(); it != units.end(); ++it )
+	{
+		float value = (float) std::max( it->Health, 0 );
+
+		if( it->FactionIndex == factionIndex )
+		{
+			friendlyValue += value;
+		}
+		else
+		{
+			enemyValue += value;
+		}
+	}
+
+	// Add the value of every owned tile that produces income.
+	const AIRules* rules = simulation.GetRules();
+
+	for( int tileIndex = 0, tileCount = (int) rules->GetTileCount(); tileIndex < tileCount; ++tileIndex )
+	{
+		int owner = simulation.GetTileOwner( tileIndex );
+
+		if( owner != AISimulation::NO_OWNER )
+		{
+			float value = ( rules->GetIncome( tileIndex ) * mHealthPerIncome );
+
+			if( owner == factionIndex )
+			{
+				friendlyValue += value;
+			}
+			else
+			{
+				enemyValue += value;
+			}
+		}
+	}
+
+	// Express the result as this Faction's share of all material on the board.
+	return ( ( friendlyValue + 1.0f ) / ( friendlyValue + enemyValue + 2.0f ) );
+}
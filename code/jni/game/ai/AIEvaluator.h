@@ -0,0 +1,39 @@
+#pragma once
+
+namespace mage
+{
+	/**
+	 * Scores a simulated game state from the point of view of one Faction.
+	 *
+	 * Evaluators are shared by all AI worker threads, so Evaluate() must not modify any state.
+	 */
+	class AIEvaluator
+	{
+	public:
+		AIEvaluator() { }
+		virtual ~AIEvaluator() { }
+
+		/**
+		 * Returns a score between 0 (certain loss) and 1 (certain win) for the specified Faction.
+		 */
+		virtual float Evaluate( const AISimulation& simulation, int factionIndex ) const = 0;
+	};
+
+
+	/**
+	 * Default evaluator that compares the total health of each side's army plus the value of captured tiles.
+	 */
+	class MaterialAIEvaluator : public AIEvaluator
+	{
+	public:
+		static const float DEFAULT_HEALTH_PER_INCOME;
+
+		MaterialAIEvaluator( float healthPerIncome = DEFAULT_HEALTH_PER_INCOME );
+		virtual ~MaterialAIEvaluator();
+
+		virtual float Evaluate( const AISimulation& simulation, int factionIndex ) const;
+
+	private:
+		float mHealthPerIncome;
+	};
+}
@@ -0,0 +1,284 @@
+#include "androidwars.h"
+
+using namespace mage;
+
+
+const int AIMatchBatch::DEFAULT_MAX_TURN_COUNT;
+const float AIMatchBatch::DEFAULT_THINK_TIME = 0.05f;
+
+
+void AIMatchBatch::RunScalingBenchmark( Scenario* scenario, int matchesPerThread )
+{
+	int maxThreadCount = std::max( (int) Thread::GetMaxThreadConcurrency(), 1 );
+	float baseNodesPerSecond = 0.0f;
+
+	for( int threadCount = 1; threadCount <= maxThreadCount; threadCount *= 2 )
+	{
+		// Give every thread the same amount of work, so perfect scaling keeps the duration constant.
+		AIMatchBatch batch( scenario );
+		batch.Run( matchesPerThread * threadCount, threadCount );
+
+		float nodesPerSecond = batch.GetNodesPerSecond();
+
+		if( threadCount == 1 )
+		{
+			baseNodesPerSecond = nodesPerSecond;
+		}
+
+		float speedup = ( baseNodesPerSecond > 0.0f ? ( nodesPerSecond / baseNodesPerSecond ) : 0.0f );
+		DebugPrintf( "AI match benchmark: %d thread(s), %d matches in %.2f sec (%.2f matches/sec, %.0f nodes/sec, %.2fx speedup)",
+			threadCount, matchesPerThread * threadCount, batch.GetDuration(), batch.GetMatchesPerSecond(), nodesPerSecond, speedup );
+	}
+}
+
+
+void AIMatchBatch::RunnerMain( void* userData )
+{
+	Runner* runner = (Runner*) userData;
+	AIMatchBatch* batch = runner->Batch;
+	int matchIndex;
+
+	while( batch->ClaimMatch( matchIndex ) )
+	{
+		// Play matches until there are none left.
+		// Each match writes to its own (preallocated) result, so no lock is needed.
+		batch->PlayMatch( runner->RunnerMap, matchIndex, batch->mResults[ matchIndex ] );
+	}
+}
+
+
+AIMatchBatch::AIMatchBatch( Scenario* scenario ) :
+	mScenario( scenario ),
+	mSetUpMapCallback( &GameplayState::GenerateTestMap ),
+	mMaxTurnCount( DEFAULT_MAX_TURN_COUNT ),
+	mThinkTime( DEFAULT_THINK_TIME ),
+	mFirstSeed( 1 ),
+	mDuration( 0.0 ),
+	mMatchCount( 0 ),
+	mNextMatchIndex( 0 )
+{
+	assertion( mScenario, "Cannot create AIMatchBatch without a Scenario!" );
+}
+
+
+AIMatchBatch::~AIMatchBatch() { }
+
+
+void AIMatchBatch::SetSetUpMapCallback( SetUpMapCallback callback )
+{
+	assertion( callback.IsValid(), "Cannot set invalid callback for setting up AIMatchBatch Maps!" );
+	mSetUpMapCallback = callback;
+}
+
+
+void AIMatchBatch::SetMaxTurnCount( int maxTurnCount )
+{
+	mMaxTurnCount = std::max( maxTurnCount, 1 );
+}
+
+
+void AIMatchBatch::SetThinkTime( float thinkTime )
+{
+	mThinkTime = std::max( thinkTime, 0.0f );
+}
+
+
+void AIMatchBatch::SetFirstSeed( unsigned long firstSeed )
+{
+	mFirstSeed = firstSeed;
+}
+
+
+void AIMatchBatch::Run( int matchCount, int threadCount )
+{
+	assertion( matchCount >= 0, "Cannot run a negative number of AI matches!" );
+	threadCount = Mathi::Clamp( threadCount, 1, std::max( matchCount, 1 ) );
+
+	// Reset the results.
+	mMatchCount = matchCount;
+	mNextMatchIndex = 0;
+	mResults.assign( matchCount, MatchResult() );
+
+	double startTime = Clock::QueryTime( Clock::TIME_SEC );
+
+	// Give each thread its own Map. Maps are large, so they are created here and reused for every match.
+	Runners runners;
+
+	for( int i = 0; i < threadCount; ++i )
+	{
+		Runner* runner = new Runner();
+		runner->Batch = this;
+		runner->RunnerMap = new Map();
+		runner->RunnerThread = nullptr;
+		runners.push_back( runner );
+	}
+
+	for( size_t i = 1; i < runners.size(); ++i )
+	{
+		// Start all but the first runner on worker threads.
+		runners[ i ]->RunnerThread = new Thread( &AIMatchBatch::RunnerMain, runners[ i ] );
+	}
+
+	// Play matches on this thread too.
+	RunnerMain( runners[ 0 ] );
+
+	for( auto it = runners.begin(); it != runners.end(); ++it )
+	{
+		// Wait for all runners to finish and clean them up.
+		Runner* runner = *it;
+
+		if( runner->RunnerThread )
+		{
+			runner->RunnerThread->Join();
+			delete runner->RunnerThread;
+		}
+
+		delete runner->RunnerMap;
+		delete runner;
+	}
+
+	mDuration = ( Clock::QueryTime( Clock::TIME_SEC ) - startTime );
+}
+
+
+float AIMatchBatch::GetMatchesPerSecond() const
+{
+	return ( mDuration > 0.0 ? (float) ( mResults.size() / mDuration ) : 0.0f );
+}
+
+
+float AIMatchBatch::GetNodesPerSecond() const
+{
+	unsigned long nodeCount = 0;
+
+	for( auto it = mResults.begin(); it != mResults.end(); ++it )
+	{
+		nodeCount += it->NodeCount;
+	}
+
+	return ( mDuration > 0.0 ? (float) ( nodeCount / mDuration ) : 0.0f );
+}
+
+
+bool AIMatchBatch::ClaimMatch( int& matchIndex )
+{
+	CriticalBlock( mMutex );
+
+	bool result = ( mNextMatchIndex < mMatchCount );
+
+	if( result )
+	{
+		matchIndex = mNextMatchIndex++;
+	}
+
+	return result;
+}
+
+
+void AIMatchBatch::PlayMatch( Map* map, int matchIndex, MatchResult& result )
+{
+	double startTime = Clock::QueryTime( Clock::TIME_SEC );
+
+	result.Seed = ( mFirstSeed + matchIndex );
+	result.TurnCount = 0;
+	result.ActionCount = 0;
+	result.WinningFactionIndex = -1;
+	result.NodeCount = 0;
+
+	// Set up the Map for this match.
+	map->Init( mScenario );
+	map->SetRandomSeed( result.Seed );
+	mSetUpMapCallback.Invoke( map );
+
+	// Let the computer play every Faction. Each AI gets the whole think time on this thread.
+	Game game;
+	const Map::Factions& factions = map->GetFactions();
+	std::vector< AIController* > aiControllers;
+
+	for( auto it = factions.begin(); it != factions.end(); ++it )
+	{
+		Faction* faction = *it;
+		game.GivePlayerControlOfFaction( game.CreatePlayer(), faction );
+
+		AIController* aiController = new AIController( map, faction );
+		aiController->SetWorkerCount( 0 );
+		aiController->SetThinkTime( mThinkTime );
+		aiController->SetFrameBudget( mThinkTime );
+		aiControllers.push_back( aiController );
+	}
+
+	// Start the match.
+	game.Init( map );
+
+	AIController* aiController = nullptr;
+	int turnCount = 0;
+
+	while( game.IsInProgress() && turnCount < mMaxTurnCount )
+	{
+		if( !aiController )
+		{
+			// Let the AI for the current Faction start its turn.
+			size_t factionIndex = ( std::find( factions.begin(), factions.end(), game.GetCurrentFaction() ) - factions.begin() );
+			aiController = aiControllers[ factionIndex ];
+			aiController->StartTurn();
+		}
+
+		Ability::Action* action = aiController->Update();
+
+		if( action )
+		{
+			// Perform the Action the AI chose.
+			map->PerformAction( action );
+			++result.ActionCount;
+		}
+		else if( aiController->IsTurnFinished() )
+		{
+			// Once the AI is out of things to do, move on to the next Faction.
+			result.NodeCount += aiController->GetNodeCount();
+			aiController->EndTurn();
+			aiController = nullptr;
+
+			int survivingFactionCount = 0;
+
+			for( size_t i = 0; i < factions.size(); ++i )
+			{
+				if( !factions[ i ]->GetUnits().empty() )
+				{
+					// Remember the last Faction standing.
+					result.WinningFactionIndex = (int) i;
+					++survivingFactionCount;
+				}
+			}
+
+			if( survivingFactionCount <= 1 )
+			{
+				// The match is over once only one Faction has Units left.
+				break;
+			}
+
+			result.WinningFactionIndex = -1;
+			game.NextTurn();
+			++turnCount;
+		}
+	}
+
+	result.TurnCount = turnCount;
+
+	if( aiController )
+	{
+		// Count the search work from a turn that was cut off by the turn limit.
+		result.NodeCount += aiController->GetNodeCount();
+	}
+
+	for( auto it = aiControllers.begin(); it != aiControllers.end(); ++it )
+	{
+		// Clean up the AIs.
+		delete *it;
+	}
+
+	// Clean up the match so the Map can be reused.
+	game.Destroy();
+	map->Destroy();
+
+	result.Duration = ( Clock::QueryTime( Clock::TIME_SEC ) - startTime );
+}
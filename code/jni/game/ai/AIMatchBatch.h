@@ -0,0 +1,118 @@
+#pragma once
+
+namespace mage
+{
+	/**
+	 * Plays complete computer-vs-computer matches without a MapView, spread across any number of threads.
+	 *
+	 * Each thread owns its own Map (which is reused between matches, since Maps are large), and every match
+	 * gets its own Game, random seed and AIControllers. The only thing the threads share is the Scenario,
+	 * which must be fully loaded before Run() is called and is never modified while matches are being played.
+	 */
+	class AIMatchBatch
+	{
+	public:
+		static const int DEFAULT_MAX_TURN_COUNT = 20;
+		static const float DEFAULT_THINK_TIME;
+
+		typedef Delegate< void, Map* > SetUpMapCallback;
+
+		/**
+		 * The outcome of a single match.
+		 */
+		struct MatchResult
+		{
+			unsigned long Seed;
+			int TurnCount;
+			int ActionCount;
+			int WinningFactionIndex;
+			unsigned long NodeCount;
+			double Duration;
+		};
+
+		typedef std::vector< MatchResult > MatchResults;
+
+		static void RunScalingBenchmark( Scenario* scenario, int matchesPerThread );
+
+		AIMatchBatch( Scenario* scenario );
+		~AIMatchBatch();
+
+		void SetSetUpMapCallback( SetUpMapCallback callback );
+		void SetMaxTurnCount( int maxTurnCount );
+		int GetMaxTurnCount() const;
+		void SetThinkTime( float thinkTime );
+		float GetThinkTime() const;
+		void SetFirstSeed( unsigned long firstSeed );
+		unsigned long GetFirstSeed() const;
+
+		void Run( int matchCount, int threadCount );
+
+		const MatchResults& GetResults() const;
+		double GetDuration() const;
+		float GetMatchesPerSecond() const;
+		float GetNodesPerSecond() const;
+
+	private:
+		/**
+		 * State owned by a single match thread.
+		 */
+		struct Runner
+		{
+			AIMatchBatch* Batch;
+			Thread* RunnerThread;
+			Map* RunnerMap;
+		};
+
+		typedef std::vector< Runner* > Runners;
+
+		static void RunnerMain( void* userData );
+
+		bool ClaimMatch( int& matchIndex );
+		void PlayMatch( Map* map, int matchIndex, MatchResult& result );
+
+		Scenario* mScenario;
+		SetUpMapCallback mSetUpMapCallback;
+		int mMaxTurnCount;
+		float mThinkTime;
+		unsigned long mFirstSeed;
+		double mDuration;
+
+		// Handing out matches (guarded by mMutex while running).
+		Mutex mMutex;
+		int mMatchCount;
+		int mNextMatchIndex;
+
+		// One result per match, written only by the thread that played it.
+		MatchResults mResults;
+	};
+
+
+	inline int AIMatchBatch::GetMaxTurnCount() const
+	{
+		return mMaxTurnCount;
+	}
+
+
+	inline float AIMatchBatch::GetThinkTime() const
+	{
+		return mThinkTime;
+	}
+
+
+	inline unsigned long AIMatchBatch::GetFirstSeed() const
+	{
+		return mFirstSeed;
+	}
+
+
+	inline const AIMatchBatch::MatchResults& AIMatchBatch::GetResults() const
+	{
+		return mResults;
+	}
+
+
+	inline double AIMatchBatch::GetDuration() const
+	{
+		return mDuration;
+	}
+}
@@ -0,0 +1,664 @@
+#include "androidwars.h"
+
+using namespace mage;
+
+
+const int AIRules::IMPASSABLE;
+const int AISimulation::NO_OWNER;
+const int AISimulation::NO_UNIT;
+
+
+AIRules::AIRules() :
+	mWidth( 0 ),
+	mHeight( 0 ),
+	mFactionCount( 0 )
+{ }
+
+
+AIRules::~AIRules() { }
+
+
+void AIRules::Build( Map* map )
+{
+	assertion( map, "Cannot build AIRules for null Map!" );
+
+	Clear();
+
+	// Flatten the terrain of every tile.
+	mWidth = map->GetWidth();
+	mHeight = map->GetHeight();
+	mTiles.resize( mWidth * mHeight );
+
+	for( short y = 0; y < mHeight; ++y )
+	{
+		for( short x = 0; x < mWidth; ++x )
+		{
+			Map::ConstIterator tile = map->GetTile( x, y );
+			TileEntry& entry = mTiles[ GetTileIndex( Vec2s( x, y ) ) ];
+
+			if( tile->HasTerrainType() )
+			{
+				const TerrainType* terrainType = tile->GetTerrainType();
+				entry.CoverBonus = terrainType->GetCoverBonus();
+				entry.Income = terrainType->GetIncome();
+				entry.IsCapturable = terrainType->IsCapturable();
+			}
+			else
+			{
+				entry.CoverBonus = 0;
+				entry.Income = 0;
+				entry.IsCapturable = false;
+			}
+		}
+	}
+
+	// Gather every UnitType currently on the Map.
+	const Map::UnitsByID& units = map->GetUnitsByID();
+
+	for( auto it = units.begin(); it != units.end(); ++it )
+	{
+		const UnitType* unitType = it->second->GetUnitType();
+
+		if( GetUnitTypeIndex( unitType ) < 0 )
+		{
+			UnitTypeEntry entry;
+			entry.Type = unitType;
+			entry.MovementRange = unitType->GetMovementRange();
+			entry.AttackRange = unitType->GetAttackRange();
+			mUnitTypes.push_back( entry );
+		}
+	}
+
+	size_t unitTypeCount = mUnitTypes.size();
+	size_t tileCount = mTiles.size();
+
+	// Flatten the movement cost of every UnitType across every tile.
+	mMovementCosts.resize( unitTypeCount * tileCount );
+
+	for( size_t typeIndex = 0; typeIndex < unitTypeCount; ++typeIndex )
+	{
+		const UnitType* unitType = mUnitTypes[ typeIndex ].Type;
+
+		for( short y = 0; y < mHeight; ++y )
+		{
+			for( short x = 0; x < mWidth; ++x )
+			{
+				Map::ConstIterator tile = map->GetTile( x, y );
+				int tileIndex = GetTileIndex( Vec2s( x, y ) );
+				int movementCost = IMPASSABLE;
+
+				if( tile->HasTerrainType() && unitType->CanMoveAcrossTerrain( tile->GetTerrainType() ) )
+				{
+					movementCost = unitType->GetMovementCostAcrossTerrain( tile->GetTerrainType() );
+				}
+
+				mMovementCosts[ typeIndex * tileCount + tileIndex ] = movementCost;
+			}
+		}
+	}
+
+	// Flatten the best damage each UnitType can do to every other UnitType.
+	mDamage.resize( unitTypeCount * unitTypeCount );
+
+	for( size_t attackerIndex = 0; attackerIndex < unitTypeCount; ++attackerIndex )
+	{
+		const UnitType* attackerType = mUnitTypes[ attackerIndex ].Type;
+
+		for( size_t targetIndex = 0; targetIndex < unitTypeCount; ++targetIndex )
+		{
+			const UnitType* targetType = mUnitTypes[ targetIndex ].Type;
+			DamageEntry& entry = mDamage[ attackerIndex * unitTypeCount + targetIndex ];
+
+			entry.AmmoDamagePercentage = 0;
+			entry.AmmoPerShot = 0;
+			entry.FreeDamagePercentage = 0;
+
+			for( int weaponIndex = 0, weaponCount = attackerType->GetNumWeapons(); weaponIndex < weaponCount; ++weaponIndex )
+			{
+				const Weapon& weapon = attackerType->GetWeaponByIndex( weaponIndex );
+				int damagePercentage = weapon.GetDamagePercentageAgainstUnitType( targetType );
+
+				if( weapon.ConsumesAmmo() )
+				{
+					if( damagePercentage > entry.AmmoDamagePercentage )
+					{
+						entry.AmmoDamagePercentage = damagePercentage;
+						entry.AmmoPerShot = weapon.GetAmmoPerShot();
+					}
+				}
+				else
+				{
+					entry.FreeDamagePercentage = std::max( entry.FreeDamagePercentage, damagePercentage );
+				}
+			}
+		}
+	}
+
+	// Copy the distance from every tile to the nearest capturable tile that each Faction doesn't own yet,
+	// so rollouts can steer Units toward captures that are out of reach this turn.
+	const Map::Factions& factions = map->GetFactions();
+	mFactionCount = factions.size();
+	mCaptureDistances.resize( mFactionCount * unitTypeCount * tileCount );
+
+	for( size_t factionIndex = 0; factionIndex < mFactionCount; ++factionIndex )
+	{
+		for( size_t typeIndex = 0; typeIndex < unitTypeCount; ++typeIndex )
+		{
+			const MovementType* movementType = mUnitTypes[ typeIndex ].Type->GetMovementType();
+			const DistanceField& field = map->GetDistanceField( factions[ factionIndex ], Map::DISTANCE_GOAL_CAPTURABLE_TILES, movementType );
+			int* distances = &mCaptureDistances[ ( factionIndex * unitTypeCount + typeIndex ) * tileCount ];
+
+			for( short y = 0; y < mHeight; ++y )
+			{
+				for( short x = 0; x < mWidth; ++x )
+				{
+					distances[ GetTileIndex( Vec2s( x, y ) ) ] = field.GetDistance( x, y );
+				}
+			}
+		}
+	}
+}
+
+
+void AIRules::Clear()
+{
+	mWidth = 0;
+	mHeight = 0;
+	mUnitTypes.clear();
+	mTiles.clear();
+	mMovementCosts.clear();
+	mDamage.clear();
+	mFactionCount = 0;
+	mCaptureDistances.clear();
+}
+
+
+int AIRules::GetUnitTypeIndex( const UnitType* unitType ) const
+{
+	int result = -1;
+
+	for( size_t i = 0, count = mUnitTypes.size(); i < count; ++i )
+	{
+		if( mUnitTypes[ i ].Type == unitType )
+		{
+			result = (int) i;
+			break;
+		}
+	}
+
+	return result;
+}
+
+
+int AIRules::GetAmmoPerShot( int attackerTypeIndex, int targetTypeIndex ) const
+{
+	int result = 0;
+
+	const DamageEntry& entry = mDamage[ attackerTypeIndex * mUnitTypes.size() + targetTypeIndex ];
+
+	if( entry.AmmoDamagePercentage > entry.FreeDamagePercentage )
+	{
+		// Ammo is only spent if the weapon that uses it is the best choice (see Unit::GetBestAvailableWeaponAgainst()).
+		result = entry.AmmoPerShot;
+	}
+
+	return result;
+}
+
+
+AISimulation::AISimulation() :
+	mRules( nullptr ),
+	mFactionCount( 0 ),
+	mCurrentFactionIndex( 0 ),
+	mRandom( 1 )
+{ }
+
+
+AISimulation::~AISimulation() { }
+
+
+void AISimulation::LoadFromMap( const Map* map, const AIRules* rules, const Faction* currentFaction )
+{
+	assertion( map, "Cannot load AISimulation from null Map!" );
+	assertion( rules, "Cannot load AISimulation without AIRules!" );
+
+	mRules = rules;
+
+	// Determine the index of each Faction.
+	const Map::Factions& factions = map->GetFactions();
+	mFactionCount = (int) factions.size();
+	mCurrentFactionIndex = 0;
+
+	for( int i = 0; i < mFactionCount; ++i )
+	{
+		if( factions[ i ] == currentFaction )
+		{
+			mCurrentFactionIndex = i;
+		}
+	}
+
+	// Copy the owner of each tile.
+	size_t tileCount = mRules->GetTileCount();
+	mTileOwners.assign( tileCount, NO_OWNER );
+	mTileUnits.assign( tileCount, NO_UNIT );
+
+	for( short y = 0; y < mRules->GetHeight(); ++y )
+	{
+		for( short x = 0; x < mRules->GetWidth(); ++x )
+		{
+			Faction* owner = map->GetTile( x, y )->GetOwner();
+
+			if( owner )
+			{
+				auto it = std::find( factions.begin(), factions.end(), owner );
+				mTileOwners[ mRules->GetTileIndex( Vec2s( x, y ) ) ] = (int) ( it - factions.begin() );
+			}
+		}
+	}
+
+	// Copy all living Units.
+	mUnits.clear();
+
+	const Map::UnitsByID& units = map->GetUnitsByID();
+
+	for( auto it = units.begin(); it != units.end(); ++it )
+	{
+		const Unit* unit = it->second;
+
+		if( unit->IsAlive() && unit->GetTile().IsValid() )
+		{
+			SimUnit simUnit;
+			simUnit.UnitID = unit->GetID();
+			simUnit.UnitTypeIndex = mRules->GetUnitTypeIndex( unit->GetUnitType() );
+			simUnit.FactionIndex = (int) ( std::find( factions.begin(), factions.end(), unit->GetOwner() ) - factions.begin() );
+			simUnit.TilePos = unit->GetTilePos();
+			simUnit.Health = unit->GetHealth();
+			simUnit.Ammo = unit->GetAmmo();
+			simUnit.IsActive = unit->IsActive();
+
+			assertion( simUnit.UnitTypeIndex > -1, "Cannot load %s into AISimulation because its UnitType is missing from the AIRules!", unit->ToString().c_str() );
+
+			mTileUnits[ mRules->GetTileIndex( simUnit.TilePos ) ] = (int) mUnits.size();
+			mUnits.push_back( simUnit );
+		}
+	}
+}
+
+
+void AISimulation::CopyStateFrom( const AISimulation& other )
+{
+	// Copy the simulated state (reusing the existing buffers), but not the scratch buffers or RNG.
+	mRules = other.mRules;
+	mFactionCount = other.mFactionCount;
+	mCurrentFactionIndex = other.mCurrentFactionIndex;
+	mUnits = other.mUnits;
+	mTileOwners = other.mTileOwners;
+	mTileUnits = other.mTileUnits;
+}
+
+
+void AISimulation::SetRandomSeed( unsigned long seed )
+{
+	mRandom.SetRandomSeed( seed );
+}
+
+
+int AISimulation::RandomInRange( int min, int max )
+{
+	// Each simulation has its own generator, so simulations can run on any thread.
+	return ( min + mRandom.Rand() % ( max - min + 1 ) );
+}
+
+
+int AISimulation::FindUnitIndexByID( int unitID ) const
+{
+	int result = NO_UNIT;
+
+	for( size_t i = 0, count = mUnits.size(); i < count; ++i )
+	{
+		if( mUnits[ i ].UnitID == unitID )
+		{
+			result = (int) i;
+			break;
+		}
+	}
+
+	return result;
+}
+
+
+void AISimulation::MoveUnit( int unitIndex, const Vec2s& destination )
+{
+	SimUnit& unit = mUnits[ unitIndex ];
+
+	int originIndex = mRules->GetTileIndex( unit.TilePos );
+	int destinationIndex = mRules->GetTileIndex( destination );
+
+	if( originIndex != destinationIndex && mTileUnits[ destinationIndex ] == NO_UNIT )
+	{
+		// Move the Unit into the destination tile.
+		mTileUnits[ originIndex ] = NO_UNIT;
+		mTileUnits[ destinationIndex ] = unitIndex;
+		unit.TilePos = destination;
+	}
+}
+
+
+void AISimulation::DeactivateUnit( int unitIndex )
+{
+	mUnits[ unitIndex ].IsActive = false;
+}
+
+
+void AISimulation::Attack( int attackerIndex, int targetIndex )
+{
+	ResolveAttack( attackerIndex, targetIndex );
+
+	if( mUnits[ targetIndex ].Health > 0 )
+	{
+		// If the target survived, let it counter-attack (see UnitAttackAbility::ProcessUnitAction()).
+		ResolveAttack( targetIndex, attackerIndex );
+	}
+}
+
+
+void AISimulation::Capture( int unitIndex )
+{
+	const SimUnit& unit = mUnits[ unitIndex ];
+	int tileIndex = mRules->GetTileIndex( unit.TilePos );
+
+	if( mRules->IsCapturable( tileIndex ) )
+	{
+		// Capturing is currently instantaneous (see UnitCaptureAbility::ProcessUnitAction()).
+		mTileOwners[ tileIndex ] = unit.FactionIndex;
+	}
+}
+
+
+void AISimulation::EndTurn()
+{
+	// Advance to the next Faction.
+	mCurrentFactionIndex = ( ( mCurrentFactionIndex + 1 ) % std::max( mFactionCount, 1 ) );
+
+	for( auto it = mUnits.begin(); it != mUnits.end(); ++it )
+	{
+		// Reactivate all living Units of the new Faction.
+		it->IsActive = ( it->Health > 0 && it->FactionIndex == mCurrentFactionIndex );
+	}
+}
+
+
+int AISimulation::PlayOut( int turnCount )
+{
+	int nodeCount = 0;
+
+	for( int turn = 0; turn <= turnCount; ++turn )
+	{
+		for( size_t i = 0, count = mUnits.size(); i < count; ++i )
+		{
+			const SimUnit& unit = mUnits[ i ];
+
+			if( unit.IsActive && unit.Health > 0 && unit.FactionIndex == mCurrentFactionIndex )
+			{
+				// Let each remaining Unit of the current Faction act.
+				nodeCount += PlayUnit( (int) i );
+			}
+		}
+
+		bool isGameOver = false;
+
+		for( int factionIndex = 0; factionIndex < mFactionCount; ++factionIndex )
+		{
+			isGameOver = ( isGameOver || IsFactionDefeated( factionIndex ) );
+		}
+
+		if( isGameOver )
+		{
+			// Stop once any Faction has been wiped out.
+			break;
+		}
+
+		if( turn < turnCount )
+		{
+			EndTurn();
+		}
+	}
+
+	return nodeCount;
+}
+
+
+bool AISimulation::IsFactionDefeated( int factionIndex ) const
+{
+	bool result = true;
+
+	for( auto it = mUnits.begin(); it != mUnits.end(); ++it )
+	{
+		if( it->FactionIndex == factionIndex && it->Health > 0 )
+		{
+			result = false;
+			break;
+		}
+	}
+
+	return result;
+}
+
+
+int AISimulation::ResolveAttack( int attackerIndex, int targetIndex )
+{
+	SimUnit& attacker = mUnits[ attackerIndex ];
+	SimUnit& target = mUnits[ targetIndex ];
+
+	// Pick the weapon the same way Unit::GetBestAvailableWeaponAgainst() would.
+	int ammoPerShot = mRules->GetAmmoPerShot( attacker.UnitTypeIndex, target.UnitTypeIndex );
+	bool useAmmo = ( ammoPerShot > 0 && attacker.Ammo >= ammoPerShot );
+	int baseDamagePercentage = mRules->GetBaseDamagePercentage( attacker.UnitTypeIndex, target.UnitTypeIndex, useAmmo );
+
+	int totalDamage = 0;
+
+	if( baseDamagePercentage > 0 )
+	{
+		// Roll damage exactly like Unit::Attack().
+		int targetTileIndex = mRules->GetTileIndex( target.TilePos );
+		int damagePercentage = CombatForecast::CalculateDamagePercentage( baseDamagePercentage, attacker.Health, mRules->GetCoverBonus( targetTileIndex ), target.Health );
+
+		totalDamage = ( damagePercentage / 10 );
+
+		if( ( damagePercentage % 10 ) >= RandomInRange( 1, 10 ) )
+		{
+			++totalDamage;
+		}
+
+		target.Health = std::max( target.Health - totalDamage, 0 );
+
+		if( useAmmo )
+		{
+			attacker.Ammo -= ammoPerShot;
+		}
+
+		if( target.Health == 0 )
+		{
+			// Remove dead Units from the board.
+			mTileUnits[ targetTileIndex ] = NO_UNIT;
+			target.IsActive = false;
+		}
+	}
+
+	return totalDamage;
+}
+
+
+int AISimulation::PlayUnit( int unitIndex )
+{
+	// Light playout policy: attack the juiciest target in reach, otherwise capture, otherwise advance.
+	FindReachableTiles( unitIndex );
+
+	const SimUnit& unit = mUnits[ unitIndex ];
+	const IntRange& attackRange = mRules->GetAttackRange( unit.UnitTypeIndex );
+	int unitCount = (int) mUnits.size();
+
+	int bestScore = -1;
+	int bestTileIndex = NO_UNIT;
+	int bestTargetIndex = NO_UNIT;
+
+	for( auto it = mReachableTiles.begin(); it != mReachableTiles.end(); ++it )
+	{
+		int tileIndex = *it;
+		Vec2s tilePos( tileIndex % mRules->GetWidth(), tileIndex / mRules->GetWidth() );
+
+		for( int targetIndex = 0; targetIndex < unitCount; ++targetIndex )
+		{
+			const SimUnit& target = mUnits[ targetIndex ];
+
+			if( target.Health <= 0 || target.FactionIndex == unit.FactionIndex ||
+				!attackRange.IsValueInRange( tilePos.GetManhattanDistanceTo( target.TilePos ) ) )
+			{
+				continue;
+			}
+
+			int baseDamagePercentage = mRules->GetBaseDamagePercentage( unit.UnitTypeIndex, target.UnitTypeIndex, ( unit.Ammo > 0 ) );
+
+			if( baseDamagePercentage > 0 )
+			{
+				// Prefer big hits from good cover, with a little noise so rollouts don't all play the same game.
+				int targetCoverBonus = mRules->GetCoverBonus( mRules->GetTileIndex( target.TilePos ) );
+				int score = CombatForecast::CalculateDamagePercentage( baseDamagePercentage, unit.Health, targetCoverBonus, target.Health );
+				score += ( mRules->GetCoverBonus( tileIndex ) * 5 ) + RandomInRange( 0, 20 );
+
+				if( score > bestScore )
+				{
+					bestScore = score;
+					bestTileIndex = tileIndex;
+					bestTargetIndex = targetIndex;
+				}
+			}
+		}
+	}
+
+	if( bestTargetIndex != NO_UNIT )
+	{
+		// Move in and attack.
+		MoveUnit( unitIndex, Vec2s( bestTileIndex % mRules->GetWidth(), bestTileIndex / mRules->GetWidth() ) );
+		Attack( unitIndex, bestTargetIndex );
+	}
+	else
+	{
+		// Otherwise, head for the closest enemy Unit or capturable tile that isn't already owned.
+		int bestDistance = -1;
+		bool bestIsCapture = false;
+
+		for( auto it = mReachableTiles.begin(); it != mReachableTiles.end(); ++it )
+		{
+			int tileIndex = *it;
+			Vec2s tilePos( tileIndex % mRules->GetWidth(), tileIndex / mRules->GetWidth() );
+
+			bool isCapture = ( mRules->IsCapturable( tileIndex ) && mTileOwners[ tileIndex ] != unit.FactionIndex );
+			int distance = ( isCapture ? 0 : Mathi::MAX_REAL );
+			int captureDistance = mRules->GetCaptureDistance( unit.FactionIndex, unit.UnitTypeIndex, tileIndex );
+
+			if( captureDistance != DistanceField::UNREACHABLE )
+			{
+				// Head toward cities that are too far away to capture this turn.
+				distance = std::min( distance, captureDistance );
+			}
+
+			for( int targetIndex = 0; targetIndex < unitCount && distance > 0; ++targetIndex )
+			{
+				const SimUnit& target = mUnits[ targetIndex ];
+
+				if( target.Health > 0 && target.FactionIndex != unit.FactionIndex )
+				{
+					distance = std::min( distance, (int) tilePos.GetManhattanDistanceTo( target.TilePos ) );
+				}
+			}
+
+			// Break ties randomly.
+			distance = ( distance * 4 ) + RandomInRange( 0, 3 );
+
+			if( bestDistance < 0 || distance < bestDistance )
+			{
+				bestDistance = distance;
+				bestTileIndex = tileIndex;
+				bestIsCapture = isCapture;
+			}
+		}
+
+		if( bestTileIndex != NO_UNIT )
+		{
+			MoveUnit( unitIndex, Vec2s( bestTileIndex % mRules->GetWidth(), bestTileIndex / mRules->GetWidth() ) );
+
+			if( bestIsCapture )
+			{
+				Capture( unitIndex );
+			}
+		}
+	}
+
+	// The Unit is done for this turn.
+	DeactivateUnit( unitIndex );
+
+	return 1;
+}
+
+
+void AISimulation::FindReachableTiles( int unitIndex )
+{
+	const SimUnit& unit = mUnits[ unitIndex ];
+	int movementRange = mRules->GetMovementRange( unit.UnitTypeIndex );
+	int originIndex = mRules->GetTileIndex( unit.TilePos );
+
+	// Reset the scratch buffers.
+	mCostToEnter.assign( mRules->GetTileCount(), Mathi::MAX_REAL );
+	mOpenTiles.clear();
+	mReachableTiles.clear();
+
+	mCostToEnter[ originIndex ] = 0;
+	mOpenTiles.push_back( originIndex );
+
+	static const Vec2s OFFSETS[] = { Vec2s( 0, -1 ), Vec2s( 1, 0 ), Vec2s( 0, 1 ), Vec2s( -1, 0 ) };
+
+	for( size_t openIndex = 0; openIndex < mOpenTiles.size(); ++openIndex )
+	{
+		// Relax the neighbors of each open tile (the maps are small enough that a FIFO queue is plenty).
+		int tileIndex = mOpenTiles[ openIndex ];
+		Vec2s tilePos( tileIndex % mRules->GetWidth(), tileIndex / mRules->GetWidth() );
+
+		for( int direction = 0; direction < 4; ++direction )
+		{
+			Vec2s adjacentPos = ( tilePos + OFFSETS[ direction ] );
+
+			if( !mRules->IsValidTilePos( adjacentPos ) )
+			{
+				continue;
+			}
+
+			int adjacentIndex = mRules->GetTileIndex( adjacentPos );
+			int movementCost = mRules->GetMovementCost( unit.UnitTypeIndex, adjacentIndex );
+			int occupantIndex = mTileUnits[ adjacentIndex ];
+
+			if( movementCost == AIRules::IMPASSABLE || ( occupantIndex != NO_UNIT && mUnits[ occupantIndex ].FactionIndex != unit.FactionIndex ) )
+			{
+				// Units can't cross impassable terrain or enemy Units.
+				continue;
+			}
+
+			int totalCost = ( mCostToEnter[ tileIndex ] + movementCost );
+
+			if( totalCost <= movementRange && totalCost < mCostToEnter[ adjacentIndex ] )
+			{
+				mCostToEnter[ adjacentIndex ] = totalCost;
+				mOpenTiles.push_back( adjacentIndex );
+			}
+		}
+	}
+
+	for( size_t tileIndex = 0, tileCount = mCostToEnter.size(); tileIndex < tileCount; ++tileIndex )
+	{
+		if( mCostToEnter[ tileIndex ] != Mathi::MAX_REAL && ( mTileUnits[ tileIndex ] == NO_UNIT || (int) tileIndex == originIndex ) )
+		{
+			// Units can only stop in empty tiles (or stay where they are).
+			mReachableTiles.push_back( (int) tileIndex );
+		}
+	}
+}
@@ -0,0 +1,277 @@
+#pragma once
+
+namespace mage
+{
+	/**
+	 * Immutable tables describing the rules of a Map, flattened for fast lookups during AI rollouts.
+	 *
+	 * The tables are built once on the main thread and then shared (read-only) by every AISimulation,
+	 * so worker threads never have to touch the Map or the Scenario while they search.
+	 */
+	class AIRules
+	{
+	public:
+		static const int IMPASSABLE = -1;
+
+		AIRules();
+		~AIRules();
+
+		void Build( Map* map );
+		void Clear();
+
+		int GetUnitTypeIndex( const UnitType* unitType ) const;
+		size_t GetUnitTypeCount() const;
+
+		short GetWidth() const;
+		short GetHeight() const;
+		size_t GetTileCount() const;
+		int GetTileIndex( const Vec2s& tilePos ) const;
+		bool IsValidTilePos( const Vec2s& tilePos ) const;
+
+		int GetMovementCost( int unitTypeIndex, int tileIndex ) const;
+		int GetMovementRange( int unitTypeIndex ) const;
+		const IntRange& GetAttackRange( int unitTypeIndex ) const;
+		int GetBaseDamagePercentage( int attackerTypeIndex, int targetTypeIndex, bool hasAmmo ) const;
+		int GetAmmoPerShot( int attackerTypeIndex, int targetTypeIndex ) const;
+
+		int GetCoverBonus( int tileIndex ) const;
+		int GetIncome( int tileIndex ) const;
+		bool IsCapturable( int tileIndex ) const;
+		int GetCaptureDistance( int factionIndex, int unitTypeIndex, int tileIndex ) const;
+
+	private:
+		/**
+		 * Best damage one UnitType can deal to another, with and without spending ammo.
+		 */
+		struct DamageEntry
+		{
+			int AmmoDamagePercentage;
+			int AmmoPerShot;
+			int FreeDamagePercentage;
+		};
+
+		struct UnitTypeEntry
+		{
+			const UnitType* Type;
+			int MovementRange;
+			IntRange AttackRange;
+		};
+
+		struct TileEntry
+		{
+			int CoverBonus;
+			int Income;
+			bool IsCapturable;
+		};
+
+		short mWidth;
+		short mHeight;
+		std::vector< UnitTypeEntry > mUnitTypes;
+		std::vector< TileEntry > mTiles;
+		std::vector< int > mMovementCosts;
+		std::vector< DamageEntry > mDamage;
+		size_t mFactionCount;
+		std::vector< int > mCaptureDistances;
+	};
+
+
+	/**
+	 * A compact, self-contained copy of the game state that the AI can play forward without touching the Map.
+	 *
+	 * Each AISimulation has its own random number generator and scratch buffers, so any number of them can
+	 * be played out concurrently on different threads as long as they share the same AIRules.
+	 */
+	class AISimulation
+	{
+	public:
+		static const int NO_OWNER = -1;
+		static const int NO_UNIT = -1;
+
+		/**
+		 * Simulated state of a single Unit.
+		 */
+		struct SimUnit
+		{
+			int UnitID;
+			int UnitTypeIndex;
+			int FactionIndex;
+			Vec2s TilePos;
+			int Health;
+			int Ammo;
+			bool IsActive;
+		};
+
+		typedef std::vector< SimUnit > Units;
+
+		AISimulation();
+		~AISimulation();
+
+		void LoadFromMap( const Map* map, const AIRules* rules, const Faction* currentFaction );
+		void CopyStateFrom( const AISimulation& other );
+
+		void SetRandomSeed( unsigned long seed );
+		int RandomInRange( int min, int max );
+
+		int FindUnitIndexByID( int unitID ) const;
+		void MoveUnit( int unitIndex, const Vec2s& destination );
+		void DeactivateUnit( int unitIndex );
+		void Attack( int attackerIndex, int targetIndex );
+		void Capture( int unitIndex );
+		void EndTurn();
+		int PlayOut( int turnCount );
+
+		const AIRules* GetRules() const;
+		const Units& GetUnits() const;
+		int GetFactionCount() const;
+		int GetCurrentFactionIndex() const;
+		int GetTileOwner( int tileIndex ) const;
+		int GetUnitIndexAt( int tileIndex ) const;
+		bool IsFactionDefeated( int factionIndex ) const;
+
+	private:
+		int ResolveAttack( int attackerIndex, int targetIndex );
+		int PlayUnit( int unitIndex );
+		void FindReachableTiles( int unitIndex );
+
+		const AIRules* mRules;
+		int mFactionCount;
+		int mCurrentFactionIndex;
+		RNGStream mRandom;
+		Units mUnits;
+		std::vector< int > mTileOwners;
+		std::vector< int > mTileUnits;
+
+		// Scratch buffers (not part of the simulated state).
+		std::vector< int > mCostToEnter;
+		std::vector< int > mOpenTiles;
+		std::vector< int > mReachableTiles;
+	};
+
+
+	inline size_t AIRules::GetUnitTypeCount() const
+	{
+		return mUnitTypes.size();
+	}
+
+
+	inline short AIRules::GetWidth() const
+	{
+		return mWidth;
+	}
+
+
+	inline short AIRules::GetHeight() const
+	{
+		return mHeight;
+	}
+
+
+	inline size_t AIRules::GetTileCount() const
+	{
+		return mTiles.size();
+	}
+
+
+	inline int AIRules::GetTileIndex( const Vec2s& tilePos ) const
+	{
+		return ( tilePos.y * mWidth + tilePos.x );
+	}
+
+
+	inline bool AIRules::IsValidTilePos( const Vec2s& tilePos ) const
+	{
+		return ( tilePos.x >= 0 && tilePos.y >= 0 && tilePos.x < mWidth && tilePos.y < mHeight );
+	}
+
+
+	inline int AIRules::GetMovementCost( int unitTypeIndex, int tileIndex ) const
+	{
+		return mMovementCosts[ unitTypeIndex * mTiles.size() + tileIndex ];
+	}
+
+
+	inline int AIRules::GetMovementRange( int unitTypeIndex ) const
+	{
+		return mUnitTypes[ unitTypeIndex ].MovementRange;
+	}
+
+
+	inline const IntRange& AIRules::GetAttackRange( int unitTypeIndex ) const
+	{
+		return mUnitTypes[ unitTypeIndex ].AttackRange;
+	}
+
+
+	inline int AIRules::GetBaseDamagePercentage( int attackerTypeIndex, int targetTypeIndex, bool hasAmmo ) const
+	{
+		const DamageEntry& entry = mDamage[ attackerTypeIndex * mUnitTypes.size() + targetTypeIndex ];
+		return ( hasAmmo ? std::max( entry.AmmoDamagePercentage, entry.FreeDamagePercentage ) : entry.FreeDamagePercentage );
+	}
+
+
+	inline int AIRules::GetCoverBonus( int tileIndex ) const
+	{
+		return mTiles[ tileIndex ].CoverBonus;
+	}
+
+
+	inline int AIRules::GetIncome( int tileIndex ) const
+	{
+		return mTiles[ tileIndex ].Income;
+	}
+
+
+	inline bool AIRules::IsCapturable( int tileIndex ) const
+	{
+		return mTiles[ tileIndex ].IsCapturable;
+	}
+
+
+	inline int AIRules::GetCaptureDistance( int factionIndex, int unitTypeIndex, int tileIndex ) const
+	{
+		int result = DistanceField::UNREACHABLE;
+
+		if( factionIndex >= 0 && factionIndex < (int) mFactionCount )
+		{
+			result = mCaptureDistances[ ( factionIndex * mUnitTypes.size() + unitTypeIndex ) * mTiles.size() + tileIndex ];
+		}
+
+		return result;
+	}
+
+
+	inline const AIRules* AISimulation::GetRules() const
+	{
+		return mRules;
+	}
+
+
+	inline const AISimulation::Units& AISimulation::GetUnits() const
+	{
+		return mUnits;
+	}
+
+
+	inline int AISimulation::GetFactionCount() const
+	{
+		return mFactionCount;
+	}
+
+
+	inline int AISimulation::GetCurrentFactionIndex() const
+	{
+		return mCurrentFactionIndex;
+	}
+
+
+	inline int AISimulation::GetTileOwner( int tileIndex ) const
+	{
+		return mTileOwners[ tileIndex ];
+	}
+
+
+	inline int AISimulation::GetUnitIndexAt( int tileIndex ) const
+	{
+		return mTileUnits[ tileIndex ];
+	}
+}
@@ -6,7 +6,7 @@ namespace mage
 	class UnitSprite;
 
 
-	class MapAnimation
+	class MapAnimation : public PoolAllocated< MapAnimation >
 	{
 	protected:
 		MapAnimation();
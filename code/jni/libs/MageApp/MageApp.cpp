@@ -24,6 +24,30 @@ namespace mage
 	};
 	static Engine gApp;
 
+	// Frame scheduling
+	static const float DEFAULT_MAX_FRAME_RATE = 60.0f;
+	static const double FRAME_STATS_INTERVAL = 10.0;
+	static const double MAX_FRAME_TIME = 0.25;		// Longest hitch that gets simulated in full
+	static const double HITCH_FRAME_TIME = 1.0 / 30.0;	// Frames that take longer than this are counted as hitches
+
+	struct FrameScheduler
+	{
+		float MaxFrameRate;
+		bool IsFrameRequested;		// Run a frame as soon as the frame rate allows
+		double NextFrameTime;		// Earliest time the next frame may start
+		double WakeTime;			// Time the app asked to run its next frame, negative to wait for RequestFrame()
+		double IdleTime;			// How long the last frame said the app could sleep
+		double LastFrameTime;		// Start of the last frame
+		double UpdateTime;			// Time waiting to be simulated in fixed steps
+		float FrameInterpolation;	// How far the frame being drawn is between the last two fixed steps
+		double IntervalStartTime;
+		double IntervalBusyTime;
+		double IntervalFocusedTime;
+		uint32 IntervalFramesRun;
+		FrameSchedulerStats Stats;
+	};
+	static FrameScheduler gScheduler;
+
 	// Touch stuff
 	static const float POINTER_INITIAL_MOTION_TOLERANCE = 10.0f;
 	static const float POINTER_MOTION_TOLERANCE = 10.0f;
@@ -45,6 +69,7 @@ namespace mage
 	static OnFocusLostFn gOnFocusLostFn = 0;
 	static OnFocusGainedFn gOnFocusGainedFn = 0;
 	static OnVolumeChangedFn gOnVolumeChangedFn = 0;
+	static GetIdleTimeFn gGetIdleTimeFn = DefaultGetIdleTimeFn;
 
 	static Vec2f getPointerPositionFromEvent( const AInputEvent* event, size_t pointerIndex );
 	static int getPointerIDFromEvent( const AInputEvent* event, size_t pointerIndex );
@@ -59,6 +84,13 @@ namespace mage
 
 	static void OnDraw();
 
+	static void initFrameScheduler();
+	static void restartFrameClock();
+	static bool isFrameDue( double now );
+	static int getPollTimeout( double now );
+	static void runFrame( float dt );
+	static void updateFrameSchedulerStats( double now, double elapsed );
+
     static void InitGraphics();
 	static void ShutdownGraphics();
 
@@ -85,6 +117,12 @@ namespace mage
         
         DebugPrintf( "Creating clock\n" );
 		gApp.AppClock = &Clock::Initialize();
+		ProfilingSystem::Initialize();
+		ProfilingSystem::TrackFrameTimes( "Frame", HITCH_FRAME_TIME );
+		ProfilingSystem::TrackFrameTimes( "Update", HITCH_FRAME_TIME );
+		ProfilingSystem::TrackFrameTimes( "Render", HITCH_FRAME_TIME );
+
+		initFrameScheduler();
 
 		DebugPrintf( "Registering asset manager\n" );
 		InitializeAssetManager( app->activity->assetManager );
@@ -118,13 +156,21 @@ namespace mage
         int events;
         struct android_poll_source* source;
 
+		double lastTime = Clock::QueryTime( Clock::TIME_SEC );
+
 		while( gApp.IsRunning )
 		{
 			// Reset the velocity of each Pointer.
 			resetPointers();
 
-			while( (ident = ALooper_pollAll( gApp.HasFocus ? 0 : -1, NULL, &events, (void**)&source ) ) >= 0 )
+			// Sleep until the next frame is due or an event arrives
+			int timeout = getPollTimeout( lastTime );
+
+			while( (ident = ALooper_pollAll( timeout, NULL, &events, (void**)&source ) ) >= 0 )
 			{
+				// Only wait for the first event, then drain the rest
+				timeout = 0;
+
 				// Process this event.
 				if( source != NULL )
 					source->process( gApp.app, source );
@@ -140,21 +186,182 @@ namespace mage
 				}
 			}
             
-			// Only do stuff if not paused
-			if ( gApp.HasFocus )
+			double now = Clock::QueryTime( Clock::TIME_SEC );
+			double elapsed = now - lastTime;
+
+			// Only do stuff if not paused and something needs a frame
+			if ( gApp.HasFocus && isFrameDue( now ) )
 			{
-				gApp.AppClock->AdvanceTime( dt );
-				gUpdateFn( dt );
-				gRenderFn();
-                FlushRenderer();
-                SwapBuffers();
+				runFrame( dt );
 			}
+
+			lastTime = now;
+			updateFrameSchedulerStats( now, elapsed );
 		}
         
         gOnDestroyFn();
 		DestroyRenderer();
 	}
 	//---------------------------------------
+	static void initFrameScheduler()
+	{
+		double now = Clock::QueryTime( Clock::TIME_SEC );
+
+		memset( &gScheduler, 0, sizeof( gScheduler ) );
+		gScheduler.MaxFrameRate = DEFAULT_MAX_FRAME_RATE;
+		gScheduler.IsFrameRequested = true;
+		gScheduler.NextFrameTime = now;
+		gScheduler.WakeTime = -1.0;
+		gScheduler.IdleTime = -1.0;
+		gScheduler.LastFrameTime = now;
+		gScheduler.IntervalStartTime = now;
+	}
+	//---------------------------------------
+	// Time frames from now on, so the time spent out of focus isn't simulated when the app comes back
+	static void restartFrameClock()
+	{
+		gScheduler.LastFrameTime = Clock::QueryTime( Clock::TIME_SEC );
+		gScheduler.UpdateTime = 0.0;
+		gScheduler.IsFrameRequested = true;
+	}
+	//---------------------------------------
+	static bool isFrameDue( double now )
+	{
+		bool isWanted = gScheduler.IsFrameRequested || ( gScheduler.WakeTime >= 0.0 && now >= gScheduler.WakeTime );
+		return isWanted && now >= gScheduler.NextFrameTime;
+	}
+	//---------------------------------------
+	static int getPollTimeout( double now )
+	{
+		// Nothing to do until the app is back in focus
+		if ( !gApp.HasFocus )
+			return -1;
+
+		double targetTime;
+		if ( gScheduler.IsFrameRequested )
+			targetTime = gScheduler.NextFrameTime;
+		else if ( gScheduler.WakeTime >= 0.0 )
+			targetTime = std::max( gScheduler.WakeTime, gScheduler.NextFrameTime );
+		else
+			return -1;
+
+		// Round up so we don't wake just before the deadline and spin
+		double delay = targetTime - now;
+		return delay > 0.0 ? (int) std::ceil( delay * 1000.0 ) : 0;
+	}
+	//---------------------------------------
+	static void runFrame( float dt )
+	{
+		double frameStartTime = Clock::QueryTime( Clock::TIME_SEC );
+
+		BeginProfilingSection( Frame )
+
+		// Anything that needs another frame will ask for it while this one runs
+		gScheduler.IsFrameRequested = false;
+		gScheduler.WakeTime = -1.0;
+
+		// Simulate the time since the last frame in fixed steps, so the simulation doesn't depend on the frame rate.
+		// A long hitch is clamped so it can't snowball, but time the app slept through on purpose is simulated in full.
+		// After sleeping until RequestFrame() nothing was waiting to be simulated, so only run a single step.
+		double maxFrameTime = MAX_FRAME_TIME + std::max( gScheduler.IdleTime, 0.0 );
+		double frameTime = ( gScheduler.IdleTime < 0.0 ) ? dt : std::min( frameStartTime - gScheduler.LastFrameTime, maxFrameTime );
+		gScheduler.LastFrameTime = frameStartTime;
+		gScheduler.UpdateTime += frameTime;
+
+		BeginProfilingSection( Update )
+		while ( gScheduler.UpdateTime >= dt )
+		{
+			gApp.AppClock->AdvanceTime( dt );
+			gUpdateFn( dt );
+			gScheduler.UpdateTime -= dt;
+		}
+		EndProfilingSection( Update )
+
+		// Draw between the last two steps with whatever time is left over
+		gScheduler.FrameInterpolation = (float) ( gScheduler.UpdateTime / dt );
+		BeginProfilingSection( Render )
+		gRenderFn();
+		FlushRenderer();
+		SwapBuffers();
+		EndProfilingSection( Render )
+
+		// Find out when the app needs to run again
+		float idleTime = gGetIdleTimeFn();
+
+		// Keep running while jobs are queued, so whatever is waiting on them sees them finish
+		if ( JobManager::HasInstance() && JobManager::GetInstance()->GetPendingJobCount() > 0 )
+			idleTime = 0.0f;
+		gScheduler.IdleTime = idleTime;
+		if ( idleTime == 0.0f )
+			gScheduler.IsFrameRequested = true;
+		else if ( idleTime > 0.0f )
+			gScheduler.WakeTime = frameStartTime + idleTime;
+
+		// Cap the frame rate
+		gScheduler.NextFrameTime = frameStartTime;
+		if ( gScheduler.MaxFrameRate > 0.0f )
+			gScheduler.NextFrameTime += 1.0 / gScheduler.MaxFrameRate;
+
+		EndProfilingSection( Frame )
+
+		// Release transient memory from the frame before last and reset the per-frame profiling data
+		FrameMemory::EndFrame();
+		ProfilingSystem::EndFrame();
+
+		gScheduler.IntervalBusyTime += Clock::QueryTime( Clock::TIME_SEC ) - frameStartTime;
+		++gScheduler.IntervalFramesRun;
+	}
+	//---------------------------------------
+	static void updateFrameSchedulerStats( double now, double elapsed )
+	{
+		if ( gApp.HasFocus )
+			gScheduler.IntervalFocusedTime += elapsed;
+
+		double intervalTime = now - gScheduler.IntervalStartTime;
+		if ( intervalTime < FRAME_STATS_INTERVAL )
+			return;
+
+		FrameSchedulerStats& stats = gScheduler.Stats;
+		stats.FramesRun = gScheduler.IntervalFramesRun;
+		stats.DutyCycle = (float) ( gScheduler.IntervalBusyTime / intervalTime );
+
+		// Compare against the frames a capped loop would have run while in focus
+		uint32 possibleFrames = (uint32) ( gScheduler.IntervalFocusedTime * gScheduler.MaxFrameRate );
+		stats.FramesSkipped = possibleFrames > stats.FramesRun ? possibleFrames - stats.FramesRun : 0;
+
+		DebugPrintf( "Frames: %u run, %u skipped, %.1f%% duty cycle\n", stats.FramesRun, stats.FramesSkipped, stats.DutyCycle * 100.0f );
+
+		gScheduler.IntervalStartTime = now;
+		gScheduler.IntervalBusyTime = 0.0;
+		gScheduler.IntervalFocusedTime = 0.0;
+		gScheduler.IntervalFramesRun = 0;
+	}
+	//---------------------------------------
+	void RequestFrame()
+	{
+		gScheduler.IsFrameRequested = true;
+	}
+	//---------------------------------------
+	void SetMaxFrameRate( float framesPerSecond )
+	{
+		gScheduler.MaxFrameRate = std::max( framesPerSecond, 0.0f );
+	}
+	//---------------------------------------
+	float GetMaxFrameRate()
+	{
+		return gScheduler.MaxFrameRate;
+	}
+	//---------------------------------------
+	float GetFrameInterpolation()
+	{
+		return gScheduler.FrameInterpolation;
+	}
+	//---------------------------------------
+	const FrameSchedulerStats& GetFrameSchedulerStats()
+	{
+		return gScheduler.Stats;
+	}
+	//---------------------------------------
 	void ExitApp()
 	{
 		ANativeActivity_finish( gApp.app->activity );
@@ -187,6 +394,11 @@ namespace mage
 	void DefaultOnWindowShownFn()
 	{}
 	//---------------------------------------
+	float DefaultGetIdleTimeFn()
+	{
+		return 0.0f;
+	}
+	//---------------------------------------
 	// Callback registers
 	//---------------------------------------
 	void RegisterUpdateFn( UpdateFn fn )
@@ -254,6 +466,11 @@ namespace mage
 		gOnVolumeChangedFn = fn;
 	}
 	//---------------------------------------
+	void RegisterGetIdleTimeFn( GetIdleTimeFn fn )
+	{
+		gGetIdleTimeFn = fn;
+	}
+	//---------------------------------------
 	// Input handling
 	//---------------------------------------
 	Pointer::Pointer() :
@@ -435,6 +652,9 @@ namespace mage
 	{
 		Engine* engine = (Engine*) app->userData;
 
+		// Redraw after any change to the app or window
+		RequestFrame();
+
 		switch( cmd )
 		{
 			case APP_CMD_SAVE_STATE:
@@ -480,6 +700,7 @@ namespace mage
 			{
 				DebugPrintf( "Focus gained...\n" );
 				engine->HasFocus = true;
+				restartFrameClock();
 
 				// User callback
 				gOnFocusGainedFn();
@@ -513,6 +734,7 @@ namespace mage
 			{
 				DebugPrintf( "Resuming Activity...\n" );
 				engine->IsPaused = false;
+				restartFrameClock();
 			}
 			break;
             
@@ -556,6 +778,9 @@ namespace mage
 
 		Engine* engine = (Engine*) app->userData;
 
+		// Input always gets a frame to respond in
+		RequestFrame();
+
 		int sourceId = AInputEvent_getSource( pEvent );
 		bool wasHandled = false;
 
@@ -52,6 +52,15 @@ namespace mage
 	typedef void(*OnFocusLostFn)( void );
 	typedef void(*OnFocusGainedFn)( void );
 	typedef void(*OnVolumeChangedFn)( float volume );
+	typedef float(*GetIdleTimeFn)( void );
+
+	// Counters for the frame scheduler over the last reporting interval
+	struct FrameSchedulerStats
+	{
+		uint32 FramesRun;			// Frames that were updated and drawn
+		uint32 FramesSkipped;		// Frames that could have run at the max frame rate but weren't needed
+		float DutyCycle;			// Fraction of the time spent running frames instead of sleeping
+	};
 
 
 	// Initialize the app - do this before calling Run(). If a savestate exists, you will get that callback before this function returns.
@@ -70,10 +79,11 @@ namespace mage
 	void DefaultOnDestroyFn();
 	void DefaultOnScreenSizeChangedFn( int32 w, int32 h );
 	void DefaultOnWindowShownFn();
+	float DefaultGetIdleTimeFn();
 
-	// UpdateFn is passed a fixed timestep
+	// UpdateFn is passed a fixed timestep, and is called as many times as needed to catch up to real time
 	void RegisterUpdateFn( UpdateFn fn );
-	// RenderFn is call after UpdateFn
+	// RenderFn is called once per frame, after all UpdateFn calls for the frame
 	void RegisterRenderFn( RenderFn fn );
 	// When the application state is restored OnSaveStateRestoredFn is called with the saved data
 	void RegisterOnSaveStateRestoredFn( OnSaveStateRestoredFn fn );
@@ -89,4 +99,19 @@ namespace mage
 	void RegisterOnFocusLostFn( OnFocusLostFn fn );
 	void RegisterOnFocusGainedFn( OnFocusGainedFn fn );
 	void RegisterOnVolumeChangedFn( OnVolumeChangedFn fn );
+	// GetIdleTimeFn is called after every frame and returns how many seconds the app can sleep before it needs another frame.
+	// Return 0 to keep running frames, or a negative value to sleep until something calls RequestFrame().
+	// The default keeps running frames. Frames also keep running while the JobManager has jobs queued.
+	void RegisterGetIdleTimeFn( GetIdleTimeFn fn );
+
+	// Frame scheduling
+	// Wake the app and run a frame as soon as the frame rate allows. Input and app events do this automatically.
+	void RequestFrame();
+	// Limit how often frames run while the app is busy (0 for no limit)
+	void SetMaxFrameRate( float framesPerSecond );
+	float GetMaxFrameRate();
+	// How far (0-1) the frame being drawn is from the last fixed update to the next one.
+	// Use it to interpolate anything that moves during updates, so motion stays smooth at any frame rate.
+	float GetFrameInterpolation();
+	const FrameSchedulerStats& GetFrameSchedulerStats();
 }
@@ -19,7 +19,14 @@ magecore_sources := \
  ./IO/FileSystem.cpp \
  ./IO/Resource.cpp \
  ./Threads/Mutex_Unix.cpp \
+ ./Threads/Thread_Unix.cpp \
+ ./Threads/Semaphore_Unix.cpp \
+ ./Threads/Job.cpp \
+ ./Threads/JobManager.cpp \
+ ./Threads/Task.cpp \
+ ./Threads/JobBenchmark.cpp \
  ./DataStructures/HashString.cpp \
+ ./DataStructures/ObjectPool.cpp \
  ./DataStructures/Dictionary.cpp \
  ./Util/StringUtil.cpp \
  ./Util/HashUtil.cpp \
@@ -29,6 +36,12 @@ magecore_sources := \
  ./Assertion.cpp \
  ./Color.cpp \
  ./Clock.cpp \
+ ./ProfilingSystem.cpp \
+ ./FrameTimeHistogram.cpp \
+ ./FrameArena.cpp \
+ ./MageMemory.cpp \
+ ./MemoryBenchmark.cpp \
+ ./HashMapBenchmark.cpp \
  ./Object.cpp \
  ./RTTI.cpp \
 
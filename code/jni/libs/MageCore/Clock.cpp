@@ -139,6 +139,8 @@ Clock::Clock()
 	, mTimeScale( 1.0 )
 	, mIsPaused( false )
 	, mParent( nullptr )
+	, mNextEventSequence( 0 )
+	, mIsFiringEvents( false )
 {
 #ifdef WIN32
 	mClockPDI = new ClockWin32();
@@ -186,29 +188,37 @@ void Clock::AdvanceTime( double deltaSeconds )
 	mDeltaSeconds = deltaSeconds * mTimeScale;
 	mElapsedSeconds += mDeltaSeconds;
 
-	// Check for events that need fired
-	// Note: Cannot use iterators since container may be modified during an event callback.
-	int numEvents = mTimeEvents.size();
-	//for ( auto itr = mTimeEvents.begin(); itr != mTimeEvents.end(); ++itr )
-	for ( int i = 0; i < numEvents; ++i )
+	// Fire the events that are due, cheapest first so nothing is done when none are
+	mIsFiringEvents = true;
+	while ( !mScheduledEvents.empty() && mScheduledEvents.front().TimeToFireSeconds <= mElapsedSeconds )
 	{
-		if ( mTimeEvents[i].TimeToFireSeconds <= mElapsedSeconds )
-		{
-			EventManager::FireEvent( mTimeEvents[i].EventName, mTimeEvents[i].params );
-		}
-		// Since events are sorted by time, no other events will fire
-		else	
-		{
-			break;
-		}
+		std::pop_heap( mScheduledEvents.begin(), mScheduledEvents.end(), ScheduledEvent::FiresAfter );
+		PostedEvent* event = mScheduledEvents.back().Event;
+		mScheduledEvents.pop_back();
+
+		// Take the event out of the pool before firing, the callback may post or clear events
+		HashString eventName = event->EventName;
+		Dictionary params;
+		params.Swap( event->Params );
+		mPostedEvents.Destroy( event );
+
+		EventManager::FireEvent( eventName, params );
+	}
+	mIsFiringEvents = false;
+
+	// Schedule the events posted by the callbacks
+	for ( std::vector< ScheduledEvent >::iterator itr = mDeferredEvents.begin(); itr != mDeferredEvents.end(); ++itr )
+	{
+		mScheduledEvents.push_back( *itr );
+		std::push_heap( mScheduledEvents.begin(), mScheduledEvents.end(), ScheduledEvent::FiresAfter );
 	}
+	mDeferredEvents.clear();
 
-	// Remove fired events
-    mTimeEvents.erase( std::remove_if( mTimeEvents.begin(), mTimeEvents.end(),
-		[&]( const ClockTimeEventCallback& ev ) -> bool
+	// Restart the sequence whenever nothing is pending so it never wraps
+	if ( mScheduledEvents.empty() )
 	{
-		return ev.TimeToFireSeconds <= mElapsedSeconds;
-	}), mTimeEvents.end() );
+		mNextEventSequence = 0;
+	}
 
 	// Advance children
 	for ( std::vector< Clock* >::iterator clockItr = mChildren.begin(); clockItr != mChildren.end(); ++clockItr )
@@ -219,7 +229,14 @@ void Clock::AdvanceTime( double deltaSeconds )
 //---------------------------------------
 void Clock::ClearAllPostedEvents()
 {
-	mTimeEvents.clear();
+	mScheduledEvents.clear();
+	mDeferredEvents.clear();
+	mPostedEvents.DestroyAll();
+}
+//---------------------------------------
+uint32 Clock::GetPostedEventCount() const
+{
+	return mScheduledEvents.size() + mDeferredEvents.size();
 }
 //---------------------------------------
 void Clock::SetMaxDeltaSeconds( double deltaSeconds )
@@ -232,18 +249,45 @@ void Clock::SetTime( double timeSeconds )
 	mElapsedSeconds = timeSeconds;
 }
 //---------------------------------------
-void Clock::PostEventCallbackAt( const std::string& eventName, double timeToFireSecods, const Dictionary& params )
+void Clock::PostEventCallbackAt( const HashString& eventName, double timeToFireSeconds, const Dictionary& params )
 {
-	ClockTimeEventCallback ctec = { eventName, timeToFireSecods, params };
-	mTimeEvents.push_back( ctec );
-	std::sort( mTimeEvents.begin(), mTimeEvents.end() );
+	PostedEvent* event = mPostedEvents.Create( eventName );
+	event->Params = params;
+	SchedulePostedEvent( event, timeToFireSeconds );
 }
 //---------------------------------------
-void Clock::PostEventCallbackAfter( const std::string& eventName, double delaySeconds, const Dictionary& params )
+void Clock::PostEventCallbackAfter( const HashString& eventName, double delaySeconds, const Dictionary& params )
 {
 	PostEventCallbackAt( eventName, mElapsedSeconds + delaySeconds, params );
 }
 //---------------------------------------
+void Clock::PostEventCallbackAt( const HashString& eventName, double timeToFireSeconds, Dictionary&& params )
+{
+	PostedEvent* event = mPostedEvents.Create( eventName );
+	event->Params.Swap( params );
+	SchedulePostedEvent( event, timeToFireSeconds );
+}
+//---------------------------------------
+void Clock::PostEventCallbackAfter( const HashString& eventName, double delaySeconds, Dictionary&& params )
+{
+	PostEventCallbackAt( eventName, mElapsedSeconds + delaySeconds, static_cast< Dictionary&& >( params ) );
+}
+//---------------------------------------
+void Clock::SchedulePostedEvent( PostedEvent* event, double timeToFireSeconds )
+{
+	ScheduledEvent scheduled = { timeToFireSeconds, mNextEventSequence++, event };
+
+	if ( mIsFiringEvents )
+	{
+		mDeferredEvents.push_back( scheduled );
+	}
+	else
+	{
+		mScheduledEvents.push_back( scheduled );
+		std::push_heap( mScheduledEvents.begin(), mScheduledEvents.end(), ScheduledEvent::FiresAfter );
+	}
+}
+//---------------------------------------
 void Clock::BeginTimeQuery()
 {
 	mClockPDI->BeginTimeQuery();
@@ -46,9 +46,16 @@ namespace mage
 		void Pause();
 		void Resume();
 
-		void PostEventCallbackAt( const std::string& eventName, double timeToFireSecods, const Dictionary& params=Dictionary() );
-		void PostEventCallbackAfter( const std::string& eventName, double delaySeconds, const Dictionary& params=Dictionary() );
+		// Fire eventName through the EventManager once this clock reaches the given time
+		// Events due on the same advance fire in time order, and in the order they were posted for equal times
+		// Events posted from inside a callback fire on a later advance at the earliest
+		void PostEventCallbackAt( const HashString& eventName, double timeToFireSeconds, const Dictionary& params=Dictionary() );
+		void PostEventCallbackAfter( const HashString& eventName, double delaySeconds, const Dictionary& params=Dictionary() );
+		// Take the contents of params instead of copying them
+		void PostEventCallbackAt( const HashString& eventName, double timeToFireSeconds, Dictionary&& params );
+		void PostEventCallbackAfter( const HashString& eventName, double delaySeconds, Dictionary&& params );
 		void ClearAllPostedEvents();
+		uint32 GetPostedEventCount() const;
 
 		static double GetFormatedTime( TimeFormat timeFormat, double seconds );
 		// Returns time in hh:mm.ss.mmm
@@ -64,19 +71,41 @@ namespace mage
 		Clock* mParent;
 		std::vector< Clock* > mChildren;
 
-		struct ClockTimeEventCallback
+		// Posted events are kept in a min-heap on fire time, so posting is O(log n) and an advance with
+		// nothing due only looks at the top. The heap holds small entries and the names and parameters
+		// stay put in a pool, so reordering the heap never copies a Dictionary.
+		struct PostedEvent
+		{
+			PostedEvent( const HashString& eventName )
+				: EventName( eventName )
+			{}
+
+			HashString EventName;
+			Dictionary Params;
+		};
+
+		struct ScheduledEvent
 		{
-			std::string EventName;
 			double TimeToFireSeconds;
-			Dictionary params;
+			uint32 Sequence;
+			PostedEvent* Event;
 
-			bool operator<( const ClockTimeEventCallback& other ) const
+			// Heap order, the event that fires first is at the top
+			static bool FiresAfter( const ScheduledEvent& a, const ScheduledEvent& b )
 			{
-				return TimeToFireSeconds < other.TimeToFireSeconds;
+				return a.TimeToFireSeconds > b.TimeToFireSeconds ||
+					( a.TimeToFireSeconds == b.TimeToFireSeconds && a.Sequence > b.Sequence );
 			}
 		};
-        
-		std::vector< ClockTimeEventCallback > mTimeEvents;
+
+		void SchedulePostedEvent( PostedEvent* event, double timeToFireSeconds );
+
+		std::vector< ScheduledEvent > mScheduledEvents;
+		// Posted while callbacks are being fired, added to the heap once they are done
+		std::vector< ScheduledEvent > mDeferredEvents;
+		ObjectPool< PostedEvent > mPostedEvents;
+		uint32 mNextEventSequence;
+		bool mIsFiringEvents;
 
 		static Clock* msMasterClock;
 		static const double DEFAULT_MAX_DELTA_SECONDS;
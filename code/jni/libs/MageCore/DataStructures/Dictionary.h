@@ -107,6 +107,12 @@ namespace mage
 			return *this;
 		}
 
+		// Exchange contents with other without copying any values
+		void Swap( Dictionary& other )
+		{
+			mDictionary.swap( other.mDictionary );
+		}
+
 		template< typename T >
 		void Set( const HashString& key, const T& value )
 		{
@@ -2,18 +2,416 @@
  * Author      : Matthew Johnson
  * Date        : 10/Oct/2013
  * Description :
- *   std::map<> with HashString as _Kty
+ *   Open addressing hash map with HashString as _Kty, with the parts of the std::map<> interface the engine uses.
  */
- 
+
 #pragma once
 
 namespace mage
 {
 
+	//---------------------------------------
+	// HashMap
+	// The table is a flat array of slots holding only each key's hash and a pointer to its entry. Collisions
+	// are resolved with Robin Hood linear probing, so a lookup reads a few neighbouring slots and only touches
+	// an entry once the hash matches. HashStrings are equal exactly when their hashes are, so the hash is the key.
+	// Entries are allocated one at a time and never move: like std::map, references and pointers to values stay
+	// good until the entry is erased, even while the table grows. Iterators are invalidated by insert and erase.
+	// Iteration order is unspecified.
+	//---------------------------------------
 	template< class _Ty >
 	class HashMap
-		: public std::map< HashString, _Ty >
 	{
+	public:
+		typedef HashString key_type;
+		typedef _Ty mapped_type;
+		typedef std::pair< const HashString, _Ty > value_type;
+		typedef uint32 size_type;
+
+	private:
+		struct Slot
+		{
+			uint32 Hash;
+			uint32 Distance;		// 1 + probes from the slot the hash wants, 0 for an empty slot
+			value_type* Entry;
+		};
+
+		static const uint32 MIN_CAPACITY = 8;
+
+		//---------------------------------------
+		template< typename ValueType >
+		class IteratorBase
+		{
+		public:
+			IteratorBase()
+				: mSlot( nullptr )
+				, mEnd( nullptr )
+			{}
+
+			IteratorBase( Slot* slot, Slot* end )
+				: mSlot( slot )
+				, mEnd( end )
+			{
+				SkipEmpty();
+			}
+
+			ValueType& operator*() const			{ return *mSlot->Entry; }
+			ValueType* operator->() const			{ return mSlot->Entry; }
+
+			IteratorBase& operator++()
+			{
+				++mSlot;
+				SkipEmpty();
+				return *this;
+			}
+
+			IteratorBase operator++( int )
+			{
+				IteratorBase old( *this );
+				++( *this );
+				return old;
+			}
+
+			template< typename OtherValueType >
+			bool operator==( const IteratorBase< OtherValueType >& other ) const	{ return mSlot == other.mSlot; }
+			template< typename OtherValueType >
+			bool operator!=( const IteratorBase< OtherValueType >& other ) const	{ return mSlot != other.mSlot; }
+
+			Slot* mSlot;
+			Slot* mEnd;
+
+		private:
+			void SkipEmpty()
+			{
+				while ( mSlot != mEnd && mSlot->Distance == 0 )
+				{
+					++mSlot;
+				}
+			}
+		};
+		//---------------------------------------
+
+	public:
+		//---------------------------------------
+		class const_iterator;
+
+		class iterator
+			: public IteratorBase< value_type >
+		{
+		public:
+			iterator() {}
+			iterator( Slot* slot, Slot* end )
+				: IteratorBase< value_type >( slot, end )
+			{}
+		};
+
+		class const_iterator
+			: public IteratorBase< const value_type >
+		{
+		public:
+			const_iterator() {}
+			const_iterator( Slot* slot, Slot* end )
+				: IteratorBase< const value_type >( slot, end )
+			{}
+			const_iterator( const iterator& other )
+				: IteratorBase< const value_type >( other.mSlot, other.mEnd )
+			{}
+		};
+		//---------------------------------------
+
+		HashMap()
+			: mSlots( nullptr )
+			, mCapacity( 0 )
+			, mSize( 0 )
+			, mShift( 32 )
+		{}
+
+		HashMap( const HashMap& other )
+			: mSlots( nullptr )
+			, mCapacity( 0 )
+			, mSize( 0 )
+			, mShift( 32 )
+		{
+			CopyFrom( other );
+		}
+
+		~HashMap()
+		{
+			clear();
+			delete[] mSlots;
+		}
+
+		HashMap& operator=( const HashMap& other )
+		{
+			if ( this != &other )
+			{
+				HashMap copy( other );
+				swap( copy );
+			}
+
+			return *this;
+		}
+
+		iterator begin()							{ return iterator( mSlots, mSlots + mCapacity ); }
+		iterator end()								{ return iterator( mSlots + mCapacity, mSlots + mCapacity ); }
+		const_iterator begin() const				{ return const_iterator( mSlots, mSlots + mCapacity ); }
+		const_iterator end() const					{ return const_iterator( mSlots + mCapacity, mSlots + mCapacity ); }
+
+		size_type size() const						{ return mSize; }
+		bool empty() const							{ return mSize == 0; }
+		size_type count( const HashString& key ) const		{ return ( FindSlot( key.GetHash() ) != nullptr ) ? 1 : 0; }
+
+		//---------------------------------------
+		iterator find( const HashString& key )
+		{
+			Slot* slot = FindSlot( key.GetHash() );
+			return slot ? iterator( slot, mSlots + mCapacity ) : end();
+		}
+		//---------------------------------------
+		const_iterator find( const HashString& key ) const
+		{
+			Slot* slot = FindSlot( key.GetHash() );
+			return slot ? const_iterator( slot, mSlots + mCapacity ) : end();
+		}
+		//---------------------------------------
+		_Ty& operator[]( const HashString& key )
+		{
+			Slot* slot = FindSlot( key.GetHash() );
+
+			if ( !slot )
+			{
+				slot = InsertEntry( new value_type( key, _Ty() ) );
+			}
+
+			return slot->Entry->second;
+		}
+		//---------------------------------------
+		// Returns the entry with the key and whether it was added, an existing value is left alone
+		std::pair< iterator, bool > insert( const value_type& value )
+		{
+			Slot* slot = FindSlot( value.first.GetHash() );
+			bool inserted = false;
+
+			if ( !slot )
+			{
+				slot = InsertEntry( new value_type( value ) );
+				inserted = true;
+			}
+
+			return std::make_pair( iterator( slot, mSlots + mCapacity ), inserted );
+		}
+		//---------------------------------------
+		void erase( iterator itr )
+		{
+			EraseSlot( itr.mSlot );
+		}
+		//---------------------------------------
+		size_type erase( const HashString& key )
+		{
+			Slot* slot = FindSlot( key.GetHash() );
+
+			if ( slot )
+			{
+				EraseSlot( slot );
+			}
+
+			return slot ? 1 : 0;
+		}
+		//---------------------------------------
+		// Keeps the table so the map can be refilled without growing again
+		void clear()
+		{
+			for ( uint32 i = 0; i < mCapacity; ++i )
+			{
+				if ( mSlots[ i ].Distance != 0 )
+				{
+					delete mSlots[ i ].Entry;
+					mSlots[ i ].Distance = 0;
+				}
+			}
+
+			mSize = 0;
+		}
+		//---------------------------------------
+		void swap( HashMap& other )
+		{
+			std::swap( mSlots, other.mSlots );
+			std::swap( mCapacity, other.mCapacity );
+			std::swap( mSize, other.mSize );
+			std::swap( mShift, other.mShift );
+		}
+		//---------------------------------------
+
+	private:
+		//---------------------------------------
+		// Fibonacci hashing spreads the hash over the table using its high bits
+		uint32 GetHomeIndex( uint32 hash ) const
+		{
+			return ( hash * 2654435769U ) >> mShift;
+		}
+		//---------------------------------------
+		Slot* FindSlot( uint32 hash ) const
+		{
+			Slot* found = nullptr;
+
+			if ( mSize > 0 )
+			{
+				uint32 mask = mCapacity - 1;
+				uint32 index = GetHomeIndex( hash );
+
+				// Entries are ordered by distance, so the key can't be past a slot closer to its home than it would be
+				for ( uint32 distance = 1; mSlots[ index ].Distance >= distance; ++distance )
+				{
+					if ( mSlots[ index ].Hash == hash )
+					{
+						found = mSlots + index;
+						break;
+					}
+
+					index = ( index + 1 ) & mask;
+				}
+			}
+
+			return found;
+		}
+		//---------------------------------------
+		// entry's key must not be in the map yet
+		Slot* InsertEntry( value_type* entry )
+		{
+			// Keep the load factor under 7/8
+			if ( ( mSize + 1 ) * 8 > mCapacity * 7 )
+			{
+				Rehash( std::max( mCapacity * 2, MIN_CAPACITY ) );
+			}
+
+			Slot* inserted = PlaceEntry( entry->first.GetHash(), entry );
+			++mSize;
+			return inserted;
+		}
+		//---------------------------------------
+		// Robin Hood insert: take the slot of any entry that is closer to its home, then carry that entry on
+		// Returns the slot the new entry ended up in
+		Slot* PlaceEntry( uint32 hash, value_type* entry )
+		{
+			uint32 mask = mCapacity - 1;
+			uint32 index = GetHomeIndex( hash );
+			Slot* inserted = nullptr;
+			Slot carried = { hash, 1, entry };
+
+			for ( ;; )
+			{
+				Slot& slot = mSlots[ index ];
+
+				if ( slot.Distance == 0 )
+				{
+					slot = carried;
+					break;
+				}
+
+				if ( slot.Distance < carried.Distance )
+				{
+					std::swap( slot, carried );
+					if ( !inserted )
+						inserted = &slot;
+				}
+
+				index = ( index + 1 ) & mask;
+				++carried.Distance;
+			}
+
+			return inserted ? inserted : mSlots + index;
+		}
+		//---------------------------------------
+		// Backward shift delete: pull the following entries one slot closer to home, so no tombstones are needed
+		void EraseSlot( Slot* slot )
+		{
+			uint32 mask = mCapacity - 1;
+			uint32 index = slot - mSlots;
+
+			delete slot->Entry;
+			--mSize;
+
+			for ( ;; )
+			{
+				uint32 next = ( index + 1 ) & mask;
+
+				if ( mSlots[ next ].Distance <= 1 )
+				{
+					mSlots[ index ].Distance = 0;
+					break;
+				}
+
+				mSlots[ index ] = mSlots[ next ];
+				--mSlots[ index ].Distance;
+				index = next;
+			}
+		}
+		//---------------------------------------
+		// capacity must be a power of two
+		void Rehash( uint32 capacity )
+		{
+			Slot* oldSlots = mSlots;
+			uint32 oldCapacity = mCapacity;
+
+			AllocateSlots( capacity );
+
+			for ( uint32 i = 0; i < oldCapacity; ++i )
+			{
+				if ( oldSlots[ i ].Distance != 0 )
+				{
+					PlaceEntry( oldSlots[ i ].Hash, oldSlots[ i ].Entry );
+				}
+			}
+
+			delete[] oldSlots;
+		}
+		//---------------------------------------
+		void AllocateSlots( uint32 capacity )
+		{
+			mSlots = new Slot[ capacity ];
+			mCapacity = capacity;
+			mShift = 32;
+
+			for ( uint32 i = 0; i < capacity; ++i )
+			{
+				mSlots[ i ].Distance = 0;
+			}
+
+			for ( uint32 i = capacity; i > 1; i >>= 1 )
+			{
+				--mShift;
+			}
+		}
+		//---------------------------------------
+		// Only called on an empty map, copies the table as it is so nothing has to be rehashed
+		void CopyFrom( const HashMap& other )
+		{
+			if ( other.mSize > 0 )
+			{
+				AllocateSlots( other.mCapacity );
+
+				for ( uint32 i = 0; i < mCapacity; ++i )
+				{
+					if ( other.mSlots[ i ].Distance != 0 )
+					{
+						mSlots[ i ] = other.mSlots[ i ];
+						mSlots[ i ].Entry = new value_type( *other.mSlots[ i ].Entry );
+					}
+				}
+
+				mSize = other.mSize;
+			}
+		}
+		//---------------------------------------
+
+		Slot* mSlots;
+		uint32 mCapacity;
+		uint32 mSize;
+		uint32 mShift;			// 32 - log2( mCapacity ), for GetHomeIndex()
 	};
 
-}
\ No newline at end of file
+	template< class _Ty >
+	const uint32 HashMap< _Ty >::MIN_CAPACITY;
+	//---------------------------------------
+
+}
@@ -2,14 +2,43 @@
 
 using namespace mage;
 
+typedef std::map< uint32, std::string > InternTable;
+
+//---------------------------------------
+// Hashes this thread already knows are interned, so constructing a HashString it has seen before
+// doesn't take the intern lock. Direct mapped, a hash that is pushed out is looked up again.
+struct SeenHash
+{
+	uint32 Hash;
+	bool IsSet;
+};
+static const uint32 SEEN_HASH_CACHE_BITS = 8;
+static THREAD_LOCAL SeenHash gSeenHashes[ 1 << SEEN_HASH_CACHE_BITS ];
+//---------------------------------------
+// Function statics so HashStrings built by static initializers in other files can use them
+static InternTable& GetInternTable()
+{
+	// Starts with the empty string so the default constructor doesn't have to intern it
+	static const InternTable::value_type EMPTY_ENTRY( HashStringCaseInsensitive( "" ), std::string() );
+	static InternTable table( &EMPTY_ENTRY, &EMPTY_ENTRY + 1 );
+	return table;
+}
 //---------------------------------------
-HashString::HashString()
-	: mHash( 0U )
-{}
+static Mutex& GetInternMutex()
+{
+	static Mutex mutex;
+	return mutex;
+}
 //---------------------------------------
-HashString::HashString( const char* str )
+static bool EqualsIgnoringCase( const char* A, const char* B )
 {
-	Set( str );
+	while ( *A && HashToLower( *A ) == HashToLower( *B ) )
+	{
+		++A;
+		++B;
+	}
+
+	return HashToLower( *A ) == HashToLower( *B );
 }
 //---------------------------------------
 HashString::HashString( const std::string& str )
@@ -17,17 +46,60 @@ HashString::HashString( const std::string& str )
 	Set( str.c_str() );
 }
 //---------------------------------------
-HashString::~HashString()
-{}
-//---------------------------------------
 int HashString::Compare( const HashString& A, const HashString& B )
 {
-	return A.mHash - B.mHash;
+	return ( A.mHash > B.mHash ) - ( A.mHash < B.mHash );
 }
 //---------------------------------------
 void HashString::Set( const char* str )
 {
-	mString = str;
-	mHash = GenerateHash( StringUtil::StringToLower( str ).c_str() );
+	mHash = GenerateHashCaseInsensitive( str );
+	Intern( mHash, str );
+}
+//---------------------------------------
+const std::string& HashString::GetString() const
+{
+	static const std::string EMPTY_STRING;
+	Mutex& internMutex = GetInternMutex();
+	CriticalBlock( internMutex );
+
+	// Table entries never move or change, so the reference stays good after unlocking
+	const InternTable& table = GetInternTable();
+	InternTable::const_iterator found = table.find( mHash );
+	return ( found != table.end() ) ? found->second : EMPTY_STRING;
+}
+//---------------------------------------
+uint32 HashString::GetInternedCount()
+{
+	Mutex& internMutex = GetInternMutex();
+	CriticalBlock( internMutex );
+	return GetInternTable().size();
+}
+//---------------------------------------
+void HashString::Intern( uint32 hash, const char* str )
+{
+	// Fibonacci hashing picks the cache slot from the high bits of the hash
+	SeenHash& seen = gSeenHashes[ ( hash * 2654435769U ) >> ( 32 - SEEN_HASH_CACHE_BITS ) ];
+
+	if ( !seen.IsSet || seen.Hash != hash )
+	{
+		Mutex& internMutex = GetInternMutex();
+		CriticalBlock( internMutex );
+
+		InternTable& table = GetInternTable();
+		InternTable::iterator found = table.find( hash );
+		if ( found == table.end() )
+		{
+			table.insert( std::make_pair( hash, std::string( str ) ) );
+		}
+		else
+		{
+			assertion( EqualsIgnoringCase( found->second.c_str(), str ), "HashString collision: \"%s\" and \"%s\" both hash to 0x%08x\n",
+				found->second.c_str(), str, hash );
+		}
+
+		seen.Hash = hash;
+		seen.IsSet = true;
+	}
 }
-//---------------------------------------
\ No newline at end of file
+//---------------------------------------
@@ -3,8 +3,9 @@
  * Date        : 10/Oct/2013
  * Description :
  *   A string hashed into an unsigned 32bit int. HashStrings are case insensitive.
+ *   A HashString is only its hash, the text is interned once in a global table the first time it is seen.
  */
- 
+
 #pragma once
 
 namespace mage
@@ -12,30 +13,61 @@ namespace mage
 
 	class HashString
 	{
+		// Lets the runtime constructor take C strings only
+		template< typename T > struct CStringOnly {};
+
 	public:
-		HashString();
-		HashString( const char* str );
+		// The empty string, which is always interned
+		HashString()
+			: mHash( HashStringCaseInsensitive( "" ) )
+		{}
+
+		// String literals are hashed with the constexpr hash so the compiler can do the work
+		template< size_t N >
+		HashString( const char (&str)[N] )
+			: mHash( HashStringCaseInsensitive( str ) )
+		{
+			Intern( mHash, str );
+		}
+
+		// Any other C string is hashed at run time
+		template< typename T >
+		HashString( T str, typename CStringOnly< T >::Type* =nullptr )
+		{
+			Set( str );
+		}
+
 		HashString( const std::string& str );
-		~HashString();
 
+		// -1, 0 or 1
 		static int Compare( const HashString& A, const HashString& B );
 
 		void Set( const char* str );
-		const std::string& GetString() const					{ return mString; }
-		const char* GetCString() const							{ return mString.c_str(); }
+		// The text of the first string interned with this hash, so it keeps the case it was first seen with
+		const std::string& GetString() const;
+		const char* GetCString() const							{ return GetString().c_str(); }
 		uint32 GetHash() const									{ return mHash; }
 
-		HashString& operator=( const HashString& other )		{ mHash = other.mHash; mString = other.mString; return *this; }
-		bool operator==( const HashString& other ) const		{ return Compare( *this, other ) == 0; }
-		bool operator!=( const HashString& other ) const		{ return !( *this == other ); }
-		bool operator< ( const HashString& other ) const		{ return Compare( *this, other ) < 0; }
-		bool operator<=( const HashString& other ) const		{ return Compare( *this, other ) <= 0; }
-		bool operator> ( const HashString& other ) const		{ return Compare( *this, other ) > 0; }
-		bool operator>=( const HashString& other ) const		{ return Compare( *this, other ) >= 0; }
+		bool operator==( const HashString& other ) const		{ return mHash == other.mHash; }
+		bool operator!=( const HashString& other ) const		{ return mHash != other.mHash; }
+		bool operator< ( const HashString& other ) const		{ return mHash <  other.mHash; }
+		bool operator<=( const HashString& other ) const		{ return mHash <= other.mHash; }
+		bool operator> ( const HashString& other ) const		{ return mHash >  other.mHash; }
+		bool operator>=( const HashString& other ) const		{ return mHash >= other.mHash; }
+
+		// Number of distinct strings interned so far
+		static uint32 GetInternedCount();
 
 	private:
+		// Add str to the intern table, asserts if a different string already has this hash
+		// Only takes the lock the first time the calling thread sees the hash, so a collision with a hash this
+		// thread has seen recently is not caught
+		static void Intern( uint32 hash, const char* str );
+
 		uint32 mHash;
-		std::string mString;
 	};
 
+	template<> struct HashString::CStringOnly< const char* > { typedef void Type; };
+	template<> struct HashString::CStringOnly< char* > { typedef void Type; };
+
 }
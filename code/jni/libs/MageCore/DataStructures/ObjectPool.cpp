@@ -0,0 +1,121 @@
+#include "CoreLib.h"
+
+using namespace mage;
+
+const uint32 FixedSizePool::DEFAULT_SLOTS_PER_BLOCK;
+const uint32 FixedSizePool::INVALID_INDEX;
+
+//---------------------------------------
+static size_t roundUp( size_t value, size_t alignment )
+{
+	return ( value + alignment - 1 ) & ~( alignment - 1 );
+}
+//---------------------------------------
+
+
+//---------------------------------------
+FixedSizePool::FixedSizePool( size_t slotSize, size_t alignment, uint32 slotsPerBlock )
+	: mSlotSize( slotSize )
+	, mSlotsPerBlock( slotsPerBlock )
+	, mFirstFree( INVALID_INDEX )
+{
+	// Keep the object after the header aligned
+	alignment = std::max( alignment, sizeof( void* ) );
+	mHeaderSize = roundUp( sizeof( SlotHeader ), alignment );
+	mStride = roundUp( mHeaderSize + slotSize, alignment );
+}
+//---------------------------------------
+FixedSizePool::~FixedSizePool()
+{
+	for ( std::vector< uint8* >::iterator itr = mBlocks.begin(); itr != mBlocks.end(); ++itr )
+	{
+		operator delete( *itr );
+	}
+}
+//---------------------------------------
+void* FixedSizePool::Acquire()
+{
+	if ( mFirstFree == INVALID_INDEX )
+	{
+		AddBlock();
+	}
+
+	SlotHeader* header = GetHeader( mFirstFree );
+	mFirstFree = header->NextFree;
+	header->NextFree = INVALID_INDEX;
+	header->IsLive = true;
+
+	// Stats
+	++mStats.LiveCount;
+	++mStats.TotalAcquired;
+	if ( mStats.LiveCount > mStats.PeakLiveCount ) mStats.PeakLiveCount = mStats.LiveCount;
+
+	return (uint8*) header + mHeaderSize;
+}
+//---------------------------------------
+void FixedSizePool::Release( void* memory )
+{
+	SlotHeader* header = GetHeader( memory );
+	assertion( header->IsLive, "FixedSizePool: slot %u released twice!", header->Index );
+
+	// Invalidate any handles to the old object
+	++header->Generation;
+	header->IsLive = false;
+	header->NextFree = mFirstFree;
+	mFirstFree = header->Index;
+
+	--mStats.LiveCount;
+}
+//---------------------------------------
+uint32 FixedSizePool::GetIndex( const void* memory ) const
+{
+	return GetHeader( memory )->Index;
+}
+//---------------------------------------
+uint32 FixedSizePool::GetGeneration( uint32 index ) const
+{
+	return GetHeader( index )->Generation;
+}
+//---------------------------------------
+bool FixedSizePool::IsLive( uint32 index ) const
+{
+	return GetHeader( index )->IsLive;
+}
+//---------------------------------------
+void* FixedSizePool::GetMemory( uint32 index ) const
+{
+	return (uint8*) GetHeader( index ) + mHeaderSize;
+}
+//---------------------------------------
+FixedSizePool::SlotHeader* FixedSizePool::GetHeader( uint32 index ) const
+{
+	uint8* block = mBlocks[ index / mSlotsPerBlock ];
+	return (SlotHeader*) ( block + ( index % mSlotsPerBlock ) * mStride );
+}
+//---------------------------------------
+FixedSizePool::SlotHeader* FixedSizePool::GetHeader( const void* memory ) const
+{
+	return (SlotHeader*) ( (const uint8*) memory - mHeaderSize );
+}
+//---------------------------------------
+void FixedSizePool::AddBlock()
+{
+	uint8* block = (uint8*) operator new( mStride * mSlotsPerBlock );
+	uint32 firstIndex = mBlocks.size() * mSlotsPerBlock;
+	mBlocks.push_back( block );
+
+	// Link the new slots so they are handed out in address order
+	for ( uint32 i = mSlotsPerBlock; i > 0; --i )
+	{
+		SlotHeader* header = (SlotHeader*) ( block + ( i - 1 ) * mStride );
+		header->Index = firstIndex + i - 1;
+		header->Generation = 0;
+		header->IsLive = false;
+		header->NextFree = mFirstFree;
+		mFirstFree = header->Index;
+	}
+
+	mStats.Capacity += mSlotsPerBlock;
+	++mStats.BlockCount;
+}
+//---------------------------------------
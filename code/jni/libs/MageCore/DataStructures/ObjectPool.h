@@ -0,0 +1,246 @@
+/*
+ * Description :
+ *   Pools that recycle objects of a fixed size without going through the heap.
+ */
+
+#pragma once
+
+namespace mage
+{
+
+	//---------------------------------------
+	// PoolStats
+	struct PoolStats
+	{
+		PoolStats()
+			: LiveCount( 0 )
+			, PeakLiveCount( 0 )
+			, Capacity( 0 )
+			, BlockCount( 0 )
+			, TotalAcquired( 0 )
+		{}
+
+		uint32 LiveCount;
+		uint32 PeakLiveCount;
+		uint32 Capacity;
+		uint32 BlockCount;
+		uint32 TotalAcquired;
+	};
+	//---------------------------------------
+
+
+	//---------------------------------------
+	// FixedSizePool
+	// Hands out slots of one size from blocks that are never moved or freed until the pool is destroyed,
+	// so Acquire() and Release() are O(1) and every object keeps its address for as long as it lives.
+	// Each slot has a generation that changes whenever the slot is released, so a stale reference
+	// (index + generation) to a slot that has been recycled can be detected.
+	// Not thread safe.
+	class FixedSizePool
+	{
+	public:
+		static const uint32 DEFAULT_SLOTS_PER_BLOCK = 64;
+		static const uint32 INVALID_INDEX = 0xFFFFFFFF;
+
+		FixedSizePool( size_t slotSize, size_t alignment, uint32 slotsPerBlock=DEFAULT_SLOTS_PER_BLOCK );
+		// Frees the blocks without running any destructors
+		~FixedSizePool();
+
+		void* Acquire();
+		void Release( void* memory );
+
+		uint32 GetIndex( const void* memory ) const;
+		uint32 GetGeneration( uint32 index ) const;
+		bool IsLive( uint32 index ) const;
+		void* GetMemory( uint32 index ) const;
+
+		size_t GetSlotSize() const			{ return mSlotSize; }
+		const PoolStats& GetStats() const	{ return mStats; }
+
+	private:
+		FixedSizePool( const FixedSizePool& );
+		FixedSizePool& operator=( const FixedSizePool& );
+
+		// Stored in front of every slot
+		struct SlotHeader
+		{
+			uint32 Index;
+			uint32 Generation;
+			uint32 NextFree;
+			bool IsLive;
+		};
+
+		SlotHeader* GetHeader( uint32 index ) const;
+		SlotHeader* GetHeader( const void* memory ) const;
+		void AddBlock();
+
+		size_t mSlotSize;
+		size_t mHeaderSize;
+		size_t mStride;
+		uint32 mSlotsPerBlock;
+		uint32 mFirstFree;
+		std::vector< uint8* > mBlocks;
+		PoolStats mStats;
+	};
+	//---------------------------------------
+
+
+	//---------------------------------------
+	// ObjectPool
+	// Typed wrapper around a FixedSizePool that constructs and destroys the objects
+	// Objects still alive when the pool is destroyed are destroyed with it
+	template< class T >
+	class ObjectPool
+	{
+	public:
+		// Refers to an object without keeping it alive, Get() returns NULL once the object is destroyed
+		struct Handle
+		{
+			Handle()
+				: Index( FixedSizePool::INVALID_INDEX )
+				, Generation( 0 )
+			{}
+
+			uint32 Index;
+			uint32 Generation;
+		};
+
+		ObjectPool( uint32 slotsPerBlock=FixedSizePool::DEFAULT_SLOTS_PER_BLOCK )
+			: mPool( sizeof( T ), alignof( T ), slotsPerBlock )
+		{}
+
+		~ObjectPool()
+		{
+			DestroyAll();
+		}
+
+		// Parameters are forwarded to the constructor as they were passed (references stay references)
+		template< typename... ParameterTypes >
+		T* Create( ParameterTypes&&... parameters )
+		{
+			return new( mPool.Acquire() ) T( static_cast< ParameterTypes&& >( parameters )... );
+		}
+
+		void Destroy( T* object )
+		{
+			object->~T();
+			mPool.Release( object );
+		}
+
+		// Destroy every object still in the pool
+		void DestroyAll()
+		{
+			for ( uint32 i = 0; i < mPool.GetStats().Capacity; ++i )
+			{
+				if ( mPool.IsLive( i ) )
+				{
+					Destroy( (T*) mPool.GetMemory( i ) );
+				}
+			}
+		}
+
+		Handle GetHandle( const T* object ) const
+		{
+			Handle handle;
+			handle.Index = mPool.GetIndex( object );
+			handle.Generation = mPool.GetGeneration( handle.Index );
+			return handle;
+		}
+
+		T* Get( const Handle& handle ) const
+		{
+			T* object = NULL;
+			if ( handle.Index < mPool.GetStats().Capacity && mPool.IsLive( handle.Index ) && mPool.GetGeneration( handle.Index ) == handle.Generation )
+			{
+				object = (T*) mPool.GetMemory( handle.Index );
+			}
+			return object;
+		}
+
+		const PoolStats& GetStats() const	{ return mPool.GetStats(); }
+
+	private:
+		FixedSizePool mPool;
+	};
+	//---------------------------------------
+
+
+	//---------------------------------------
+	// PoolAllocated
+	// Deriving a class hierarchy from PoolAllocated< Base > makes new and delete of Base and all of its
+	// subclasses come from FixedSizePools (one per object size) instead of the heap.
+	// Base must have a virtual destructor so subclasses are returned to the right pool, and the objects
+	// must only be created and destroyed on the main thread.
+	template< class Base >
+	class PoolAllocated
+	{
+	public:
+		static void* operator new( size_t size )
+		{
+			return GetPool( size ).Acquire();
+		}
+
+		static void operator delete( void* memory, size_t size )
+		{
+			if ( memory )
+			{
+				GetPool( size ).Release( memory );
+			}
+		}
+
+		// Declaring operator new hides the global placement form
+		static void* operator new( size_t, void* memory )	{ return memory; }
+		static void operator delete( void*, void* )			{}
+
+		// Stats summed over the pools for every size
+		static PoolStats GetPoolStats()
+		{
+			PoolStats total;
+			std::vector< FixedSizePool* >& pools = GetPools();
+			for ( size_t i = 0; i < pools.size(); ++i )
+			{
+				const PoolStats& stats = pools[ i ]->GetStats();
+				total.LiveCount += stats.LiveCount;
+				total.PeakLiveCount += stats.PeakLiveCount;
+				total.Capacity += stats.Capacity;
+				total.BlockCount += stats.BlockCount;
+				total.TotalAcquired += stats.TotalAcquired;
+			}
+			return total;
+		}
+
+	private:
+		static const size_t POOL_ALIGNMENT = 16;
+		static const uint32 SLOTS_PER_BLOCK = 32;
+
+		static std::vector< FixedSizePool* >& GetPools()
+		{
+			// Never destroyed, objects may still be deleted during static destruction
+			static std::vector< FixedSizePool* >* pools = new std::vector< FixedSizePool* >();
+			return *pools;
+		}
+
+		static FixedSizePool& GetPool( size_t size )
+		{
+			std::vector< FixedSizePool* >& pools = GetPools();
+			FixedSizePool* pool = NULL;
+
+			for ( size_t i = 0; i < pools.size() && !pool; ++i )
+			{
+				if ( pools[ i ]->GetSlotSize() == size )
+					pool = pools[ i ];
+			}
+
+			if ( !pool )
+			{
+				// First object of this size
+				pool = new FixedSizePool( size, POOL_ALIGNMENT, SLOTS_PER_BLOCK );
+				pools.push_back( pool );
+			}
+
+			return *pool;
+		}
+	};
+	//---------------------------------------
+
+}
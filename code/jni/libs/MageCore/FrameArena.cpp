@@ -0,0 +1,167 @@
+#include "CoreLib.h"
+
+using namespace mage;
+
+const size_t LinearArena::DEFAULT_PAGE_SIZE;
+const size_t LinearArena::DEFAULT_ALIGNMENT;
+
+LinearArena FrameMemory::msArenas[ 2 ];
+int FrameMemory::msCurrentArena = 0;
+
+//---------------------------------------
+static uint8* alignPointer( uint8* p, size_t alignment )
+{
+	uintptr_t address = (uintptr_t) p;
+	address = ( address + alignment - 1 ) & ~( (uintptr_t) alignment - 1 );
+	return (uint8*) address;
+}
+//---------------------------------------
+
+
+//---------------------------------------
+LinearArena::LinearArena( size_t pageSize )
+	: mPageSize( pageSize )
+	, mOffset( 0 )
+	, mBytesUsed( 0 )
+	, mHighWaterMark( 0 )
+	, mAllocationCount( 0 )
+{}
+//---------------------------------------
+LinearArena::~LinearArena()
+{
+	Release();
+}
+//---------------------------------------
+void* LinearArena::Allocate( size_t bytes, size_t alignment )
+{
+	assertion( ( alignment & ( alignment - 1 ) ) == 0, "LinearArena alignment must be a power of two (got %u)", alignment );
+
+	uint8* memory = NULL;
+	if ( !mPages.empty() )
+	{
+		// Bump through the current page
+		const Page& page = mPages.back();
+		memory = alignPointer( page.Memory + mOffset, alignment );
+		if ( memory + bytes > page.Memory + page.Size )
+			memory = NULL;
+	}
+
+	if ( memory == NULL )
+	{
+		// Out of room, the rest of the current page is wasted until Reset()
+		AddPage( bytes + alignment );
+		memory = alignPointer( mPages.back().Memory, alignment );
+	}
+
+	const Page& page = mPages.back();
+	size_t newOffset = ( memory + bytes ) - page.Memory;
+	mBytesUsed += newOffset - mOffset;
+	mOffset = newOffset;
+	++mAllocationCount;
+
+	if ( mBytesUsed > mHighWaterMark )
+		mHighWaterMark = mBytesUsed;
+
+	return memory;
+}
+//---------------------------------------
+void LinearArena::Reset()
+{
+	if ( mPages.size() > 1 )
+	{
+		// Replace the pages with a single one big enough for all of them
+		size_t capacity = GetCapacity();
+		Release();
+		AddPage( capacity );
+	}
+
+	mOffset = 0;
+	mBytesUsed = 0;
+	mAllocationCount = 0;
+}
+//---------------------------------------
+void LinearArena::Release()
+{
+	for ( std::vector< Page >::iterator itr = mPages.begin(); itr != mPages.end(); ++itr )
+	{
+		if ( itr->IsFromMemoryPool )
+			MemoryPool::Free( itr->Memory );
+		else
+			delete[] itr->Memory;
+	}
+	mPages.clear();
+
+	mOffset = 0;
+	mBytesUsed = 0;
+	mAllocationCount = 0;
+}
+//---------------------------------------
+size_t LinearArena::GetCapacity() const
+{
+	size_t capacity = 0;
+	for ( std::vector< Page >::const_iterator itr = mPages.begin(); itr != mPages.end(); ++itr )
+	{
+		capacity += itr->Size;
+	}
+	return capacity;
+}
+//---------------------------------------
+void LinearArena::AddPage( size_t minimumSize )
+{
+	Page page;
+	page.Size = std::max( mPageSize, minimumSize );
+	page.IsFromMemoryPool = ( MemoryPool::Pool != NULL );
+
+	if ( page.IsFromMemoryPool )
+		page.Memory = (uint8*) MemoryPool::Allocate( __FILE__, __LINE__, page.Size, MEMUSAGE_ALLOCATOR );
+	else
+		page.Memory = new uint8[ page.Size ];
+	mPages.push_back( page );
+
+	mOffset = 0;
+}
+//---------------------------------------
+
+
+//---------------------------------------
+void* FrameMemory::Allocate( size_t bytes, size_t alignment )
+{
+	return msArenas[ msCurrentArena ].Allocate( bytes, alignment );
+}
+//---------------------------------------
+void FrameMemory::EndFrame()
+{
+	ProfileCounter( FrameMemoryBytes, (double) msArenas[ msCurrentArena ].GetBytesUsed() );
+	ProfileCounter( FrameMemoryAllocations, (double) msArenas[ msCurrentArena ].GetAllocationCount() );
+
+	// The other arena holds last frame's data, which nothing can be using any more
+	msCurrentArena = 1 - msCurrentArena;
+	msArenas[ msCurrentArena ].Reset();
+}
+//---------------------------------------
+size_t FrameMemory::GetBytesUsedThisFrame()
+{
+	return msArenas[ msCurrentArena ].GetBytesUsed();
+}
+//---------------------------------------
+uint32 FrameMemory::GetAllocationsThisFrame()
+{
+	return msArenas[ msCurrentArena ].GetAllocationCount();
+}
+//---------------------------------------
+size_t FrameMemory::GetBytesUsedLastFrame()
+{
+	// Still untouched until the next EndFrame()
+	return msArenas[ 1 - msCurrentArena ].GetBytesUsed();
+}
+//---------------------------------------
+uint32 FrameMemory::GetAllocationsLastFrame()
+{
+	return msArenas[ 1 - msCurrentArena ].GetAllocationCount();
+}
+//---------------------------------------
+size_t FrameMemory::GetHighWaterMark()
+{
+	return std::max( msArenas[ 0 ].GetHighWaterMark(), msArenas[ 1 ].GetHighWaterMark() );
+}
+//---------------------------------------
@@ -0,0 +1,154 @@
+/*
+ * Description :
+ *   Linear (bump) allocators for transient data that only needs to live for a frame.
+ */
+
+#pragma once
+
+#include <limits>
+
+namespace mage
+{
+
+	//---------------------------------------
+	// LinearArena
+	// Hands out memory by bumping an offset through large pages. Allocations are never freed
+	// individually, everything is released at once by Reset().
+	// Pages come from the MemoryPool (tagged MEMUSAGE_ALLOCATOR) once it is initialized, and from the heap before that.
+	class LinearArena
+	{
+	public:
+		static const size_t DEFAULT_PAGE_SIZE = 64 * 1024;
+		static const size_t DEFAULT_ALIGNMENT = 8;
+
+		LinearArena( size_t pageSize=DEFAULT_PAGE_SIZE );
+		~LinearArena();
+
+		void* Allocate( size_t bytes, size_t alignment=DEFAULT_ALIGNMENT );
+
+		// Forget every allocation but keep the memory around for reuse
+		// If the arena had to grow, its pages are merged into one so the next use fits in a single page
+		void Reset();
+		// Free all pages
+		void Release();
+
+		size_t GetBytesUsed() const         { return mBytesUsed; }
+		uint32 GetAllocationCount() const   { return mAllocationCount; }
+		size_t GetHighWaterMark() const     { return mHighWaterMark; }
+		size_t GetCapacity() const;
+
+	private:
+		LinearArena( const LinearArena& );
+		LinearArena& operator=( const LinearArena& );
+
+		struct Page
+		{
+			uint8* Memory;
+			size_t Size;
+			bool IsFromMemoryPool;
+		};
+
+		void AddPage( size_t minimumSize );
+
+		std::vector< Page > mPages;
+		size_t mPageSize;
+		size_t mOffset;
+		size_t mBytesUsed;
+		size_t mHighWaterMark;
+		uint32 mAllocationCount;
+	};
+	//---------------------------------------
+
+
+	//---------------------------------------
+	// FrameMemory
+	// A pair of LinearArenas that are swapped at the end of every frame.
+	// Memory allocated during a frame stays valid until the end of the following frame, so data can be
+	// handed from one frame to the next without copying it.
+	// Only the main thread may allocate from it.
+	class FrameMemory
+	{
+	public:
+		static void* Allocate( size_t bytes, size_t alignment=LinearArena::DEFAULT_ALIGNMENT );
+
+		// Swap the arenas and release everything allocated the frame before last
+		// Reports the bytes used this frame to the ProfilingSystem
+		static void EndFrame();
+
+		static size_t GetBytesUsedThisFrame();
+		static uint32 GetAllocationsThisFrame();
+		// Totals for the last frame that ended
+		static size_t GetBytesUsedLastFrame();
+		static uint32 GetAllocationsLastFrame();
+		static size_t GetHighWaterMark();
+
+	private:
+		static LinearArena msArenas[ 2 ];
+		static int msCurrentArena;
+	};
+	//---------------------------------------
+
+
+	//---------------------------------------
+	// FrameAlloc
+	// STL allocator that takes its memory from FrameMemory.
+	// Containers using it must not outlive the frame after the one they were filled in.
+	template< typename T >
+	class FrameAlloc
+	{
+	public:
+
+		typedef T				value_type;
+		typedef T*				pointer;
+		typedef const T*		const_pointer;
+		typedef T&				reference;
+		typedef const T&		const_reference;
+		typedef std::size_t		size_type;
+		typedef std::ptrdiff_t	difference_type;
+
+		template< typename U >
+		struct rebind
+		{
+			typedef FrameAlloc< U > other;
+		};
+
+		pointer address( reference value ) const { return &value; }
+		const_pointer address( const_reference value ) const { return &value; }
+
+		FrameAlloc() throw() {}
+		FrameAlloc( const FrameAlloc& ) throw() {}
+
+		template< typename U >
+		FrameAlloc( const FrameAlloc< U >& ) throw() {}
+		~FrameAlloc() throw() {}
+
+		size_type max_size() const throw() { return std::numeric_limits< std::size_t >::max() / sizeof( T ); }
+
+		pointer allocate( size_type num, const void* = 0 )
+		{
+			return (pointer) FrameMemory::Allocate( num * sizeof( T ) );
+		}
+
+		void construct( pointer p, const_reference value )
+		{
+			new( (void*) p ) T(value);
+		}
+
+		void destroy( pointer p )
+		{
+			p->~T();
+		}
+
+		void deallocate( pointer /*p*/, size_type /*num*/ )
+		{
+			// Released all at once when the frame ends
+		}
+	};
+
+	template< typename T1, typename T2 >
+	bool operator==( const FrameAlloc< T1 >&, const FrameAlloc< T2 >& ) throw() { return true; }
+	template< typename T1, typename T2 >
+	bool operator!=( const FrameAlloc< T1 >&, const FrameAlloc< T2 >& ) throw() { return false; }
+	//---------------------------------------
+
+}
@@ -0,0 +1,94 @@
+#include "CoreLib.h"
+
+using namespace mage;
+
+const uint32 FrameTimeHistogram::BUCKET_COUNT;
+const uint32 FrameTimeHistogram::WINDOW_SIZE;
+const double FrameTimeHistogram::BUCKET_WIDTH_SECONDS = 0.0005;
+
+//---------------------------------------
+FrameTimeHistogram::FrameTimeHistogram( double hitchThresholdSeconds )
+	: mHitchThresholdSeconds( hitchThresholdSeconds )
+{
+	Clear();
+}
+//---------------------------------------
+void FrameTimeHistogram::AddSample( double seconds )
+{
+	// Bucket the value as stored, so it comes out of the same bucket when it leaves the window
+	float sample = (float) seconds;
+
+	// Drop the oldest sample once the window is full
+	if ( mSampleCount == WINDOW_SIZE )
+	{
+		float oldest = mSamples[ mNextSample ];
+		--mBuckets[ GetBucket( oldest ) ];
+
+		if ( oldest > mHitchThresholdSeconds )
+			--mHitchCount;
+	}
+	else
+	{
+		++mSampleCount;
+	}
+
+	mSamples[ mNextSample ] = sample;
+	mNextSample = ( mNextSample + 1 ) % WINDOW_SIZE;
+	++mBuckets[ GetBucket( sample ) ];
+
+	if ( sample > mHitchThresholdSeconds )
+	{
+		++mHitchCount;
+		++mTotalHitchCount;
+	}
+}
+//---------------------------------------
+void FrameTimeHistogram::Clear()
+{
+	memset( mBuckets, 0, sizeof( mBuckets ) );
+	mNextSample = 0;
+	mSampleCount = 0;
+	mHitchCount = 0;
+	mTotalHitchCount = 0;
+}
+//---------------------------------------
+double FrameTimeHistogram::GetPercentile( double fraction ) const
+{
+	double time = 0.0;
+
+	if ( mSampleCount > 0 )
+	{
+		// Find the bucket holding the sample at that rank
+		uint32 rank = std::max( (uint32) std::ceil( fraction * mSampleCount ), 1U );
+		uint32 count = 0;
+		uint32 bucket = 0;
+
+		for ( ; bucket < BUCKET_COUNT - 1; ++bucket )
+		{
+			count += mBuckets[ bucket ];
+			if ( count >= rank )
+				break;
+		}
+
+		time = ( bucket + 1 ) * BUCKET_WIDTH_SECONDS;
+	}
+
+	return time;
+}
+//---------------------------------------
+double FrameTimeHistogram::GetSample( uint32 index ) const
+{
+	uint32 oldest = ( mSampleCount == WINDOW_SIZE ) ? mNextSample : 0;
+	return mSamples[ ( oldest + index ) % WINDOW_SIZE ];
+}
+//---------------------------------------
+uint32 FrameTimeHistogram::GetBucket( double seconds ) const
+{
+	uint32 bucket = BUCKET_COUNT - 1;
+
+	if ( seconds < BUCKET_COUNT * BUCKET_WIDTH_SECONDS )
+		bucket = (uint32) std::max( seconds / BUCKET_WIDTH_SECONDS, 0.0 );
+
+	return bucket;
+}
+//---------------------------------------
@@ -0,0 +1,52 @@
+/*
+ * Description :
+ *   Fixed-bucket histogram of per-frame times over a rolling window of frames, for percentiles and hitches.
+ */
+
+#pragma once
+
+namespace mage
+{
+
+	//---------------------------------------
+	// FrameTimeHistogram
+	// Adding a sample is O(1) and never allocates: the oldest sample in the window is removed from its
+	// bucket as the new one is added. Percentiles are accurate to one bucket.
+	class FrameTimeHistogram
+	{
+	public:
+		static const uint32 BUCKET_COUNT = 200;			// The last bucket also holds every longer time
+		static const uint32 WINDOW_SIZE = 300;			// Frames the percentiles and hitches are measured over
+		static const double BUCKET_WIDTH_SECONDS;
+
+		FrameTimeHistogram( double hitchThresholdSeconds );
+
+		void AddSample( double seconds );
+		void Clear();
+
+		// Time that the given fraction (0 to 1) of the samples in the window don't go over
+		double GetPercentile( double fraction ) const;
+		// Samples in the window longer than the hitch threshold
+		uint32 GetHitchCount() const			{ return mHitchCount; }
+		// Samples ever added that were longer than the hitch threshold
+		uint32 GetTotalHitchCount() const		{ return mTotalHitchCount; }
+		double GetHitchThreshold() const		{ return mHitchThresholdSeconds; }
+
+		uint32 GetSampleCount() const			{ return mSampleCount; }
+		// Samples in the window, from 0 (the oldest) to GetSampleCount() - 1
+		double GetSample( uint32 index ) const;
+
+	private:
+		uint32 GetBucket( double seconds ) const;
+
+		uint32 mBuckets[ BUCKET_COUNT ];
+		float mSamples[ WINDOW_SIZE ];
+		uint32 mNextSample;
+		uint32 mSampleCount;
+		uint32 mHitchCount;
+		uint32 mTotalHitchCount;
+		double mHitchThresholdSeconds;
+	};
+	//---------------------------------------
+
+}
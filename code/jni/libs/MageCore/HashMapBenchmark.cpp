@@ -0,0 +1,77 @@
+#include "CoreLib.h"
+
+using namespace mage;
+
+const unsigned int HashMapBenchmark::MAX_KEY_COUNT;
+
+//---------------------------------------
+void HashMapBenchmark::Run( unsigned int minOperations )
+{
+	static const unsigned int KEY_COUNTS[] = { 16, 256, MAX_KEY_COUNT };
+
+	// Twice as many keys as are inserted, the second half are looked up as misses
+	std::vector< HashString > keys;
+	keys.reserve( MAX_KEY_COUNT * 2 );
+	for ( unsigned int i = 0; i < MAX_KEY_COUNT * 2; ++i )
+	{
+		char name[ 32 ];
+		sprintf_s( name, "BenchmarkKey%u", i );
+		keys.push_back( HashString( name ) );
+	}
+
+	ConsolePrintf( CONSOLE_INFO, "HashMapBenchmark : at least %d inserts and lookups per size\n", minOperations );
+
+	for ( unsigned int i = 0; i < sizeof( KEY_COUNTS ) / sizeof( KEY_COUNTS[ 0 ] ); ++i )
+	{
+		unsigned int keyCount = KEY_COUNTS[ i ];
+		unsigned int repeats = std::max( minOperations / keyCount, 1U );
+		double operations = (double) keyCount * repeats;
+
+		Timings hashMap = Measure< HashMap< uint32 > >( keys, keyCount, repeats );
+		Timings stdMap = Measure< std::map< HashString, uint32 > >( keys, keyCount, repeats );
+
+		// Both maps held the same values, so their lookups must add up the same
+		assertion( hashMap.Checksum == stdMap.Checksum, "HashMapBenchmark : HashMap and std::map lookups disagree\n" );
+
+		ConsolePrintf( CONSOLE_INFO, "HashMapBenchmark : %4d keys : insert %.1f ns (std::map %.1f ns) : lookup %.1f ns (std::map %.1f ns)\n",
+			keyCount,
+			hashMap.InsertSeconds / operations * 1.0e9, stdMap.InsertSeconds / operations * 1.0e9,
+			hashMap.LookupSeconds / operations * 1.0e9, stdMap.LookupSeconds / operations * 1.0e9 );
+	}
+}
+//---------------------------------------
+template< class MapType >
+HashMapBenchmark::Timings HashMapBenchmark::Measure( const std::vector< HashString >& keys, unsigned int keyCount, unsigned int repeats )
+{
+	Timings timings = { 0.0, 0.0, 0 };
+
+	for ( unsigned int repeat = 0; repeat < repeats; ++repeat )
+	{
+		MapType map;
+
+		double startTime = Clock::QueryTime( Clock::TIME_SEC );
+		for ( unsigned int i = 0; i < keyCount; ++i )
+		{
+			map[ keys[ i ] ] = i;
+		}
+		double insertedTime = Clock::QueryTime( Clock::TIME_SEC );
+
+		// Alternate between a key in the map and one that isn't
+		for ( unsigned int i = 0; i < keyCount; ++i )
+		{
+			unsigned int keyIndex = ( i & 1 ) ? MAX_KEY_COUNT + i : i;
+			typename MapType::const_iterator found = map.find( keys[ keyIndex ] );
+			if ( found != map.end() )
+			{
+				timings.Checksum += found->second;
+			}
+		}
+		double lookedUpTime = Clock::QueryTime( Clock::TIME_SEC );
+
+		timings.InsertSeconds += insertedTime - startTime;
+		timings.LookupSeconds += lookedUpTime - insertedTime;
+	}
+
+	return timings;
+}
+//---------------------------------------
@@ -0,0 +1,33 @@
+/*
+ * Description :
+ *   Compares insert and lookup speed of HashMap against the std::map< HashString, T > it replaced.
+ */
+
+#pragma once
+
+namespace mage
+{
+
+	class HashMapBenchmark
+	{
+	public:
+		// Times filling maps of a few sizes and then looking up keys in them, half of which are missing,
+		// with both containers, and prints the results
+		// Every size is repeated until at least minOperations inserts and lookups have been timed
+		static void Run( unsigned int minOperations );
+
+	private:
+		static const unsigned int MAX_KEY_COUNT = 4096;
+
+		struct Timings
+		{
+			double InsertSeconds;
+			double LookupSeconds;
+			uint32 Checksum;
+		};
+
+		template< class MapType >
+		static Timings Measure( const std::vector< HashString >& keys, unsigned int keyCount, unsigned int repeats );
+	};
+
+}
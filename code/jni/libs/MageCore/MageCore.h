@@ -33,6 +33,8 @@
 
 // Memory
 #include "MageMemory.h"
+#include "FrameArena.h"
+#include "MemoryBenchmark.h"
 
 // IO
 #include "Console.h"
@@ -51,19 +53,25 @@
 // Data structures
 #include "CommandArgs.h"
 #include "HashMap.h"
+#include "HashMapBenchmark.h"
 #include "Dictionary.h"
 #include "CircularBuffer.h"
+#include "ObjectPool.h"
 #include "Event.h"
 #include "Clock.h"
+#include "FrameTimeHistogram.h"
 #include "ProfilingSystem.h"
 #include "ArrayList.h"
 #include "Transform2D.h"
 
 // Threads
 #include "Mutex.h"
+#include "Semaphore.h"
 #include "Thread.h"
 #include "Job.h"
 #include "JobManager.h"
+#include "Task.h"
+#include "JobBenchmark.h"
 
 // Object management system
 #include "RTTI.h"
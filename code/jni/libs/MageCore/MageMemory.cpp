@@ -23,10 +23,10 @@ static uint8 PMA = 0;						// Pre-Main allocation count
 
 
 const uint32 MemoryPool::DefaultPoolSize      = 536870912U; // 512MB //1073741824U;	// 1GB (1GB caused out-of-memory issues sometimes)
-const uint8 MemoryPool::BlockSize             = sizeof( MemoryPool::Block );
+const uint8 MemoryPool::BlockSize             = ( sizeof( MemoryPool::Block ) + 15 ) & ~15;	// Keeps payloads 16 byte aligned
 uint8* MemoryPool::Pool                       = NULL;
 MemoryPool::Block* MemoryPool::Head           = NULL;
-MemoryPool::Block* MemoryPool::NextFree		  = NULL;
+MemoryPool::Block* MemoryPool::FreeBins[ MemoryPool::FreeBinCount ];
 uint32 MemoryPool::BlocksAllocated            = 0;
 uint32 MemoryPool::BlocksFreed                = 0;
 uint32 MemoryPool::TotalAllocationRequests    = 0;
@@ -35,9 +35,296 @@ uint32 MemoryPool::LargestAllocationRequest   = 0;
 uint32 MemoryPool::AverageAllocationRequested = 0;
 uint32 MemoryPool::BlocksByUsage[ MEMUSAGE_COUNT ];
 
+const uint32 MemoryPool::SmallBlockHeaderSize;
+const uint32 MemoryPool::SmallBlockMaxSize;
+const uint32 MemoryPool::SizeClassCount;
+const uint32 MemoryPool::SlabRegionSize;
+const uint32 MemoryPool::SpanSize;
+const uint32 MemoryPool::SpanCount;
+const uint32 MemoryPool::ThreadCacheMaxBlocks;
+const uint32 MemoryPool::ThreadCacheBatchSize;
+const uint32 MemoryPool::FreeBinCount;
+const uint32 MemoryPool::MinBlockPayload;
+
 // For thread safety
 static Mutex gMemoryMutex;
 
+// Slab allocations fold their stats into the totals after this many operations on a thread
+static const uint32 STATS_FOLD_INTERVAL = 256;
+
+// Largest request served by each size class (the block also holds a SmallBlock header)
+static const uint32 SIZE_CLASS_SIZES[ MemoryPool::SizeClassCount ] = { 16, 32, 48, 64, 96, 128, 192, 256 };
+
+//---------------------------------------
+// Free blocks of one size class shared by all threads
+struct SizeClassList
+{
+	SizeClassList()
+		: FreeBlocks( NULL )
+		, FreeCount( 0 )
+	{}
+
+	Mutex ListMutex;
+	MemoryPool::SmallBlock* FreeBlocks;
+	uint32 FreeCount;
+};
+//---------------------------------------
+// Free blocks (and stats not yet folded into the totals) owned by one thread
+// Must stay POD so it can live in thread local storage
+struct ThreadCache
+{
+	MemoryPool::SmallBlock* FreeBlocks[ MemoryPool::SizeClassCount ];
+	uint32 FreeCounts[ MemoryPool::SizeClassCount ];
+
+	int32 BlocksAllocated;
+	int32 BytesAllocated;
+	int32 BlocksByUsage[ MEMUSAGE_COUNT ];
+	uint32 AllocationRequests;
+	uint32 BytesRequested;
+	uint32 LargestRequest;
+	uint32 PendingOperations;
+};
+//---------------------------------------
+
+static uint8* gSlabRegion = NULL;
+static uint32 gSpansUsed = 0;									// Guarded by gMemoryMutex
+static uint8 gSpanSizeClasses[ MemoryPool::SpanCount ];
+static SizeClassList gSizeClassLists[ MemoryPool::SizeClassCount ];
+static THREAD_LOCAL ThreadCache gThreadCache;
+
+//---------------------------------------
+static inline uint32 getBlockSize( uint32 sizeClass )
+{
+	return MemoryPool::SmallBlockHeaderSize + SIZE_CLASS_SIZES[ sizeClass ];
+}
+//---------------------------------------
+static inline uint32 getSizeClass( size_t bytes )
+{
+	uint32 sizeClass = 0;
+	while ( SIZE_CLASS_SIZES[ sizeClass ] < bytes )
+		++sizeClass;
+	return sizeClass;
+}
+//---------------------------------------
+// Free blocks link through the memory that is handed to the user
+static inline MemoryPool::SmallBlock*& getNextFreeBlock( MemoryPool::SmallBlock* block )
+{
+	return *(MemoryPool::SmallBlock**) ( (uint8*) block + MemoryPool::SmallBlockHeaderSize );
+}
+//---------------------------------------
+static inline bool isInSlabRegion( void* memory )
+{
+	return gSlabRegion != NULL && (uint8*) memory >= gSlabRegion && (uint8*) memory < gSlabRegion + MemoryPool::SlabRegionSize;
+}
+//---------------------------------------
+// Split a new span into blocks and add them to the list (the caller holds the list's mutex)
+static void carveSpan( uint32 sizeClass, SizeClassList& list )
+{
+	uint8* span = NULL;
+
+	BeginCriticalSection( gMemoryMutex );
+	if ( gSpansUsed < MemoryPool::SpanCount )
+	{
+		gSpanSizeClasses[ gSpansUsed ] = (uint8) sizeClass;
+		span = gSlabRegion + gSpansUsed * MemoryPool::SpanSize;
+		++gSpansUsed;
+	}
+	EndCriticalSection();
+
+	// Slab region is full, the caller falls back to the block list
+	if ( span == NULL ) return;
+
+	const uint32 blockSize = getBlockSize( sizeClass );
+	const uint32 blockCount = MemoryPool::SpanSize / blockSize;
+
+	// Push the blocks in reverse so they are handed out in address order
+	for ( uint32 i = blockCount; i > 0; --i )
+	{
+		MemoryPool::SmallBlock* block = (MemoryPool::SmallBlock*) ( span + ( i - 1 ) * blockSize );
+		block->FileName = 0;
+		block->LineNumber = 0;
+		block->UserType = 0;
+		block->SizeClass = (uint8) sizeClass;
+
+		getNextFreeBlock( block ) = list.FreeBlocks;
+		list.FreeBlocks = block;
+	}
+	list.FreeCount += blockCount;
+}
+//---------------------------------------
+// Move a batch of blocks from the shared list into the thread's cache
+static void refillThreadCache( ThreadCache& cache, uint32 sizeClass )
+{
+	SizeClassList& list = gSizeClassLists[ sizeClass ];
+	Mutex& listMutex = list.ListMutex;
+	CriticalBlock( listMutex );
+
+	if ( list.FreeBlocks == NULL )
+		carveSpan( sizeClass, list );
+
+	for ( uint32 i = 0; i < MemoryPool::ThreadCacheBatchSize && list.FreeBlocks != NULL; ++i )
+	{
+		MemoryPool::SmallBlock* block = list.FreeBlocks;
+		list.FreeBlocks = getNextFreeBlock( block );
+		--list.FreeCount;
+
+		getNextFreeBlock( block ) = cache.FreeBlocks[ sizeClass ];
+		cache.FreeBlocks[ sizeClass ] = block;
+		++cache.FreeCounts[ sizeClass ];
+	}
+}
+//---------------------------------------
+// Move up to count blocks from the thread's cache back to the shared list
+static void drainThreadCache( ThreadCache& cache, uint32 sizeClass, uint32 count )
+{
+	SizeClassList& list = gSizeClassLists[ sizeClass ];
+	Mutex& listMutex = list.ListMutex;
+	CriticalBlock( listMutex );
+
+	for ( uint32 i = 0; i < count && cache.FreeBlocks[ sizeClass ] != NULL; ++i )
+	{
+		MemoryPool::SmallBlock* block = cache.FreeBlocks[ sizeClass ];
+		cache.FreeBlocks[ sizeClass ] = getNextFreeBlock( block );
+		--cache.FreeCounts[ sizeClass ];
+
+		getNextFreeBlock( block ) = list.FreeBlocks;
+		list.FreeBlocks = block;
+		++list.FreeCount;
+	}
+}
+//---------------------------------------
+// Add the stats gathered by the thread to the MemoryPool totals
+static void foldThreadStats( ThreadCache& cache )
+{
+	CriticalBlock( gMemoryMutex );
+
+	MemoryPool::BlocksAllocated += cache.BlocksAllocated;
+	MemoryPool::TotalBytesAllocated += cache.BytesAllocated;
+	MemoryPool::TotalAllocationRequests += cache.AllocationRequests;
+	for ( uint32 i = 0; i < MEMUSAGE_COUNT; ++i )
+	{
+		MemoryPool::BlocksByUsage[ i ] += cache.BlocksByUsage[ i ];
+		cache.BlocksByUsage[ i ] = 0;
+	}
+
+	if ( cache.AllocationRequests > 0 )
+	{
+		uint32 averageRequest = cache.BytesRequested / cache.AllocationRequests;
+		MemoryPool::AverageAllocationRequested = (uint32) ( ( 0.9f * MemoryPool::AverageAllocationRequested ) + ( 0.1f * averageRequest ) );
+	}
+	if ( cache.LargestRequest > MemoryPool::LargestAllocationRequest )
+		MemoryPool::LargestAllocationRequest = cache.LargestRequest;
+
+	cache.BlocksAllocated = 0;
+	cache.BytesAllocated = 0;
+	cache.AllocationRequests = 0;
+	cache.BytesRequested = 0;
+	cache.LargestRequest = 0;
+	cache.PendingOperations = 0;
+}
+//---------------------------------------
+static void* allocateSmall( const char* filename, uint16 line, size_t bytes, uint8 usage )
+{
+	ThreadCache& cache = gThreadCache;
+	const uint32 sizeClass = getSizeClass( bytes );
+
+	if ( cache.FreeBlocks[ sizeClass ] == NULL )
+		refillThreadCache( cache, sizeClass );
+
+	MemoryPool::SmallBlock* block = cache.FreeBlocks[ sizeClass ];
+
+	// Out of slabs
+	if ( block == NULL ) return NULL;
+
+	cache.FreeBlocks[ sizeClass ] = getNextFreeBlock( block );
+	--cache.FreeCounts[ sizeClass ];
+
+	block->FileName = filename;
+	block->LineNumber = line;
+	block->UserType = usage;
+
+	// Stats
+	++cache.BlocksAllocated;
+	cache.BytesAllocated += SIZE_CLASS_SIZES[ sizeClass ];
+	++cache.BlocksByUsage[ usage ];
+	++cache.AllocationRequests;
+	cache.BytesRequested += bytes;
+	if ( bytes > cache.LargestRequest ) cache.LargestRequest = bytes;
+	if ( ++cache.PendingOperations >= STATS_FOLD_INTERVAL ) foldThreadStats( cache );
+
+	return (uint8*) block + MemoryPool::SmallBlockHeaderSize;
+}
+//---------------------------------------
+static void freeSmall( void* memory )
+{
+	ThreadCache& cache = gThreadCache;
+	MemoryPool::SmallBlock* block = (MemoryPool::SmallBlock*) ( (uint8*) memory - MemoryPool::SmallBlockHeaderSize );
+	const uint32 sizeClass = block->SizeClass;
+
+	DebugAsssertion( block->UserType != 0, "Double free of small block in memory pool!\n" );
+
+	// Stats
+	--cache.BlocksAllocated;
+	cache.BytesAllocated -= SIZE_CLASS_SIZES[ sizeClass ];
+	--cache.BlocksByUsage[ block->UserType ];
+
+	block->FileName = 0;
+	block->LineNumber = 0;
+	block->UserType = 0;
+
+	// The block goes to this thread's cache, even if another thread allocated it
+	getNextFreeBlock( block ) = cache.FreeBlocks[ sizeClass ];
+	cache.FreeBlocks[ sizeClass ] = block;
+	++cache.FreeCounts[ sizeClass ];
+
+	if ( cache.FreeCounts[ sizeClass ] > MemoryPool::ThreadCacheMaxBlocks )
+		drainThreadCache( cache, sizeClass, MemoryPool::ThreadCacheBatchSize );
+
+	if ( ++cache.PendingOperations >= STATS_FOLD_INTERVAL ) foldThreadStats( cache );
+}
+//---------------------------------------
+// Free blocks in the block list link through their payload: [ 0 ] is the previous and [ 1 ] the next free block in the bin
+static inline MemoryPool::Block** getFreeLinks( MemoryPool::Block* block )
+{
+	return (MemoryPool::Block**) ( (uint8*) block + MemoryPool::BlockSize );
+}
+//---------------------------------------
+// Bin n holds free blocks of 2^n to 2^(n+1)-1 bytes
+static inline uint32 getFreeBin( uint32 size )
+{
+	uint32 bin = 0;
+	while ( size >>= 1 )
+		++bin;
+	return bin;
+}
+//---------------------------------------
+static void linkFreeBlock( MemoryPool::Block* block )
+{
+	MemoryPool::Block*& first = MemoryPool::FreeBins[ getFreeBin( block->BlockSize ) ];
+
+	getFreeLinks( block )[ 0 ] = NULL;
+	getFreeLinks( block )[ 1 ] = first;
+	if ( first )
+		getFreeLinks( first )[ 0 ] = block;
+	first = block;
+}
+//---------------------------------------
+static void unlinkFreeBlock( MemoryPool::Block* block )
+{
+	MemoryPool::Block* prev = getFreeLinks( block )[ 0 ];
+	MemoryPool::Block* next = getFreeLinks( block )[ 1 ];
+
+	if ( prev )
+		getFreeLinks( prev )[ 1 ] = next;
+	else
+		MemoryPool::FreeBins[ getFreeBin( block->BlockSize ) ] = next;
+
+	if ( next )
+		getFreeLinks( next )[ 0 ] = prev;
+}
+//---------------------------------------
+
+
 //---------------------------------------
 bool MemoryPool::InitializeMemory()
 {
@@ -52,8 +339,12 @@ bool MemoryPool::InitializeMemory()
 			return false;
 		}
 
-		Head = (Block*) Pool;
-		Head->BlockSize = DefaultPoolSize - BlockSize;
+		// Slabs come first, the block list covers the rest of the pool
+		gSlabRegion = Pool;
+		gSpansUsed = 0;
+
+		Head = (Block*) ( Pool + SlabRegionSize );
+		Head->BlockSize = DefaultPoolSize - SlabRegionSize - BlockSize;
 		Head->FileName = 0;
 		Head->LineNumber = 0;
 		Head->Free = true;
@@ -61,7 +352,8 @@ bool MemoryPool::InitializeMemory()
 		Head->PrevBlock = NULL;
 		Head->NextBlock = NULL;
 
-		NextFree = Head;
+		memset( FreeBins, 0, sizeof( FreeBins ) );
+		linkFreeBlock( Head );
 
 		++BlocksFreed;
 
@@ -82,9 +374,27 @@ void MemoryPool::TerminateMemory()
 		// Don't free the pool while there is a pre-main allocation
 		if ( PMA > 0 ) return;
 
-		// Report memory leaks
+		ReleaseThreadCache();
+
+		// Report memory leaks in slabs
+		for ( uint32 span = 0; span < gSpansUsed; ++span )
+		{
+			const uint32 blockSize = getBlockSize( gSpanSizeClasses[ span ] );
+			const uint32 blockCount = SpanSize / blockSize;
+
+			for ( uint32 i = 0; i < blockCount; ++i )
+			{
+				SmallBlock* block = (SmallBlock*) ( gSlabRegion + span * SpanSize + i * blockSize );
+				if ( block->UserType != 0 )
+				{
+					OutputDebugMessage( "%s(%u): Memory leak : %s.\n",
+						block->FileName, block->LineNumber, ByteDisplay( SIZE_CLASS_SIZES[ block->SizeClass ] ).ToString() );
+				}
+			}
+		}
+
+		// Report memory leaks in the block list
 		Block* b = Head;
-		Block* n = NULL;
 
 		while ( b )
 		{
@@ -94,10 +404,18 @@ void MemoryPool::TerminateMemory()
 					b->FileName, b->LineNumber, ByteDisplay( b->BlockSize ).ToString() );
 			}
 
-			n = b;
 			b = b->NextBlock;
 		}
 
+		// Forget the slabs (any other thread still caching blocks must have finished by now)
+		for ( uint32 i = 0; i < SizeClassCount; ++i )
+		{
+			gSizeClassLists[ i ].FreeBlocks = NULL;
+			gSizeClassLists[ i ].FreeCount = 0;
+		}
+		gSlabRegion = NULL;
+		gSpansUsed = 0;
+
 		// Free memory pool
 		free( Pool );
 		Pool = NULL;
@@ -115,253 +433,170 @@ void* MemoryPool::Allocate( size_t bytes )
 //---------------------------------------
 void* MemoryPool::Allocate( const char* filename, uint16 line, size_t bytes, uint8 usage )
 {
-	CriticalBlock( gMemoryMutex );
-
 	// No memory Pool
 	DebugAsssertion( Pool != NULL, "Allocate called before MemoryPool::Initialize()\n" );
 	if ( Pool == NULL ) return NULL;
 	// 0 byte allocation request
 	if ( bytes == 0 ) return NULL;
 
-	Block* b = NextFree;
-	Block* n = NULL;
+	// Small requests come from the thread's slab cache
+	if ( bytes <= SmallBlockMaxSize )
+	{
+		void* memory = allocateSmall( filename, line, bytes, usage );
+		if ( memory ) return memory;
+	}
 
-	// Just start at the head if the next free block won't fit
-	if ( b->BlockSize < bytes ) b = Head;
+	return AllocateBlock( filename, line, bytes, usage );
+}
+//---------------------------------------
+void* MemoryPool::AllocateBlock( const char* filename, uint16 line, size_t bytes, uint8 usage )
+{
+	CriticalBlock( gMemoryMutex );
 
 	// Stats
 	++TotalAllocationRequests;
 	AverageAllocationRequested = (uint32) ( ( 0.9f * AverageAllocationRequested ) + ( 0.1f * bytes ) );
 	if ( bytes > LargestAllocationRequest ) LargestAllocationRequest = bytes;
 
-	// Search the linked list for a good spot to allocate
-	// Layout:
-	// NULL
-	// Head
-	// Block1
-	// ...
-	// BlockN
-	// NULL
+	// Keep blocks aligned and big enough to hold the free list links once they are freed
+	uint32 size = std::max( (uint32) ( ( bytes + 15 ) & ~15 ), MinBlockPayload );
 
-	while ( b )
+	// First fit within the bin for this size, otherwise any block from a bigger bin fits
+	Block* b = NULL;
+	uint32 bin = getFreeBin( size );
+	for ( Block* candidate = FreeBins[ bin ]; candidate && !b; candidate = getFreeLinks( candidate )[ 1 ] )
 	{
-		// Found good block
-		if ( b->Free && b->BlockSize >= bytes )
-		{
-			DebugAsssertion( b->BlockSize <= DefaultPoolSize, "BlockSize is larger than Memory Pool!\n" );
-
-			uint32 lastSize = b->BlockSize;
-			BlocksByUsage[ b->UserType ]--;
-			b->BlockSize = bytes;
-			b->FileName = filename;
-			b->LineNumber = line;
-			b->Free = false;
-			b->UserType = usage;
-			b->PrevBlock = n;
-
-			++BlocksAllocated;
-			--BlocksFreed;
-			TotalBytesAllocated += bytes;
-			BlocksByUsage[ usage ]++;
-
-			Block* next = b->NextBlock;
-
-			// Next is tail block, create new tail block
-			// [ head ]    [ head ]
-			// [ .... ] -> | tail |
-			// [ tail ]    | tail |
-			if ( next == NULL )
-			{
-				const uint32 sizeOfNextBlock = lastSize - b->BlockSize;
-				b->NextBlock = (Block*) ( ( (uint8*) b ) + ( BlockSize + b->BlockSize ) );
-
-				// Assert block is in pool
-				DebugAsssertion( (uint8*) b->NextBlock > 0 && (uint8*) b->NextBlock < ( Pool + DefaultPoolSize ), "Tail overruns memory pool!\n" );
-
-				next = b->NextBlock;
-				next->BlockSize = sizeOfNextBlock - BlockSize;
-				next->FileName = 0;
-				next->LineNumber = 0;
-				next->Free = true;
-				next->UserType = 0;
-				next->PrevBlock = b;
-				next->NextBlock = NULL;
-
-				NextFree = next;
-
-				++BlocksFreed;
-				BlocksByUsage[ next->UserType ]++;
-				
-				// Assert tail was successful
-				DebugAsssertion( b->NextBlock->NextBlock == NULL, "Tail block is corrupt!\n" );
-			}
-			// Not tail block
-			else
-			{
-				// Next is free, merge blocks
-				// [ block ]    [ block ]
-				// [ ----  ] -> | free  |
-				// [ free  ]    | free  |
-				if ( next->Free )
-				{
-					b->NextBlock = (Block*) ( (uint8*) b + ( BlockSize + bytes ) );
-
-					Block* newNext = b->NextBlock;
-
-					// Assert block is in pool
-					DebugAsssertion( (uint8*) newNext > 0 && (uint8*) newNext < ( Pool + DefaultPoolSize ), "Bad merge in memory pool!\n" );
+		if ( candidate->BlockSize >= size )
+			b = candidate;
+	}
+	for ( ++bin; bin < FreeBinCount && !b; ++bin )
+	{
+		b = FreeBins[ bin ];
+	}
 
-					newNext->BlockSize = (uint8*) newNext + BlockSize - (uint8*) next + next->BlockSize;
-					newNext->FileName = 0;
-					newNext->LineNumber = 0;
-					newNext->Free = true;
-					newNext->UserType = 0;
-					newNext->PrevBlock = b;
-					newNext->NextBlock = next->NextBlock;
+//	throw std::bad_alloc( "Out of memory. Try increasing default memory pool size." );
+	if ( b == NULL ) return NULL;
 
-					NextFree = newNext;
+	unlinkFreeBlock( b );
+	--BlocksFreed;
+	BlocksByUsage[ b->UserType ]--;
 
-					BlocksByUsage[ newNext->UserType ]++;
-				}
-				// Insert free block
-				// [ block ]    [ block ]
-				// [ ----  ] -> [ free  ]
-				// [ next  ]    [ next  ]
-				else
-				{
-					uint32 freespace = lastSize - b->BlockSize;
-
-					// A new block can be inserted between current and next
-					if ( freespace > BlockSize )
-					{
-						b->NextBlock = (Block*) ( ( (uint8*) b ) + ( BlockSize + b->BlockSize ) );
-						
-						Block* newNext = b->NextBlock;
-
-						// Assert block is in pool
-						DebugAsssertion( (uint8*) newNext > 0 && (uint8*) newNext < ( Pool + DefaultPoolSize ), "Bad insertion in memory pool!\n" );
-
-						newNext->BlockSize = freespace - BlockSize;
-						newNext->FileName = 0;
-						newNext->LineNumber = 0;
-						newNext->Free = true;
-						newNext->UserType = 0;
-						newNext->PrevBlock = b;
-						newNext->NextBlock = next;
-
-						NextFree = newNext;
-
-						++BlocksFreed;
-						BlocksByUsage[ newNext->UserType ]++;
-					}
-					// else Not enough memory (do nothing)
-				}
-			}
-			uint8* _ret = (uint8*) b + BlockSize;
-			// Assert block is in pool
-			DebugAsssertion( _ret > 0 && _ret < ( Pool + DefaultPoolSize ), "Access violation in memory pool!\n" );
-			return _ret;
-		}
+	// Split off the end of the block if it's big enough to be useful
+	// [ b    ]    [ b    ]
+	// [ free ] -> [ rest ]
+	// [ next ]    [ next ]
+	if ( b->BlockSize >= size + BlockSize + MinBlockPayload )
+	{
+		Block* rest = (Block*) ( (uint8*) b + BlockSize + size );
 
-		n = b;
-		b = b->NextBlock;
+		// Assert block is in pool
+		DebugAsssertion( (uint8*) rest < ( Pool + DefaultPoolSize ), "Bad split in memory pool!\n" );
+
+		rest->BlockSize = b->BlockSize - size - BlockSize;
+		rest->FileName = 0;
+		rest->LineNumber = 0;
+		rest->Free = true;
+		rest->UserType = 0;
+		rest->PrevBlock = b;
+		rest->NextBlock = b->NextBlock;
+		if ( rest->NextBlock )
+			rest->NextBlock->PrevBlock = rest;
+
+		b->NextBlock = rest;
+		b->BlockSize = size;
+
+		linkFreeBlock( rest );
+		++BlocksFreed;
+		BlocksByUsage[ rest->UserType ]++;
 	}
 
-//	throw std::bad_alloc( "Out of memory. Try increasing default memory pool size." );
+	b->FileName = filename;
+	b->LineNumber = line;
+	b->Free = false;
+	b->UserType = usage;
+
+	++BlocksAllocated;
+	TotalBytesAllocated += b->BlockSize;
+	BlocksByUsage[ usage ]++;
 
-	// Not reachable but w/e
-	return NULL;
+	return (uint8*) b + BlockSize;
 }
 //---------------------------------------
 void MemoryPool::Free( void* memory )
 {
-	CriticalBlock( gMemoryMutex );
-
 	// Do nothing if memory is null
 	if ( !memory ) return;
 	if ( !Pool ) return;
 
+	if ( isInSlabRegion( memory ) )
+	{
+		freeSmall( memory );
+	}
+	else
+	{
+		FreeBlock( memory );
+	}
+}
+//---------------------------------------
+void MemoryPool::FreeBlock( void* memory )
+{
+	CriticalBlock( gMemoryMutex );
+
 	Block* b = (Block*) ( (uint8*) memory - BlockSize );
 	// Assert block is in pool
-	DebugAsssertion( (uint8*)b > 0 && (uint8*)b < ( Pool + DefaultPoolSize ), "Access violation in memory pool!\n" );
-
-	Block* prev = b->PrevBlock;
-	Block* next = b->NextBlock;
+	DebugAsssertion( (uint8*) b >= Pool + SlabRegionSize && (uint8*) b < ( Pool + DefaultPoolSize ), "Access violation in memory pool!\n" );
+	DebugAsssertion( !b->Free, "Double free in memory pool!\n" );
 
+	// Stats!
+	--BlocksAllocated;
+	TotalBytesAllocated -= b->BlockSize;
 	BlocksByUsage[ b->UserType ]--;
+
 	b->FileName = 0;
 	b->LineNumber = 0;
 	b->Free = true;
 	b->UserType = 0;
 
-	NextFree = b;
-
-	// Stats!
 	++BlocksFreed;
-	--BlocksAllocated;
-	TotalBytesAllocated -= b->BlockSize;
 	BlocksByUsage[ b->UserType ]++;
 
-	// 3 way merge
-	// [ prev  ]    | prev |
-	// [ b     ] -> | prev |
-	// [ next  ]    | prev |
-	if ( prev && next && prev->Free && next->Free )
+	// Merge with next block
+	// [ b    ]    | b |
+	// [ next ] -> | b |
+	Block* next = b->NextBlock;
+	if ( next && next->Free )
 	{
-		BlocksByUsage[ b->UserType ]--;
-		BlocksByUsage[ next->UserType ]--;
-
-		prev->NextBlock = next->NextBlock;
-		if ( next->NextBlock )
-			next->NextBlock->PrevBlock = prev;
-		prev->BlockSize = prev->BlockSize + next->BlockSize + b->BlockSize + 2 * BlockSize;
-
-		NextFree = prev;
+		unlinkFreeBlock( next );
 
-		// Assert block is in pool
-		DebugAsssertion( (uint8*)prev > 0 && (uint8*)prev < ( Pool + DefaultPoolSize ), "Access violation in memory pool!\n" );
+		b->BlockSize += BlockSize + next->BlockSize;
+		b->NextBlock = next->NextBlock;
+		if ( b->NextBlock )
+			b->NextBlock->PrevBlock = b;
 
-		BlocksFreed -= 2;
+		--BlocksFreed;
+		BlocksByUsage[ next->UserType ]--;
 	}
-	else
+
 	// Merge with previous block
-	// [ prev  ]    | prev |
-	// [ b     ] -> | prev |
-	// [ next  ]    [ next ]
+	// [ prev ]    | prev |
+	// [ b    ] -> | prev |
+	Block* prev = b->PrevBlock;
 	if ( prev && prev->Free )
 	{
-		BlocksByUsage[ b->UserType ]--;
-		
-		prev->BlockSize = prev->BlockSize + BlockSize + b->BlockSize;
-		prev->NextBlock = next;
-		next->PrevBlock = prev;
+		unlinkFreeBlock( prev );
 
-		NextFree = prev;
-
-		// Assert block is in pool
-		DebugAsssertion( (uint8*)prev > 0 && (uint8*)prev < ( Pool + DefaultPoolSize ), "Access violation in memory pool!\n" );
+		prev->BlockSize += BlockSize + b->BlockSize;
+		prev->NextBlock = b->NextBlock;
+		if ( prev->NextBlock )
+			prev->NextBlock->PrevBlock = prev;
 
 		--BlocksFreed;
-	}
-	else
-	// Merge with next block
-	// [ prev  ]    [ prev ]
-	// [ b     ] -> | b    |
-	// [ next  ]    | b    |
-	if ( next && next->Free )
-	{
-		BlocksByUsage[ next->UserType ]--;
-
-		b->BlockSize = b->BlockSize + BlockSize + next->BlockSize;
-		b->NextBlock = next->NextBlock;
-		if ( b->NextBlock )
-			b->NextBlock->PrevBlock = b;
-
-		// Assert block is in pool
-		DebugAsssertion( (uint8*)b > 0 && (uint8*)b < ( Pool + DefaultPoolSize ), "Access violation in memory pool!\n" );
+		BlocksByUsage[ b->UserType ]--;
 
-		--BlocksFreed;
+		b = prev;
 	}
+
+	linkFreeBlock( b );
 }
 //---------------------------------------
 void MemoryPool::Free( void* memory, const char*, uint16 )
@@ -369,6 +604,19 @@ void MemoryPool::Free( void* memory, const char*, uint16 )
 	Free( memory );
 }
 //---------------------------------------
+void MemoryPool::ReleaseThreadCache()
+{
+	ThreadCache& cache = gThreadCache;
+
+	for ( uint32 i = 0; i < SizeClassCount; ++i )
+	{
+		if ( cache.FreeCounts[ i ] > 0 )
+			drainThreadCache( cache, i, cache.FreeCounts[ i ] );
+	}
+
+	foldThreadStats( cache );
+}
+//---------------------------------------
 uint32 MemoryPool::GetFreeBlockCount()
 {
 	return BlocksFreed;
@@ -399,6 +647,11 @@ uint32 MemoryPool::GetAverageAllocationRequest()
 	return AverageAllocationRequested;
 }
 //---------------------------------------
+uint32 MemoryPool::GetSlabBytesReserved()
+{
+	return gSpansUsed * SpanSize;
+}
+//---------------------------------------
 
 
 
@@ -414,8 +667,8 @@ const char* ByteDisplay::msSuffixes[] =
 //---------------------------------------
 ByteDisplay::ByteDisplay( uint32 bytes, ByteDisplaySize size )
 	: mSuffixIndex( 0 )
-	, Amount( bytes )
 	, Suffix( msSuffixes[0] )
+	, Amount( bytes )
 {
 	if ( size == SIZE_AUTO )
 	{
@@ -106,6 +106,12 @@ namespace mage
 
 
 	//---------------------------------------
+	// MemoryPool
+	// Requests up to SmallBlockMaxSize bytes are rounded up to a size class and served from slabs: fixed size
+	// spans at the start of the pool that are split into equal blocks. Each thread caches a few free blocks per
+	// size class, so most small allocations and frees don't take a lock. Larger requests (or small ones once the
+	// slab region is full) fall back to the block list covering the rest of the pool, whose free blocks are
+	// binned by size and merged with their neighbors when freed.
 	class MemoryPool
 	{
 	public:
@@ -118,7 +124,27 @@ namespace mage
 			uint16 LineNumber;			// 2
 			bool Free;					// 1
 			uint8 UserType;				// 1
-		}; // 20 bytes
+		}; // 20 bytes (BlockSize pads it to a multiple of 16)
+
+		// Header in front of every slab allocation (padded to SmallBlockHeaderSize)
+		struct SmallBlock
+		{
+			const char* FileName;		// 4
+			uint16 LineNumber;			// 2
+			uint8 UserType;				// 1 (0 while the block is free)
+			uint8 SizeClass;			// 1
+		}; // 8 bytes
+
+		static const uint32 SmallBlockHeaderSize = 16;
+		static const uint32 SmallBlockMaxSize = 256;
+		static const uint32 SizeClassCount = 8;
+		static const uint32 SlabRegionSize = 64 * 1024 * 1024;
+		static const uint32 SpanSize = 64 * 1024;
+		static const uint32 SpanCount = SlabRegionSize / SpanSize;
+		static const uint32 ThreadCacheMaxBlocks = 64;	// Per size class
+		static const uint32 ThreadCacheBatchSize = 32;	// Blocks moved between a thread cache and the shared lists at once
+		static const uint32 FreeBinCount = 32;
+		static const uint32 MinBlockPayload = 32;		// Smallest block the block list will split off
 
 		// Only ever call this once
 		static bool InitializeMemory();
@@ -128,21 +154,28 @@ namespace mage
 		static void* Allocate( const char* filename, uint16 line, size_t bytes, uint8 usage=MEMUSAGE_GENERAL );
 		static void Free( void* memory );
 		static void Free( void* memory, const char*, uint16 );
+		// Give the blocks cached by the calling thread back to the shared lists
+		// Called automatically when a Thread finishes, call it manually for threads created any other way
+		static void ReleaseThreadCache();
 
-		// Statistical info
+		// Statistical info (slab allocations are folded in from each thread in batches, so they can lag slightly)
 		static uint32 GetFreeBlockCount();
 		static uint32 GetAllocatedBlockCount();
 		static uint32 GetTotalAllocationRequests();
 		static uint32 GetTotalBytesAllocated();
 		static uint32 GetLargestAllocationRequested();
 		static uint32 GetAverageAllocationRequest();
+		static uint32 GetSlabBytesReserved();
 
 //	private:	// Public for now... easier to display debug info
+		static void* AllocateBlock( const char* filename, uint16 line, size_t bytes, uint8 usage );
+		static void FreeBlock( void* memory );
+
 		static const uint32 DefaultPoolSize;
 		static const uint8 BlockSize;
 		static uint8* Pool;
-		static Block* Head;								// (Block*) Pool
-		static Block* NextFree;							// Last free block encountered
+		static Block* Head;								// (Block*) ( Pool + SlabRegionSize )
+		static Block* FreeBins[ FreeBinCount ];			// Free blocks by power of two size
 		static uint32 BlocksAllocated;					// Total allocated block count
 		static uint32 BlocksFreed;
 		static uint32 BlocksByUsage[ MEMUSAGE_COUNT ];	// Blocks by usage tag
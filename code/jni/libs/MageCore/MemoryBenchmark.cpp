@@ -0,0 +1,158 @@
+#include "CoreLib.h"
+
+using namespace mage;
+
+namespace
+{
+	//---------------------------------------
+	// Work for one churn thread
+	struct ChurnThreadData
+	{
+		unsigned int Operations;
+		uint32 Seed;
+		bool UseMemoryPool;
+	};
+	//---------------------------------------
+
+
+	//---------------------------------------
+	inline uint32 nextRandom( uint32& state )
+	{
+		// xorshift32
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		return state;
+	}
+	//---------------------------------------
+}
+
+const unsigned int MemoryBenchmark::LIVE_ALLOCATIONS;
+const unsigned int MemoryBenchmark::LARGE_ALLOCATION_RATE;
+const unsigned int MemoryBenchmark::MAX_SMALL_ALLOCATION;
+const unsigned int MemoryBenchmark::MAX_LARGE_ALLOCATION;
+
+//---------------------------------------
+void MemoryBenchmark::Run( unsigned int operationsPerThread, unsigned int maxThreads )
+{
+	if ( maxThreads == 0 )
+	{
+		maxThreads = Thread::GetMaxThreadConcurrency();
+	}
+
+	bool ownsPool = ( MemoryPool::Pool == NULL );
+	if ( ownsPool && !MemoryPool::InitializeMemory() )
+	{
+		ConsolePrintf( CONSOLE_WARNING, "MemoryBenchmark : Could not initialize the MemoryPool\n" );
+		return;
+	}
+
+	ConsolePrintf( CONSOLE_INFO, "MemoryBenchmark : %d operations per thread, %d live allocations per thread, 1 to %d threads\n",
+		operationsPerThread, LIVE_ALLOCATIONS, maxThreads );
+
+	double basePoolRate = 0.0;
+	double baseMallocRate = 0.0;
+
+	for ( unsigned int threadCount = 1; threadCount <= maxThreads; ++threadCount )
+	{
+		double poolRate = MeasureChurn( threadCount, operationsPerThread, true );
+		double mallocRate = MeasureChurn( threadCount, operationsPerThread, false );
+
+		if ( threadCount == 1 )
+		{
+			basePoolRate = poolRate;
+			baseMallocRate = mallocRate;
+		}
+
+		ConsolePrintf( CONSOLE_INFO, "MemoryBenchmark : %d threads : MemoryPool %.2f Mops/s (%.2fx) : malloc %.2f Mops/s (%.2fx)\n",
+			threadCount, poolRate / 1000000.0, poolRate / basePoolRate, mallocRate / 1000000.0, mallocRate / baseMallocRate );
+	}
+
+	ConsolePrintf( CONSOLE_INFO, "MemoryBenchmark : slabs reserved %s, blocks still allocated %d\n",
+		ByteDisplay( MemoryPool::GetSlabBytesReserved() ).ToString(), MemoryPool::GetAllocatedBlockCount() );
+
+	if ( ownsPool )
+	{
+		MemoryPool::TerminateMemory();
+	}
+}
+//---------------------------------------
+double MemoryBenchmark::MeasureChurn( unsigned int threadCount, unsigned int operationsPerThread, bool useMemoryPool )
+{
+	std::vector< ChurnThreadData > threadData( threadCount );
+	std::vector< Thread* > threads( threadCount );
+
+	double startTime = Clock::QueryTime( Clock::TIME_SEC );
+
+	for ( unsigned int i = 0; i < threadCount; ++i )
+	{
+		threadData[ i ].Operations = operationsPerThread;
+		threadData[ i ].Seed = 2463534242U + i * 7919U;
+		threadData[ i ].UseMemoryPool = useMemoryPool;
+		threads[ i ] = new Thread( ChurnThread, &threadData[ i ] );
+	}
+
+	for ( unsigned int i = 0; i < threadCount; ++i )
+	{
+		threads[ i ]->Join();
+		delete threads[ i ];
+	}
+
+	double elapsedSeconds = Clock::QueryTime( Clock::TIME_SEC ) - startTime;
+
+	// Every operation is one allocation and one free
+	return ( (double) threadCount * operationsPerThread ) / elapsedSeconds;
+}
+//---------------------------------------
+void MemoryBenchmark::ChurnThread( void* userData )
+{
+	ChurnThreadData* data = (ChurnThreadData*) userData;
+	uint32 random = data->Seed;
+	void* live[ LIVE_ALLOCATIONS ];
+
+	memset( live, 0, sizeof( live ) );
+
+	for ( unsigned int i = 0; i < data->Operations; ++i )
+	{
+		// Replace a random live allocation with one of a new size
+		unsigned int slot = nextRandom( random ) % LIVE_ALLOCATIONS;
+		uint32 sizeRoll = nextRandom( random );
+		size_t bytes;
+
+		if ( sizeRoll % LARGE_ALLOCATION_RATE == 0 )
+		{
+			bytes = MAX_SMALL_ALLOCATION + 1 + ( sizeRoll >> 4 ) % ( MAX_LARGE_ALLOCATION - MAX_SMALL_ALLOCATION );
+		}
+		else
+		{
+			bytes = 1 + ( sizeRoll >> 4 ) % MAX_SMALL_ALLOCATION;
+		}
+
+		if ( data->UseMemoryPool )
+		{
+			mage_free( live[ slot ] );
+			live[ slot ] = mage_allocate_tagged( bytes, MEMUSAGE_CUSTOM );
+		}
+		else
+		{
+			free( live[ slot ] );
+			live[ slot ] = malloc( bytes );
+		}
+
+		// Touch the memory so the allocation can't be optimized away
+		*(uint8*) live[ slot ] = (uint8) i;
+	}
+
+	for ( unsigned int i = 0; i < LIVE_ALLOCATIONS; ++i )
+	{
+		if ( data->UseMemoryPool )
+		{
+			mage_free( live[ i ] );
+		}
+		else
+		{
+			free( live[ i ] );
+		}
+	}
+}
+//---------------------------------------
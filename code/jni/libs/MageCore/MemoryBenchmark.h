@@ -0,0 +1,29 @@
+/*
+ * Description :
+ *   Stress test for the MemoryPool: threads churn through allocations of mixed sizes, and the throughput is
+ *   compared against malloc as more threads are added.
+ */
+
+#pragma once
+
+namespace mage
+{
+
+	class MemoryBenchmark
+	{
+	public:
+		// Runs the benchmark with 1 to maxThreads threads (0 uses every core) and prints the results
+		// Initializes the MemoryPool if nothing else has, and terminates it again when done
+		static void Run( unsigned int operationsPerThread, unsigned int maxThreads=0 );
+
+	private:
+		static const unsigned int LIVE_ALLOCATIONS = 512;		// Allocations each thread holds on to while churning
+		static const unsigned int LARGE_ALLOCATION_RATE = 16;	// One in this many allocations is too big for the slabs
+		static const unsigned int MAX_SMALL_ALLOCATION = 256;
+		static const unsigned int MAX_LARGE_ALLOCATION = 4096;
+
+		static double MeasureChurn( unsigned int threadCount, unsigned int operationsPerThread, bool useMemoryPool );
+		static void ChurnThread( void* userData );
+	};
+
+}
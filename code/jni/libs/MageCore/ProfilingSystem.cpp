@@ -1,10 +1,108 @@
 #include "CoreLib.h"
 
+#ifdef WIN32
+#	include <Windows.h>		// MemoryBarrier()
+#endif
+
 using namespace mage;
 
+const uint32 ProfilingSystem::MAX_PROFILER_IDS;
+const uint32 ProfilingSystem::TRACE_BUFFER_SIZE;
+const uint32 ProfilingSystem::FRAME_HISTORY_SIZE;
+
 std::vector< ProfilingData > ProfilingSystem::msProfilerData;
 std::map< std::string, int > ProfilingSystem::msTagToIdMap;
 
+volatile bool ProfilingSystem::msIsTracing = false;
+bool ProfilingSystem::msIsInitialized = false;
+uint32 ProfilingSystem::msFrameNumber = 0;
+double ProfilingSystem::msFrameStartTimes[ FRAME_HISTORY_SIZE ];
+
+uint32 ProfilingSystem::msCaptureFirstFrame = 0;
+uint32 ProfilingSystem::msCaptureLastFrame = 0;
+std::string ProfilingSystem::msCaptureFilename;
+
+//---------------------------------------
+// Events recorded by one thread
+// Only the owning thread writes to it, everyone else only reads
+// Events are published by bumping EventCount, with barriers on both sides so a reader that sees the count
+// also sees the events before it, and no write to the next event is seen before the count
+struct TraceBuffer
+{
+	TraceEvent Events[ ProfilingSystem::TRACE_BUFFER_SIZE ];
+	volatile uint32 EventCount;		// Events ever written, the next one goes in Events[ EventCount % TRACE_BUFFER_SIZE ]
+	unsigned int ThreadId;
+	char ThreadName[ 32 ];
+	bool IsOwned;
+};
+//---------------------------------------
+
+// Guards gTraceBuffers and the tag to id map
+static Mutex gProfilerMutex;
+static std::vector< TraceBuffer* > gTraceBuffers;
+
+static THREAD_LOCAL TraceBuffer* gTraceBuffer = NULL;
+static THREAD_LOCAL char gThreadName[ 32 ];
+static THREAD_LOCAL bool gIsMainThread = false;
+
+//---------------------------------------
+// reuseBeforeTime is the start of the oldest frame that can still be exported
+static TraceBuffer* acquireTraceBuffer( double reuseBeforeTime )
+{
+	CriticalBlock( gProfilerMutex );
+
+	// Reuse the buffer of a thread that has exited once none of its events can be exported any more
+	TraceBuffer* buffer = NULL;
+	for ( std::vector< TraceBuffer* >::iterator itr = gTraceBuffers.begin(); itr != gTraceBuffers.end() && !buffer; ++itr )
+	{
+		TraceBuffer* candidate = *itr;
+		uint32 lastEvent = ( candidate->EventCount - 1 ) & ( ProfilingSystem::TRACE_BUFFER_SIZE - 1 );
+
+		if ( !candidate->IsOwned && ( candidate->EventCount == 0 || candidate->Events[ lastEvent ].TimeSeconds < reuseBeforeTime ) )
+			buffer = candidate;
+	}
+
+	if ( !buffer )
+	{
+		buffer = new TraceBuffer;
+		gTraceBuffers.push_back( buffer );
+	}
+
+	buffer->EventCount = 0;
+	buffer->ThreadId = Thread::GetCurrentThreadId();
+	buffer->IsOwned = true;
+
+	if ( gThreadName[ 0 ] )
+		strcpy( buffer->ThreadName, gThreadName );
+	else
+		sprintf( buffer->ThreadName, "Thread %u", buffer->ThreadId );
+
+	gTraceBuffer = buffer;
+	return buffer;
+}
+//---------------------------------------
+static void appendFormat( std::string& out, const char* format, ... )
+{
+	char line[ 256 ];
+	va_list args;
+	va_start( args, format );
+	vsnprintf( line, sizeof( line ), format, args );
+	va_end( args );
+	out += line;
+}
+//---------------------------------------
+// Append one trace_event, timestamps are in microseconds from the start of the exported range
+// extra is added to the event's fields as is
+static void appendTraceEvent( std::string& json, const char* phase, const char* name, unsigned int threadId, double timeMicro, const char* extra="" )
+{
+	if ( json[ json.size() - 1 ] != '[' )
+		json += ",\n";
+
+	appendFormat( json, "{\"name\":\"%s\",\"ph\":\"%s\",\"pid\":1,\"tid\":%u,\"ts\":%.3f%s}", name, phase, threadId, timeMicro, extra );
+}
+//---------------------------------------
+
+
 //---------------------------------------
 ProfilingSystem::ProfilingSystem()
 {}
@@ -12,21 +110,68 @@ ProfilingSystem::ProfilingSystem()
 ProfilingSystem::~ProfilingSystem()
 {}
 //---------------------------------------
+void ProfilingSystem::Initialize()
+{
+	gIsMainThread = true;
+	msIsInitialized = true;
+	SetThreadName( "Main" );
+
+	msFrameNumber = 0;
+	msFrameStartTimes[ 0 ] = Clock::QueryTime();
+}
+//---------------------------------------
 void ProfilingSystem::EndFrame()
 {
 	for ( std::vector< ProfilingData >::iterator itr = msProfilerData.begin(); itr != msProfilerData.end(); ++itr )
 	{
+		if ( itr->FrameTimes && itr->CountPerFrame > 0 )
+		{
+			itr->FrameTimes->AddSample( itr->TotalFrameTimeSeconds );
+		}
+
 		itr->CountPerFrame = 0;
 		itr->TotalFrameTimeSeconds = 0.0;
 	}
+
+	++msFrameNumber;
+	msFrameStartTimes[ msFrameNumber % FRAME_HISTORY_SIZE ] = Clock::QueryTime();
+
+	// Write out a pending capture once its last frame is done
+	if ( !msCaptureFilename.empty() && msFrameNumber > msCaptureLastFrame )
+	{
+		std::string json;
+
+		if ( ExportChromeTrace( msCaptureFirstFrame, msCaptureLastFrame, json ) &&
+			 WriteDataFile( msCaptureFilename.c_str(), json.c_str(), json.size() ) == (int) json.size() )
+		{
+			ConsolePrintf( CONSOLE_INFO, "ProfilingSystem : Wrote frames %u to %u to '%s'\n", msCaptureFirstFrame, msCaptureLastFrame, msCaptureFilename.c_str() );
+		}
+		else
+		{
+			ConsolePrintf( CONSOLE_WARNING, "ProfilingSystem : Failed to write trace '%s'\n", msCaptureFilename.c_str() );
+		}
+
+		msCaptureFilename.clear();
+		SetTracingEnabled( false );
+	}
 }
 //---------------------------------------
 int ProfilingSystem::GetIdFromName( const std::string& tag )
 {
+	CriticalBlock( gProfilerMutex );
+
+	// Never reallocate, other threads may be reading the data while a new tag is added
+	if ( msProfilerData.capacity() < MAX_PROFILER_IDS )
+	{
+		msProfilerData.reserve( MAX_PROFILER_IDS );
+	}
+
 	int id;
 	std::map< std::string, int >::const_iterator found = msTagToIdMap.find( tag );
 	if ( found == msTagToIdMap.end() )
 	{
+		assertion( msProfilerData.size() < MAX_PROFILER_IDS, "ProfilingSystem: Too many profiler tags (adding '%s')\n", tag.c_str() );
+
 		id = msProfilerData.size();
 		msTagToIdMap[ tag ] = msProfilerData.size();
 		msProfilerData.push_back( ProfilingData( tag ) );
@@ -44,11 +189,238 @@ ProfilingData& ProfilingSystem::GetDataFromId( int id )
 	return msProfilerData[ id ];
 }
 //---------------------------------------
+void ProfilingSystem::SetCounter( int id, double value )
+{
+	RecordEvent( TraceEvent::TRACE_COUNTER, id, Clock::QueryTime(), value );
+
+	if ( IsMainThread() )
+	{
+		ProfilingData& data = msProfilerData[ id ];
+		data.CounterValue = value;
+
+		if ( value > data.MaxCounterValue )
+		{
+			data.MaxCounterValue = value;
+		}
+	}
+}
+//---------------------------------------
 const std::vector< ProfilingData >& ProfilingSystem::GetProfilerData()
 {
 	return msProfilerData;
 }
 //---------------------------------------
+void ProfilingSystem::TrackFrameTimes( const std::string& tag, double hitchThresholdSeconds )
+{
+	ProfilingData& data = msProfilerData[ GetIdFromName( tag ) ];
+
+	// Kept for as long as the tag is, which is forever
+	if ( !data.FrameTimes )
+	{
+		data.FrameTimes = new FrameTimeHistogram( hitchThresholdSeconds );
+	}
+}
+//---------------------------------------
+void ProfilingSystem::SetThreadName( const char* name )
+{
+	strncpy( gThreadName, name, sizeof( gThreadName ) - 1 );
+
+	if ( gTraceBuffer )
+	{
+		CriticalBlock( gProfilerMutex );
+		strcpy( gTraceBuffer->ThreadName, gThreadName );
+	}
+}
+//---------------------------------------
+void ProfilingSystem::ReleaseThreadBuffer()
+{
+	if ( gTraceBuffer )
+	{
+		CriticalBlock( gProfilerMutex );
+		gTraceBuffer->IsOwned = false;
+		gTraceBuffer = NULL;
+	}
+}
+//---------------------------------------
+void ProfilingSystem::SetTracingEnabled( bool enabled )
+{
+	msIsTracing = enabled;
+}
+//---------------------------------------
+bool ProfilingSystem::IsTracingEnabled()
+{
+	return msIsTracing;
+}
+//---------------------------------------
+uint32 ProfilingSystem::GetFrameNumber()
+{
+	return msFrameNumber;
+}
+//---------------------------------------
+bool ProfilingSystem::ExportChromeTrace( uint32 firstFrame, uint32 lastFrame, std::string& json )
+{
+	// Both ends of the range must still be in the frame history
+	bool isInHistory = ( firstFrame <= lastFrame && lastFrame < msFrameNumber && msFrameNumber - firstFrame < FRAME_HISTORY_SIZE );
+
+	if ( isInHistory )
+	{
+		double startTime = msFrameStartTimes[ firstFrame % FRAME_HISTORY_SIZE ];
+		double endTime = msFrameStartTimes[ ( lastFrame + 1 ) % FRAME_HISTORY_SIZE ];
+		double rangeMicro = ( endTime - startTime ) * 1000000.0;
+
+		json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+		// Frame markers
+		for ( uint32 frame = firstFrame; frame <= lastFrame; ++frame )
+		{
+			char name[ 32 ];
+			sprintf( name, "Frame %u", frame );
+			appendTraceEvent( json, "i", name, 0, ( msFrameStartTimes[ frame % FRAME_HISTORY_SIZE ] - startTime ) * 1000000.0, ",\"s\":\"g\"" );
+		}
+
+		CriticalBlock( gProfilerMutex );
+
+		std::vector< TraceEvent > events;
+		std::vector< int > openSections;
+
+		for ( std::vector< TraceBuffer* >::iterator itr = gTraceBuffers.begin(); itr != gTraceBuffers.end(); ++itr )
+		{
+			TraceBuffer* buffer = *itr;
+
+			// Copy the events, then drop any the thread may have overwritten while they were being copied
+			uint32 eventCount = buffer->EventCount;
+			uint32 firstEvent = eventCount > TRACE_BUFFER_SIZE ? eventCount - TRACE_BUFFER_SIZE : 0;
+			MEMORY_BARRIER();
+
+			events.clear();
+			for ( uint32 i = firstEvent; i < eventCount; ++i )
+			{
+				events.push_back( buffer->Events[ i & ( TRACE_BUFFER_SIZE - 1 ) ] );
+			}
+
+			MEMORY_BARRIER();
+			uint32 countAfterCopy = buffer->EventCount;
+			if ( countAfterCopy >= TRACE_BUFFER_SIZE && countAfterCopy - TRACE_BUFFER_SIZE + 1 > firstEvent )
+			{
+				uint32 overwritten = std::min( countAfterCopy - TRACE_BUFFER_SIZE + 1 - firstEvent, (uint32) events.size() );
+				events.erase( events.begin(), events.begin() + overwritten );
+			}
+
+			if ( !events.empty() && firstEvent > 0 && events.front().TimeSeconds > startTime )
+			{
+				ConsolePrintf( CONSOLE_WARNING, "ProfilingSystem : Trace buffer for '%s' overflowed, the start of the trace is missing\n", buffer->ThreadName );
+			}
+
+			json += ",\n";
+			appendFormat( json, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}}", buffer->ThreadId, buffer->ThreadName );
+
+			// Sections still open at the start of the range are begun at its start, and ones still open
+			// at its end are ended there
+			openSections.clear();
+			bool isInRange = false;
+
+			for ( std::vector< TraceEvent >::iterator event = events.begin(); event != events.end() && event->TimeSeconds < endTime; ++event )
+			{
+				if ( !isInRange && event->TimeSeconds >= startTime )
+				{
+					isInRange = true;
+					for ( std::vector< int >::iterator open = openSections.begin(); open != openSections.end(); ++open )
+					{
+						appendTraceEvent( json, "B", msProfilerData[ *open ].Tag.c_str(), buffer->ThreadId, 0.0 );
+					}
+				}
+
+				double timeMicro = ( event->TimeSeconds - startTime ) * 1000000.0;
+				const char* name = msProfilerData[ event->Id ].Tag.c_str();
+
+				if ( event->Type == TraceEvent::TRACE_BEGIN )
+				{
+					openSections.push_back( event->Id );
+					if ( isInRange )
+						appendTraceEvent( json, "B", name, buffer->ThreadId, timeMicro );
+				}
+				// An end without a begin started before the buffer did
+				else if ( event->Type == TraceEvent::TRACE_END && !openSections.empty() )
+				{
+					openSections.pop_back();
+					if ( isInRange )
+						appendTraceEvent( json, "E", name, buffer->ThreadId, timeMicro );
+				}
+				else if ( event->Type == TraceEvent::TRACE_COUNTER && isInRange )
+				{
+					char args[ 64 ];
+					sprintf( args, ",\"args\":{\"value\":%g}", event->Value );
+					appendTraceEvent( json, "C", name, buffer->ThreadId, timeMicro, args );
+				}
+			}
+
+			// Sections that span the whole range
+			if ( !isInRange )
+			{
+				for ( std::vector< int >::iterator open = openSections.begin(); open != openSections.end(); ++open )
+				{
+					appendTraceEvent( json, "B", msProfilerData[ *open ].Tag.c_str(), buffer->ThreadId, 0.0 );
+				}
+			}
+
+			for ( size_t i = openSections.size(); i > 0; --i )
+			{
+				appendTraceEvent( json, "E", msProfilerData[ openSections[ i - 1 ] ].Tag.c_str(), buffer->ThreadId, rangeMicro );
+			}
+		}
+
+		json += "\n]}\n";
+	}
+
+	return isInHistory;
+}
+//---------------------------------------
+void ProfilingSystem::CaptureFrames( uint32 frameCount, const std::string& filename )
+{
+	// The whole capture has to fit in the frame history
+	frameCount = std::min( std::max( frameCount, 1U ), FRAME_HISTORY_SIZE - 1 );
+
+	// The current frame has already started, so begin with the next one
+	msCaptureFirstFrame = msFrameNumber + 1;
+	msCaptureLastFrame = msFrameNumber + frameCount;
+	msCaptureFilename = filename;
+	SetTracingEnabled( true );
+
+	ConsolePrintf( CONSOLE_INFO, "ProfilingSystem : Capturing a trace of the next %u frames\n", frameCount );
+}
+//---------------------------------------
+void ProfilingSystem::RecordEvent( TraceEvent::EventType type, int id, double timeSeconds, double value )
+{
+	if ( msIsTracing )
+	{
+		TraceBuffer* buffer = gTraceBuffer;
+		if ( !buffer )
+		{
+			uint32 oldestFrame = msFrameNumber >= FRAME_HISTORY_SIZE ? msFrameNumber - FRAME_HISTORY_SIZE + 1 : 0;
+			buffer = acquireTraceBuffer( msFrameStartTimes[ oldestFrame % FRAME_HISTORY_SIZE ] );
+		}
+
+		// The slot may hold an event that is still being exported, don't start overwriting it before the last event is published
+		MEMORY_BARRIER();
+
+		TraceEvent& event = buffer->Events[ buffer->EventCount & ( TRACE_BUFFER_SIZE - 1 ) ];
+		event.TimeSeconds = timeSeconds;
+		event.Value = value;
+		event.Id = id;
+		event.Type = type;
+
+		// Publish the event once all of it has been written
+		MEMORY_BARRIER();
+		buffer->EventCount = buffer->EventCount + 1;
+	}
+}
+//---------------------------------------
+bool ProfilingSystem::IsMainThread()
+{
+	// Without Initialize() there is no way to tell, so every thread counts
+	return gIsMainThread || !msIsInitialized;
+}
+//---------------------------------------
 
 
 //---------------------------------------
@@ -56,22 +428,30 @@ Profiler::Profiler( int id )
 	: mId( id )
 {
 	mStartTimeSeconds = Clock::QueryTime();
+	ProfilingSystem::RecordEvent( TraceEvent::TRACE_BEGIN, id, mStartTimeSeconds );
 }
 //---------------------------------------
 Profiler::~Profiler()
 {
-	ProfilingData& data = ProfilingSystem::GetDataFromId( mId );
-	double deltaSeconds = Clock::QueryTime() - mStartTimeSeconds;
-
-	data.TotalTimeSeconds += deltaSeconds;
-	data.TotalFrameTimeSeconds += deltaSeconds;
-	data.AverageFrameTimeSeconds = ( 0.9 * data.AverageFrameTimeSeconds ) + ( 0.1 * deltaSeconds );
-	data.CountPerFrame++;
-	data.Count++;
+	double endTimeSeconds = Clock::QueryTime();
+	ProfilingSystem::RecordEvent( TraceEvent::TRACE_END, mId, endTimeSeconds );
 
-	if ( data.TotalFrameTimeSeconds > data.MaxTimeEver )
+	// The per tag stats aren't thread safe, other threads only show up in traces
+	if ( ProfilingSystem::IsMainThread() )
 	{
-		data.MaxTimeEver = data.TotalFrameTimeSeconds;
+		ProfilingData& data = ProfilingSystem::GetDataFromId( mId );
+		double deltaSeconds = endTimeSeconds - mStartTimeSeconds;
+
+		data.TotalTimeSeconds += deltaSeconds;
+		data.TotalFrameTimeSeconds += deltaSeconds;
+		data.AverageFrameTimeSeconds = ( 0.9 * data.AverageFrameTimeSeconds ) + ( 0.1 * deltaSeconds );
+		data.CountPerFrame++;
+		data.Count++;
+
+		if ( data.TotalFrameTimeSeconds > data.MaxTimeEver )
+		{
+			data.MaxTimeEver = data.TotalFrameTimeSeconds;
+		}
 	}
 }
 //---------------------------------------
@@ -86,6 +466,9 @@ ProfilingData::ProfilingData( const std::string& tag )
 	, MaxTimeEver( 0.0 )
 	, Count( 0 )
 	, CountPerFrame( 0 )
+	, CounterValue( 0.0 )
+	, MaxCounterValue( 0.0 )
+	, FrameTimes( NULL )
 {}
 //---------------------------------------
 double ProfilingData::GetAverageTime() const
@@ -93,4 +476,4 @@ double ProfilingData::GetAverageTime() const
 	if ( Count == 0 ) return 0.0;
 	return TotalTimeSeconds / Count;
 }
-//---------------------------------------
\ No newline at end of file
+//---------------------------------------
@@ -2,9 +2,11 @@
  * Author      : Matthew Johnson
  * Date        : 3/Jun/2013
  * Description :
- *   
+ *   Scoped timers and counters. Sections on the main thread are summed up per tag, and while tracing is
+ *   enabled every section on every thread is also recorded so a range of frames can be exported as a
+ *   Chrome trace (chrome://tracing).
  */
- 
+
 #pragma once
 
 #define PROFILING_ENABLED
@@ -12,18 +14,26 @@
 #ifdef PROFILING_ENABLED
 #	define ProfileSection( TAG )												\
 	static int TAG##PROFILER_ID = ProfilingSystem::GetIdFromName( #TAG );		\
-	Profiler p( TAG##PROFILER_ID );											
+	Profiler TAG##Profiler( TAG##PROFILER_ID );
 
 #	define BeginProfilingSection( TAG )											\
 		static int TAG##PROFILER_ID = ProfilingSystem::GetIdFromName( #TAG );	\
 		{																		\
-		Profiler p( TAG##PROFILER_ID );											
+		Profiler TAG##Profiler( TAG##PROFILER_ID );
 
 #	define EndProfilingSection( TAG )											\
 		}
+
+#	define ProfileCounter( TAG, VALUE )											\
+	{																			\
+		static int TAG##PROFILER_ID = ProfilingSystem::GetIdFromName( #TAG );	\
+		ProfilingSystem::SetCounter( TAG##PROFILER_ID, VALUE );					\
+	}
 #else
+#	define ProfileSection( TAG )
 #	define BeginProfilingSection( TAG )
 #	define EndProfilingSection( TAG )
+#	define ProfileCounter( TAG, VALUE )
 #endif
 
 namespace mage
@@ -50,24 +60,85 @@ namespace mage
 		double MaxTimeEver;
 		int Count;
 		int CountPerFrame;
+		double CounterValue;
+		double MaxCounterValue;
+		// Time per frame over the last frames, only for tags passed to TrackFrameTimes()
+		FrameTimeHistogram* FrameTimes;
 
 		double GetAverageTime() const;
 	};
 
+	// One record in a thread's trace buffer
+	struct TraceEvent
+	{
+		enum EventType
+		{
+			TRACE_BEGIN,
+			TRACE_END,
+			TRACE_COUNTER
+		};
+
+		double TimeSeconds;
+		double Value;
+		int Id;
+		int Type;
+	};
+
 	class ProfilingSystem
 	{
 		ProfilingSystem();
 	public:
+		static const uint32 MAX_PROFILER_IDS = 512;
+		static const uint32 TRACE_BUFFER_SIZE = 8192;		// Events kept per thread (power of two), older ones are overwritten
+		static const uint32 FRAME_HISTORY_SIZE = 256;		// Frames whose start times are kept for exporting
+
 		~ProfilingSystem();
 
+		// Call from the main thread before anything is profiled
+		// Only sections that run on the main thread are added up into the ProfilingData
+		static void Initialize();
 		static void EndFrame();
 		static int GetIdFromName( const std::string& tag );
 		static ProfilingData& GetDataFromId( int id );
+		// Record a value measured this frame (memory used, object counts...) instead of a time
+		static void SetCounter( int id, double value );
 		static const std::vector< ProfilingData >& GetProfilerData();
+		// Keep a FrameTimeHistogram of the tag's total time in each frame it runs
+		static void TrackFrameTimes( const std::string& tag, double hitchThresholdSeconds );
+
+		// Name shown for the calling thread in exported traces
+		static void SetThreadName( const char* name );
+		// Called when a thread exits so its trace buffer can be given to a new thread
+		static void ReleaseThreadBuffer();
+
+		// Tracing
+		static void SetTracingEnabled( bool enabled );
+		static bool IsTracingEnabled();
+		// Number of the frame currently running, counted from Initialize()
+		static uint32 GetFrameNumber();
+		// Build Chrome trace_event JSON for frames firstFrame to lastFrame (inclusive)
+		// Returns false if those frames haven't finished or are too old to be in the frame history
+		// Events that have already been overwritten in a thread's buffer are missing from the trace
+		static bool ExportChromeTrace( uint32 firstFrame, uint32 lastFrame, std::string& json );
+		// Enable tracing, then write the next frameCount frames to filename (in the data path) once they have run
+		static void CaptureFrames( uint32 frameCount, const std::string& filename );
+
+		// Used by Profiler
+		static void RecordEvent( TraceEvent::EventType type, int id, double timeSeconds, double value=0.0 );
+		static bool IsMainThread();
 
 	private:
 		static std::vector< ProfilingData > msProfilerData;
 		static std::map< std::string, int > msTagToIdMap;
+
+		static volatile bool msIsTracing;
+		static bool msIsInitialized;
+		static uint32 msFrameNumber;
+		static double msFrameStartTimes[ FRAME_HISTORY_SIZE ];
+
+		static uint32 msCaptureFirstFrame;
+		static uint32 msCaptureLastFrame;
+		static std::string msCaptureFilename;
 	};
 
-}
\ No newline at end of file
+}
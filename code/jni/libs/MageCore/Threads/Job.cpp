@@ -6,6 +6,7 @@ using namespace mage;
 Job::Job( JobPriority priority, JobType jobType )
 	: mPriority( priority )
 	, mJobType( jobType )
+	, mIsAutoDeleted( true )
 {}
 //---------------------------------------
 Job::~Job()
@@ -21,7 +21,8 @@ namespace mage
 			JP_AVERAGE,
 			JP_ABOVE_AVERAGE,
 			JP_HIGH,
-			JP_HIGHEST
+			JP_HIGHEST,
+			JP_COUNT
 		};
 
 		enum JobType
@@ -39,6 +40,8 @@ namespace mage
 
 		JobType     GetJobType()     const { return mJobType;  }
 		JobPriority GetJobPriority() const { return mPriority; }
+		// Auto deleted jobs are signaled and deleted by JobManager::OnUpdate() once they have executed
+		bool        IsAutoDeleted()  const { return mIsAutoDeleted; }
 
 		bool operator< ( const Job& other ) const
 		{
@@ -48,6 +51,7 @@ namespace mage
 	protected:
 		JobPriority mPriority;
 		JobType mJobType;
+		bool mIsAutoDeleted;
 	};
 
 }
\ No newline at end of file
@@ -0,0 +1,214 @@
+#include "CoreLib.h"
+
+using namespace mage;
+
+namespace
+{
+	//---------------------------------------
+	// Counts down as jobs finish and wakes the benchmark when they are all done
+	struct JobCountdown
+	{
+		JobCountdown( unsigned int count )
+			: Remaining( count )
+		{}
+
+		void Signal()
+		{
+			bool isDone;
+
+			BeginCriticalSection( CountMutex );
+			--Remaining;
+			isDone = ( Remaining == 0 );
+			EndCriticalSection();
+
+			if ( isDone )
+			{
+				Done.Post();
+			}
+		}
+
+		unsigned int Remaining;
+		Mutex CountMutex;
+		Semaphore Done;
+	};
+	//---------------------------------------
+
+
+	//---------------------------------------
+	// Records when a worker first started running the job
+	class PickupJob
+		: public Job
+	{
+	public:
+		PickupJob( double* startTime, JobCountdown* countdown )
+			: mStartTime( startTime )
+			, mCountdown( countdown )
+		{}
+
+		void OnExecute()
+		{
+			*mStartTime = Clock::QueryTime( Clock::TIME_MICRO );
+			mCountdown->Signal();
+		}
+
+		void OnCompletetion() {}
+
+	private:
+		double* mStartTime;
+		JobCountdown* mCountdown;
+	};
+	//---------------------------------------
+
+
+	//---------------------------------------
+	// A fixed amount of arithmetic
+	float DoWork( float value, unsigned int iterations )
+	{
+		for ( unsigned int i = 0; i < iterations; ++i )
+		{
+			value = value * 1.0001f + 0.5f;
+		}
+		return value;
+	}
+	//---------------------------------------
+
+
+	//---------------------------------------
+	// Work that can't be optimized away
+	class WorkJob
+		: public Job
+	{
+	public:
+		WorkJob( unsigned int iterations, JobCountdown* countdown )
+			: mIterations( iterations )
+			, mResult( 1.0f )
+			, mCountdown( countdown )
+		{}
+
+		void OnExecute()
+		{
+			mResult = DoWork( mResult, mIterations );
+			mCountdown->Signal();
+		}
+
+		void OnCompletetion() {}
+
+	private:
+		unsigned int mIterations;
+		volatile float mResult;
+		JobCountdown* mCountdown;
+	};
+	//---------------------------------------
+}
+
+
+//---------------------------------------
+const unsigned int JobBenchmark::LATENCY_SAMPLE_COUNT;
+const unsigned int JobBenchmark::ITERATIONS_PER_JOB;
+const int JobBenchmark::PARALLEL_FOR_GRAIN;
+//---------------------------------------
+void JobBenchmark::Run( unsigned int jobCount, unsigned int maxWorkers )
+{
+	if ( maxWorkers == 0 )
+	{
+		maxWorkers = Thread::GetMaxThreadConcurrency();
+	}
+
+	JobManager::CreateJobManager();
+	JobManager* jobManager = JobManager::GetInstance();
+
+	ConsolePrintf( CONSOLE_INFO, "JobBenchmark : %d jobs of %d iterations, 1 to %d workers\n", jobCount, ITERATIONS_PER_JOB, maxWorkers );
+
+	double baseJobsPerSecond = 0.0;
+	double baseItemsPerSecond = 0.0;
+
+	for ( unsigned int workerCount = 1; workerCount <= maxWorkers; ++workerCount )
+	{
+		jobManager->SetMaxWorkerThreads( workerCount );
+
+		double averageLatency, maxLatency;
+		MeasurePickupLatency( averageLatency, maxLatency );
+
+		double jobsPerSecond = MeasureThroughput( jobCount );
+		double itemsPerSecond = MeasureParallelFor( jobCount );
+
+		if ( workerCount == 1 )
+		{
+			baseJobsPerSecond = jobsPerSecond;
+			baseItemsPerSecond = itemsPerSecond;
+		}
+
+		ConsolePrintf( CONSOLE_INFO, "JobBenchmark : %d workers : pickup %.1f us avg, %.1f us max : %.0f jobs/s (%.2fx) : ParallelFor %.0f items/s (%.2fx)\n",
+			workerCount, averageLatency, maxLatency, jobsPerSecond, jobsPerSecond / baseJobsPerSecond, itemsPerSecond, itemsPerSecond / baseItemsPerSecond );
+	}
+
+	JobManager::DestroyJobManager();
+}
+//---------------------------------------
+void JobBenchmark::MeasurePickupLatency( double& averageMicroseconds, double& maxMicroseconds )
+{
+	JobManager* jobManager = JobManager::GetInstance();
+	double totalMicroseconds = 0.0;
+	maxMicroseconds = 0.0;
+
+	for ( unsigned int i = 0; i < LATENCY_SAMPLE_COUNT; ++i )
+	{
+		// Give the workers time to run out of work and park, so each sample includes a wakeup
+		Thread::Sleep( 1 );
+
+		JobCountdown countdown( 1 );
+		double startTime = 0.0;
+		double pushTime = Clock::QueryTime( Clock::TIME_MICRO );
+		jobManager->PushJob( new PickupJob( &startTime, &countdown ) );
+		countdown.Done.Wait();
+
+		double latency = startTime - pushTime;
+		totalMicroseconds += latency;
+		maxMicroseconds = std::max( maxMicroseconds, latency );
+	}
+
+	averageMicroseconds = totalMicroseconds / LATENCY_SAMPLE_COUNT;
+
+	// Delete the finished jobs
+	jobManager->OnUpdate();
+}
+//---------------------------------------
+double JobBenchmark::MeasureThroughput( unsigned int jobCount )
+{
+	JobManager* jobManager = JobManager::GetInstance();
+	JobCountdown countdown( jobCount );
+
+	double startTime = Clock::QueryTime( Clock::TIME_SEC );
+
+	for ( unsigned int i = 0; i < jobCount; ++i )
+	{
+		jobManager->PushJob( new WorkJob( ITERATIONS_PER_JOB, &countdown ) );
+	}
+	countdown.Done.Wait();
+
+	double elapsedTime = Clock::QueryTime( Clock::TIME_SEC ) - startTime;
+
+	// Delete the finished jobs
+	jobManager->OnUpdate();
+
+	return ( elapsedTime > 0.0 ? jobCount / elapsedTime : 0.0 );
+}
+//---------------------------------------
+double JobBenchmark::MeasureParallelFor( unsigned int itemCount )
+{
+	std::vector< float > results( itemCount, 1.0f );
+	float* values = &results[ 0 ];
+
+	double startTime = Clock::QueryTime( Clock::TIME_SEC );
+
+	// The same work as MeasureThroughput, split into chunks instead of one job per item
+	ParallelFor( 0, (int) itemCount, PARALLEL_FOR_GRAIN, [ values ]( int i )
+	{
+		values[ i ] = DoWork( values[ i ], ITERATIONS_PER_JOB );
+	});
+
+	double elapsedTime = Clock::QueryTime( Clock::TIME_SEC ) - startTime;
+
+	return ( elapsedTime > 0.0 ? itemCount / elapsedTime : 0.0 );
+}
+//---------------------------------------
@@ -0,0 +1,29 @@
+/*
+ * Description :
+ *   Measures how quickly the JobManager picks up new jobs and how throughput (of separate jobs and of
+ *   ParallelFor) scales with the number of workers.
+ */
+ 
+#pragma once
+
+namespace mage
+{
+
+	class JobBenchmark
+	{
+	public:
+		// Runs the benchmark with 1 to maxWorkers workers (0 uses every core) and prints the results
+		// The benchmark creates and destroys its own JobManager, so no other JobManager may exist while it runs
+		static void Run( unsigned int jobCount, unsigned int maxWorkers=0 );
+
+	private:
+		static const unsigned int LATENCY_SAMPLE_COUNT = 200;
+		static const unsigned int ITERATIONS_PER_JOB = 20000;
+		static const int PARALLEL_FOR_GRAIN = 16;
+
+		static void MeasurePickupLatency( double& averageMicroseconds, double& maxMicroseconds );
+		static double MeasureThroughput( unsigned int jobCount );
+		static double MeasureParallelFor( unsigned int itemCount );
+	};
+
+}
@@ -17,17 +17,142 @@ JobManager* JobManager::GetInstance()
 	return msJobManager;
 }
 //---------------------------------------
+bool JobManager::HasInstance()
+{
+	return msJobManager != NULL;
+}
+//---------------------------------------
 void JobManager::DestroyJobManager()
 {
-	msJobManager->DestroyAllWorkers();
+	// Workers are joined before they are deleted, so nothing else can touch the JobManager afterwards
+	Delete0( msJobManager );
+}
+//---------------------------------------
+
+
+//---------------------------------------
+// Job Queue
+void JobManager::JobQueue::Push( Job* job )
+{
+	CriticalBlock( QueueMutex );
+
+	Lanes[ job->GetJobType() ][ job->GetJobPriority() ].push_back( job );
+	++JobCount;
+}
+//---------------------------------------
+Job* JobManager::JobQueue::PopOldest( Job::JobType jobType )
+{
+	Job* job = NULL;
+
+	BeginCriticalSection( QueueMutex );
+
+	if ( JobCount > 0 )
+	{
+		for ( int priority = Job::JP_COUNT - 1; priority >= 0; --priority )
+		{
+			std::deque< Job* >& lane = Lanes[ jobType ][ priority ];
+
+			if ( !lane.empty() )
+			{
+				job = lane.front();
+				lane.pop_front();
+				--JobCount;
+				break;
+			}
+		}
+	}
+
+	EndCriticalSection();
+
+	return job;
+}
+//---------------------------------------
+Job* JobManager::JobQueue::PopNewest( Job::JobType jobType )
+{
+	Job* job = NULL;
+
+	BeginCriticalSection( QueueMutex );
+
+	if ( JobCount > 0 )
+	{
+		for ( int priority = Job::JP_COUNT - 1; priority >= 0; --priority )
+		{
+			std::deque< Job* >& lane = Lanes[ jobType ][ priority ];
+
+			if ( !lane.empty() )
+			{
+				job = lane.back();
+				lane.pop_back();
+				--JobCount;
+				break;
+			}
+		}
+	}
+
+	EndCriticalSection();
+
+	return job;
+}
+//---------------------------------------
+bool JobManager::JobQueue::HasJobs( Job::JobType jobType )
+{
+	bool hasJobs = false;
+
+	BeginCriticalSection( QueueMutex );
+
+	for ( int priority = 0; priority < Job::JP_COUNT && !hasJobs && JobCount > 0; ++priority )
+	{
+		hasJobs = !Lanes[ jobType ][ priority ].empty();
+	}
+
+	EndCriticalSection();
+
+	return hasJobs;
+}
+//---------------------------------------
+void JobManager::JobQueue::RemoveAll( std::vector< Job* >& jobs )
+{
+	CriticalBlock( QueueMutex );
+
+	for ( int i = 0; i < Job::JOB_TYPE_COUNT; ++i )
+	{
+		for ( int priority = 0; priority < Job::JP_COUNT; ++priority )
+		{
+			std::deque< Job* >& lane = Lanes[ i ][ priority ];
+			jobs.insert( jobs.end(), lane.begin(), lane.end() );
+			lane.clear();
+		}
+	}
+	JobCount = 0;
+}
+//---------------------------------------
+void JobManager::JobQueue::DestroyAll( Job::JobType jobType )
+{
+	CriticalBlock( QueueMutex );
+
+	for ( int priority = 0; priority < Job::JP_COUNT; ++priority )
+	{
+		std::deque< Job* >& lane = Lanes[ jobType ][ priority ];
+		auto keptEnd = lane.begin();
 
-	// If we REALLY want to clean up memory before exiting we would delete the JobManager.
-	// But then we need to make sure all the works are done with jobs (and dead) to avoid cross thread
-	// access violations.
-	//Delete0( msJobManager );
+		for ( auto itr = lane.begin(); itr != lane.end(); ++itr )
+		{
+			if ( (*itr)->IsAutoDeleted() )
+			{
+				delete *itr;
+			}
+			else
+			{
+				*keptEnd++ = *itr;
+			}
+		}
+		JobCount -= ( lane.end() - keptEnd );
+		lane.erase( keptEnd, lane.end() );
+	}
 }
 //---------------------------------------
 
+
 //---------------------------------------
 // Worker Thread
 void JobManager::_worker_function( void* pWorker )
@@ -35,32 +160,36 @@ void JobManager::_worker_function( void* pWorker )
 	Worker* worker = (Worker*) pWorker;
 	JobManager* jobManager = JobManager::GetInstance();
 
-	while ( worker->Alive )
+	char threadName[ 32 ];
+	sprintf( threadName, "Worker %u", worker->Index );
+	ProfilingSystem::SetThreadName( threadName );
+
+	while ( !jobManager->mStopWorkers )
 	{
 		// Try to get a job
-		worker->CurrentJob = jobManager->AquireNextJob( worker->MyPerferedJobType );
-		
-		// Wait a bit before trying to get another job
-		if ( !worker->CurrentJob )
+		Job* job = jobManager->AquireNextJob( worker );
+
+		if ( job )
 		{
-			Thread::Sleep( 100 );
+			jobManager->ExecuteJob( job );
 		}
-		else
+		// Sleep until a job is pushed for us
+		else if ( !jobManager->ParkWorker( worker ) )
 		{
-			worker->CurrentJob->OnExecute();
-			jobManager->SubmitCompletedJob( worker->CurrentJob );
+			break;
 		}
 	}
-
-	delete worker;
 }
 //---------------------------------------
 
 
 //---------------------------------------
 JobManager::JobManager()
+	: mNextWorkerIndex( 0 )
+	, mStopWorkers( false )
 {
-	mMaxNumberOfWorkers = 0;//Thread::GetMaxThreadConcurrency();
+	// Leave a core for the main thread
+	mMaxNumberOfWorkers = Thread::GetMaxThreadConcurrency() - 1;
 
 	if ( mMaxNumberOfWorkers == 0 )
 	{
@@ -68,221 +197,364 @@ JobManager::JobManager()
 	}
 	else
 	{
-		ConsolePrintf( CONSOLE_INFO, "JobManager : Max concurrent threads is %d.\n", mMaxNumberOfWorkers );
+		ConsolePrintf( CONSOLE_INFO, "JobManager : Using %d worker threads.\n", mMaxNumberOfWorkers );
 	}
 }
 //---------------------------------------
 JobManager::~JobManager()
 {
 	DestroyAllWorkers();
+	DestroyAllPendingJobs();
 }
 //---------------------------------------
 void JobManager::Initialize()
 {
-	if ( mMaxNumberOfWorkers > 0 )
+	CreateWorkers( mMaxNumberOfWorkers );
+}
+//---------------------------------------
+void JobManager::CreateWorkers( unsigned int workerCount )
+{
+	mStopWorkers = false;
+	mNextWorkerIndex = 0;
+
+	for ( unsigned int i = 0; i < workerCount; ++i )
 	{
-		for ( unsigned int i = 0; i < mMaxNumberOfWorkers; ++i )
+		Worker* worker = new Worker;
+		worker->Index = i;
+		mWorkers.push_back( worker );
+	}
+
+	// Set the last worker to do file I/O for now...
+	// It still helps with generic jobs when there is no file I/O to do.
+	if ( !mWorkers.empty() )
+	{
+		mWorkers.back()->MyPerferedJobType = Job::JOB_FILE_IO;
+	}
+
+	// Start the threads once every queue exists, since workers steal from each other
+	for ( auto itr = mWorkers.begin(); itr != mWorkers.end(); ++itr )
+	{
+		(*itr)->MyThread = new Thread( _worker_function, (void*) *itr );
+	}
+
+	// Hand any jobs that were waiting for the main thread to the new workers
+	if ( !mWorkers.empty() )
+	{
+		std::vector< Job* > jobs;
+		mMainThreadQueue.RemoveAll( jobs );
+
+		for ( auto itr = jobs.begin(); itr != jobs.end(); ++itr )
 		{
-			Worker* worker = new Worker;
-			worker->MyThread = new Thread( _worker_function, (void*) worker );
-			mWorkers.push_back( worker );
+			PushJob( *itr );
 		}
+	}
+}
+//---------------------------------------
+void JobManager::DestroyAllWorkers()
+{
+	BeginCriticalSection( mWorkerMutex );
+	mStopWorkers = true;
+	EndCriticalSection();
 
-		// Set the last work to do file I/O for now...
-		mWorkers.back()->MyPerferedJobType = Job::JOB_FILE_IO;
+	// Wake everyone up so they see they should stop
+	for ( auto itr = mWorkers.begin(); itr != mWorkers.end(); ++itr )
+	{
+		(*itr)->WakeSemaphore.Post();
+	}
+
+	std::vector< Job* > jobs;
+
+	for ( auto itr = mWorkers.begin(); itr != mWorkers.end(); ++itr )
+	{
+		Worker* worker = *itr;
+		worker->MyThread->Join();
+		delete worker->MyThread;
+
+		// Keep jobs the worker never got to
+		worker->Queue.RemoveAll( jobs );
+		delete worker;
+	}
+	mWorkers.clear();
+
+	// Leftover jobs wait for the main thread (or for the next set of workers)
+	for ( auto itr = jobs.begin(); itr != jobs.end(); ++itr )
+	{
+		mMainThreadQueue.Push( *itr );
 	}
 }
 //---------------------------------------
 void JobManager::OnUpdate()
 {
 	// If there are no workers to do jobs, do them ourself
-	if ( mMaxNumberOfWorkers == 0 )
+	if ( mWorkers.empty() )
 	{
-		Job* job = NULL;
-
-		// Try to distribute work across all types evenly
-		static int nextType = 0;
-		++nextType;
-		if ( nextType >= Job::JOB_TYPE_COUNT ) nextType = 0;
-
-		if ( !mPendingJobQueue[ nextType ].empty() )
-		{
-			job = mPendingJobQueue[ nextType ].back();
-			mPendingJobQueue[ nextType ].pop_back();
-		}
-		// There was not job of the next 'even' type, look for another job of any type
-		else
-		{
-			for ( int i = 0; i < Job::JOB_TYPE_COUNT; ++i )
-			{
-				if ( !mPendingJobQueue[ i ].empty() )
-				{
-					job = mPendingJobQueue[ i ].back();
-					mPendingJobQueue[ i ].pop_back();
-					break;
-				}
-			}
-		}
+		Job* job = AquireMainThreadJob();
 
 		// Execute job if there is one
 		if ( job )
 		{
-			job->OnExecute();
-			SubmitCompletedJob( job );
+			ExecuteJob( job );
 		}
 	}
 
 	// Fire callbacks for completed jobs
-	std::list< Job* > completedJobs;
-
 	BeginCriticalSection( mJobCompleteMutex );
-	
-	completedJobs = mCompletedJobList;
-	mCompletedJobList.clear();
-	
+
+	mCompletedJobsToSignal.swap( mCompletedJobList );
+
 	EndCriticalSection();
 
-	for ( auto jobItr = completedJobs.begin(); jobItr != completedJobs.end(); ++ jobItr )
+	for ( auto jobItr = mCompletedJobsToSignal.begin(); jobItr != mCompletedJobsToSignal.end(); ++ jobItr )
 	{
 		(*jobItr)->OnCompletetion();
 		delete *jobItr;
 	}
+	mCompletedJobsToSignal.clear();
 }
 //---------------------------------------
 void JobManager::PushJob( Job* job )
 {
-	CriticalBlock( mJobQueueMutex );
+	CriticalBlock( mWorkerMutex );
 
-	// Add new job
-	mPendingJobQueue[ job->GetJobType() ].push_front( job );
-	// Sort on priority
-	mPendingJobQueue[ job->GetJobType() ].sort( [&]( const Job* jobA, const Job* jobB ) -> bool
+	if ( mWorkers.empty() )
 	{
-		return *jobA < *jobB;
-	});
-}
-//---------------------------------------
-void JobManager::DestroyAllWorkers()
-{
-	for ( auto itr = mWorkers.begin(); itr != mWorkers.end(); ++itr )
+		mMainThreadQueue.Push( job );
+		return;
+	}
+
+	// File I/O goes to the file I/O worker, everything else is spread across all workers
+	Worker* worker = mWorkers.back();
+
+	if ( job->GetJobType() == Job::JOB_GENERIC )
 	{
-		(*itr)->Alive = false;
+		worker = mWorkers[ mNextWorkerIndex ];
+		mNextWorkerIndex = ( mNextWorkerIndex + 1 ) % mWorkers.size();
+	}
+
+	worker->Queue.Push( job );
+
+	// Wake the worker that owns the job, or any sleeping worker that can steal it
+	Worker* workerToWake = NULL;
+
+	if ( worker->IsParked )
+	{
+		workerToWake = worker;
+	}
+	else if ( job->GetJobType() == Job::JOB_GENERIC )
+	{
+		for ( auto itr = mWorkers.begin(); itr != mWorkers.end(); ++itr )
+		{
+			if ( (*itr)->IsParked )
+			{
+				workerToWake = *itr;
+				break;
+			}
+		}
+	}
+
+	if ( workerToWake )
+	{
+		// Only post once per sleep, so the next push wakes someone else
+		workerToWake->IsParked = false;
+		workerToWake->WakeSemaphore.Post();
 	}
-	mWorkers.clear();
 }
 //---------------------------------------
 void JobManager::DestroyAllPendingJobs()
 {
-	CriticalBlock( mJobQueueMutex );
-
 	for ( int i = 0; i < Job::JOB_TYPE_COUNT; ++i )
 	{
-		while ( !mPendingJobQueue[ i ].empty() )
-		{
-			delete mPendingJobQueue[ i ].back();
-			mPendingJobQueue[ i ].pop_back();
-		}
+		DestroyAllPendingJobsOfType( (Job::JobType) i );
 	}
 }
 //---------------------------------------
 void JobManager::DestroyAllPendingJobsOfType( Job::JobType jobType )
 {
-	CriticalBlock( mJobQueueMutex );
+	CriticalBlock( mWorkerMutex );
 
-	while ( !mPendingJobQueue[ jobType ].empty() )
+	for ( auto itr = mWorkers.begin(); itr != mWorkers.end(); ++itr )
 	{
-		delete mPendingJobQueue[ jobType ].back();
-		mPendingJobQueue[ jobType ].pop_back();
+		(*itr)->Queue.DestroyAll( jobType );
 	}
+	mMainThreadQueue.DestroyAll( jobType );
 }
 //---------------------------------------
 void JobManager::SetMaxWorkerThreads( int maxWorkers )
 {
-	mMaxNumberOfWorkers = maxWorkers;
+	if ( maxWorkers < 0 )
+	{
+		maxWorkers = 0;
+	}
 
-	// Limit number of workers
-	if ( mWorkers.size() > mMaxNumberOfWorkers )
+	if ( mMaxNumberOfWorkers != (unsigned int) maxWorkers )
 	{
-		for ( unsigned int i = mMaxNumberOfWorkers; i < mWorkers.size(); ++i )
-		{
-			mWorkers[ i ]->Alive = false;
-		}
-		// Remove dead workers from the list
-		// Dead workers will free there own memory when their thread dies
-		mWorkers.erase( std::remove_if( mWorkers.begin(), mWorkers.end(), [&]( const Worker* worker ) -> bool
-		{
-			return worker->Alive;
-		}), mWorkers.end() );
+		mMaxNumberOfWorkers = maxWorkers;
+
+		// Workers steal from each other, so restart all of them rather than removing queues out from under them
+		// Pending jobs are kept and handed to the new workers
+		DestroyAllWorkers();
+		CreateWorkers( mMaxNumberOfWorkers );
+	}
+}
+//---------------------------------------
+int JobManager::GetCurrentNumberOfWorkers() const
+{
+	return mWorkers.size();
+}
+//---------------------------------------
+unsigned int JobManager::GetPendingJobCount()
+{
+	unsigned int jobCount = 0;
+
+	for ( std::vector< Worker* >::iterator itr = mWorkers.begin(); itr != mWorkers.end(); ++itr )
+	{
+		Mutex& queueMutex = ( *itr )->Queue.QueueMutex;
+		CriticalBlock( queueMutex );
+		jobCount += ( *itr )->Queue.JobCount;
 	}
-	// Make more workers
-	else if ( mWorkers.size() < mMaxNumberOfWorkers )
+
+	Mutex& mainQueueMutex = mMainThreadQueue.QueueMutex;
+	CriticalBlock( mainQueueMutex );
+	jobCount += mMainThreadQueue.JobCount;
+
+	return jobCount;
+}
+//---------------------------------------
+void JobManager::WaitFor( Task* task )
+{
+	assertion( task->IsSubmitted(), "Cannot wait for a Task that was never submitted!" );
+
+	while ( !task->IsFinished() )
 	{
-		for ( unsigned int i = mWorkers.size(); i < mMaxNumberOfWorkers; ++i )
-		{
-			Worker* worker = new Worker;
-			worker->MyThread = new Thread( _worker_function, (void*) worker );
-			mWorkers.push_back( worker );
-		}
-		// Hack to make sure a file IO worker is always around
-		// @TODO generic workers should take over file IO if no file IO work is available.
-		bool canLoadFiles = false;
-		for ( unsigned int i = mWorkers.size(); i < mMaxNumberOfWorkers; ++i )
+		// Help with other work rather than blocking
+		Job* job = AquireJobToHelp();
+
+		if ( job )
 		{
-			if ( mWorkers[i]->MyPerferedJobType == Job::JOB_FILE_IO )
-			{
-				canLoadFiles = true;
-				break;
-			}
+			ExecuteJob( job );
 		}
-		if ( !canLoadFiles )
+		else
 		{
-			mWorkers.back()->MyPerferedJobType = Job::JOB_FILE_IO;
+			// Whatever we are waiting on is already running somewhere else
+			Thread::YieldTimeSlice();
 		}
 	}
 }
 //---------------------------------------
-int JobManager::GetCurrentNumberOfWorkers() const
+Job* JobManager::AquireNextJob( Worker* worker )
 {
-	return mMaxNumberOfWorkers;
+	// Try to get the requested type of job from our own queue
+	Job* job = worker->Queue.PopOldest( worker->MyPerferedJobType );
+
+	// The file I/O worker helps out with generic work when there are no files to load
+	if ( !job && worker->MyPerferedJobType != Job::JOB_GENERIC )
+	{
+		job = worker->Queue.PopOldest( Job::JOB_GENERIC );
+	}
+
+	// Steal generic work from the other workers, starting with our neighbor so thieves spread out
+	// Generic workers never steal file I/O, which is generally not wanted.
+	for ( unsigned int i = 1, workerCount = mWorkers.size(); !job && i < workerCount; ++i )
+	{
+		job = mWorkers[ ( worker->Index + i ) % workerCount ]->Queue.PopNewest( Job::JOB_GENERIC );
+	}
+
+	return job;
 }
 //---------------------------------------
-Job* JobManager::AquireNextJob( Job::JobType requestedType )
+bool JobManager::HasJobForWorker( Worker* worker )
 {
-	Job* job = NULL;
+	bool hasJob = worker->Queue.HasJobs( worker->MyPerferedJobType );
 
-	BeginCriticalSection( mJobQueueMutex );
+	for ( unsigned int i = 0, workerCount = mWorkers.size(); !hasJob && i < workerCount; ++i )
+	{
+		hasJob = mWorkers[ i ]->Queue.HasJobs( Job::JOB_GENERIC );
+	}
+
+	return hasJob;
+}
+//---------------------------------------
+bool JobManager::ParkWorker( Worker* worker )
+{
+	// Tell pushers we are about to sleep
+	BeginCriticalSection( mWorkerMutex );
 
-	// Try to get the requested type of job
-	if ( !mPendingJobQueue[ requestedType ].empty() )
+	if ( mStopWorkers )
 	{
-		job = mPendingJobQueue[ requestedType ].back();
-		mPendingJobQueue[ requestedType ].pop_back();
-		//ConsolePrintf( CONSOLE_INFO, "Job %d started!\n", requestedType );
+		return false;
 	}
-	// We have no jobs of that type, look for other jobs
-	// @TODO this will cause generic works to load files, which is generally not wanted.
-	/*else
+	worker->IsParked = true;
+
+	EndCriticalSection();
+
+	// Check again, since a job may have been pushed before we were marked as parked
+	// If a push also posted to us, the extra post only costs one spurious wakeup later
+	if ( !HasJobForWorker( worker ) )
 	{
-		for ( int i = 0; i < Job::JOB_TYPE_COUNT; ++i )
-		{
-			if ( !mPendingJobQueue[ i ].empty() )
-			{
-				job = mPendingJobQueue[ i ].back();
-				mPendingJobQueue[ i ].pop_back();
-				break;
-			}
-		}
-	}*/
+		worker->WakeSemaphore.Wait();
+	}
+
+	BeginCriticalSection( mWorkerMutex );
+
+	worker->IsParked = false;
 
 	EndCriticalSection();
 
+	return !mStopWorkers;
+}
+//---------------------------------------
+Job* JobManager::AquireMainThreadJob()
+{
+	Job* job = NULL;
+
+	// Try to distribute work across all types evenly
+	static int nextType = 0;
+	++nextType;
+	if ( nextType >= Job::JOB_TYPE_COUNT ) nextType = 0;
+
+	job = mMainThreadQueue.PopOldest( (Job::JobType) nextType );
+
+	// There was not job of the next 'even' type, look for another job of any type
+	for ( int i = 0; !job && i < Job::JOB_TYPE_COUNT; ++i )
+	{
+		job = mMainThreadQueue.PopOldest( (Job::JobType) i );
+	}
+
+	return job;
+}
+//---------------------------------------
+Job* JobManager::AquireJobToHelp()
+{
+	Job* job = mMainThreadQueue.PopOldest( Job::JOB_GENERIC );
+
+	// Steal generic work from the workers (never file I/O, which could block the waiting thread for a long time)
+	for ( unsigned int i = 0, workerCount = mWorkers.size(); !job && i < workerCount; ++i )
+	{
+		job = mWorkers[ i ]->Queue.PopNewest( Job::JOB_GENERIC );
+	}
+
 	return job;
 }
 //---------------------------------------
+void JobManager::ExecuteJob( Job* job )
+{
+	ProfileSection( Job );
+
+	// Check this first, since a finished Task may be deleted by its owner right away
+	bool isAutoDeleted = job->IsAutoDeleted();
+
+	job->OnExecute();
+
+	if ( isAutoDeleted )
+	{
+		SubmitCompletedJob( job );
+	}
+}
+//---------------------------------------
 void JobManager::SubmitCompletedJob( Job* job )
 {
 	CriticalBlock( mJobCompleteMutex );
-	
+
 	mCompletedJobList.push_back( job );
 }
-//---------------------------------------
\ No newline at end of file
+//---------------------------------------
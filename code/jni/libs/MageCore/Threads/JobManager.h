@@ -2,7 +2,10 @@
  * Author      : Matthew Johnson
  * Date        : 11/Jun/2013
  * Description :
- *   
+ *   Runs Jobs on a pool of worker threads.
+ *   Each worker has its own queue with one lane per priority, so pushing a job never sorts anything.
+ *   Idle workers steal generic jobs from the other workers before parking on a semaphore until
+ *   a new job is pushed.
  */
  
 #pragma once
@@ -10,6 +13,8 @@
 namespace mage
 {
 
+	class Task;
+
 	class JobManager
 	{
 		JobManager();
@@ -18,6 +23,7 @@ namespace mage
 		static void CreateJobManager();
 		static JobManager* GetInstance();
 		static void DestroyJobManager();
+		static bool HasInstance();
 		
 		// Update sends out signals for completed jobs
 		void OnUpdate();
@@ -28,44 +34,84 @@ namespace mage
 		// Destroy all jobs of a given type
 		void DestroyAllPendingJobsOfType( Job::JobType jobType );
 		// Set the maximum number of workers allowed
-		// This value defaults to the maximum amount of threads that can be executed concurrently on the system.
+		// This value defaults to one less than the maximum amount of threads that can be executed concurrently
+		// on the system, leaving a core for the main thread.
 		void SetMaxWorkerThreads( int maxWorkers );
 		// Get the current number of worker threads
 		int GetCurrentNumberOfWorkers() const;
+		// Jobs waiting in all of the queues (changes as soon as it is read)
+		unsigned int GetPendingJobCount();
+		// Run other pending jobs on this thread until 'task' has finished
+		void WaitFor( Task* task );
 		
 	private:
-		static void _worker_function( void* pWorker );
-		void Initialize();
-		Job* AquireNextJob( Job::JobType requestedType );
-		void SubmitCompletedJob( Job* job );
-		void DestroyAllWorkers();
+		// Pending jobs, with one FIFO lane per job type and priority
+		struct JobQueue
+		{
+			JobQueue()
+				: JobCount( 0 )
+			{}
 
-		unsigned int mMaxNumberOfWorkers;
+			void Push( Job* job );
+			// Take the oldest job of the highest priority
+			Job* PopOldest( Job::JobType jobType );
+			// Take the newest job of the highest priority (used when stealing)
+			Job* PopNewest( Job::JobType jobType );
+			bool HasJobs( Job::JobType jobType );
+			void RemoveAll( std::vector< Job* >& jobs );
+			// Tasks are owned by their creators, so only auto deleted jobs are destroyed
+			void DestroyAll( Job::JobType jobType );
+
+			std::deque< Job* > Lanes[ Job::JOB_TYPE_COUNT ][ Job::JP_COUNT ];
+			unsigned int JobCount;
+			Mutex QueueMutex;
+		};
 
 		struct Worker
 		{
 			Worker()
-				: CurrentJob( NULL)
-				, Alive( true )
+				: MyThread( NULL )
+				, Index( 0 )
+				, IsParked( false )
 				, MyPerferedJobType( Job::JOB_GENERIC )
 			{}
 
-			Job* CurrentJob;
+			JobQueue Queue;
+			Semaphore WakeSemaphore;
 			Thread* MyThread;
-			bool Alive;
+			unsigned int Index;
+			bool IsParked;
 			Job::JobType MyPerferedJobType;
 		};
 
+		static void _worker_function( void* pWorker );
+		void Initialize();
+		void CreateWorkers( unsigned int workerCount );
+		void DestroyAllWorkers();
+		Job* AquireNextJob( Worker* worker );
+		bool HasJobForWorker( Worker* worker );
+		bool ParkWorker( Worker* worker );
+		Job* AquireMainThreadJob();
+		Job* AquireJobToHelp();
+		void ExecuteJob( Job* job );
+		void SubmitCompletedJob( Job* job );
+
+		unsigned int mMaxNumberOfWorkers;
+		unsigned int mNextWorkerIndex;
+		volatile bool mStopWorkers;
+
 		std::vector< Worker* > mWorkers;
-		// New jobs are added to the front, works acquire jobs from the back
-		std::list< Job* > mPendingJobQueue[ Job::JOB_TYPE_COUNT ];
-		std::list< Job* > mCompletedJobList;
+		// Jobs are run here by OnUpdate() when there are no workers
+		JobQueue mMainThreadQueue;
+		std::vector< Job* > mCompletedJobList;
+		std::vector< Job* > mCompletedJobsToSignal;
 
-		Mutex mJobQueueMutex;
+		// Guards worker selection and parking
+		Mutex mWorkerMutex;
 		Mutex mJobCompleteMutex;
 
 		static JobManager* msJobManager;
 
 	};
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,63 @@
+/*
+ * Description :
+ *   Counting semaphore, used to park threads until there is work for them.
+ */
+ 
+#pragma once
+
+namespace mage
+{
+
+	class Semaphore
+	{
+	public:
+		Semaphore( unsigned int initialCount=0 );
+		~Semaphore();
+
+		// Block until the count is above zero, then decrement it
+		inline void Wait();
+
+		// Decrement the count if it is above zero
+		// This function is non-blocking
+		inline bool TryWait();
+
+		// Increment the count, waking up to 'count' waiting threads
+		inline void Post( unsigned int count=1 );
+
+	private:
+		class PDISemaphore* mPDISemaphore;
+	};
+	//---------------------------------------
+
+
+	//---------------------------------------
+	class PDISemaphore
+	{
+	public:
+		virtual ~PDISemaphore() = 0;
+		virtual void Wait() = 0;
+		virtual bool TryWait() = 0;
+		virtual void Post( unsigned int count ) = 0;
+	};
+
+	inline PDISemaphore::~PDISemaphore() {}
+	//---------------------------------------
+
+
+	//---------------------------------------
+	inline void Semaphore::Wait()
+	{
+		mPDISemaphore->Wait();
+	}
+
+	inline bool Semaphore::TryWait()
+	{
+		return mPDISemaphore->TryWait();
+	}
+
+	inline void Semaphore::Post( unsigned int count )
+	{
+		mPDISemaphore->Post( count );
+	}
+	//---------------------------------------
+}
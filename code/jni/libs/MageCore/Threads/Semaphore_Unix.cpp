@@ -0,0 +1,93 @@
+#include "CoreLib.h"
+
+#include <pthread.h>
+
+using namespace mage;
+
+//---------------------------------------
+class SemaphoreUnix
+	: public PDISemaphore
+{
+public:
+	//---------------------------------------
+	SemaphoreUnix( unsigned int initialCount )
+		: mCount( initialCount )
+	{
+		pthread_mutex_init( &mMutex, NULL );
+		pthread_cond_init( &mCondition, NULL );
+	}
+	//---------------------------------------
+	virtual ~SemaphoreUnix()
+	{
+		pthread_cond_destroy( &mCondition );
+		pthread_mutex_destroy( &mMutex );
+	}
+	//---------------------------------------
+	void Wait()
+	{
+		pthread_mutex_lock( &mMutex );
+
+		// Sleep until another thread posts (the loop handles spurious wakeups)
+		while ( mCount == 0 )
+		{
+			pthread_cond_wait( &mCondition, &mMutex );
+		}
+		--mCount;
+
+		pthread_mutex_unlock( &mMutex );
+	}
+	//---------------------------------------
+	bool TryWait()
+	{
+		bool acquired = false;
+
+		pthread_mutex_lock( &mMutex );
+
+		if ( mCount > 0 )
+		{
+			--mCount;
+			acquired = true;
+		}
+
+		pthread_mutex_unlock( &mMutex );
+
+		return acquired;
+	}
+	//---------------------------------------
+	void Post( unsigned int count )
+	{
+		pthread_mutex_lock( &mMutex );
+
+		mCount += count;
+
+		// Only wake as many threads as there are new counts
+		if ( count == 1 )
+		{
+			pthread_cond_signal( &mCondition );
+		}
+		else if ( count > 1 )
+		{
+			pthread_cond_broadcast( &mCondition );
+		}
+
+		pthread_mutex_unlock( &mMutex );
+	}
+	//---------------------------------------
+private:
+	pthread_mutex_t mMutex;
+	pthread_cond_t mCondition;
+	unsigned int mCount;
+};
+//---------------------------------------
+
+
+//---------------------------------------
+Semaphore::Semaphore( unsigned int initialCount )
+	: mPDISemaphore( new SemaphoreUnix( initialCount ) )
+{}
+//---------------------------------------
+Semaphore::~Semaphore()
+{
+	delete mPDISemaphore;
+}
+//---------------------------------------
@@ -0,0 +1,101 @@
+#include "CoreLib.h"
+
+using namespace mage;
+
+//---------------------------------------
+Mutex Task::msTaskMutex;
+//---------------------------------------
+Task::Task( JobPriority priority )
+	: Job( priority, JOB_GENERIC )
+	, mPendingDependencies( 1 )
+	, mIsSubmitted( false )
+	, mIsFinished( false )
+{
+	// The owner deletes tasks, not the JobManager
+	mIsAutoDeleted = false;
+}
+//---------------------------------------
+Task::~Task()
+{
+	assertion( !mIsSubmitted || IsFinished(), "Cannot delete a Task that is still pending or running!\nWait for it first." );
+}
+//---------------------------------------
+void Task::AddDependency( Task* dependency )
+{
+	CriticalBlock( msTaskMutex );
+
+	assertion( !mIsSubmitted, "Cannot add a dependency to a Task that has already been submitted!" );
+
+	// Finished dependencies don't need to be waited on
+	if ( !dependency->mIsFinished )
+	{
+		++mPendingDependencies;
+		dependency->mContinuations.push_back( this );
+	}
+}
+//---------------------------------------
+void Task::Then( Task* continuation )
+{
+	continuation->AddDependency( this );
+}
+//---------------------------------------
+void Task::Submit()
+{
+	bool isReady;
+
+	BeginCriticalSection( msTaskMutex );
+
+	assertion( !mIsSubmitted, "Cannot submit a Task more than once!" );
+	mIsSubmitted = true;
+
+	// Release the reference held until submission
+	isReady = ( --mPendingDependencies == 0 );
+
+	EndCriticalSection();
+
+	if ( isReady )
+	{
+		JobManager::GetInstance()->PushJob( this );
+	}
+}
+//---------------------------------------
+bool Task::IsSubmitted() const
+{
+	CriticalBlock( msTaskMutex );
+	return mIsSubmitted;
+}
+//---------------------------------------
+bool Task::IsFinished() const
+{
+	CriticalBlock( msTaskMutex );
+	return mIsFinished;
+}
+//---------------------------------------
+void Task::OnExecute()
+{
+	Run();
+	Finish();
+}
+//---------------------------------------
+void Task::Finish()
+{
+	JobManager* jobManager = JobManager::GetInstance();
+
+	CriticalBlock( msTaskMutex );
+
+	// Start every continuation that was only waiting on us
+	for ( auto itr = mContinuations.begin(); itr != mContinuations.end(); ++itr )
+	{
+		Task* continuation = *itr;
+
+		if ( --continuation->mPendingDependencies == 0 )
+		{
+			jobManager->PushJob( continuation );
+		}
+	}
+	mContinuations.clear();
+
+	// This must be the last thing we touch, since the owner may delete the task as soon as it sees it finished
+	mIsFinished = true;
+}
+//---------------------------------------
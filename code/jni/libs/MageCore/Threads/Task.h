@@ -0,0 +1,162 @@
+/*
+ * Description :
+ *   Jobs that can depend on each other and be waited on, for splitting work across cores within a frame.
+ *   Tasks are owned by whoever created them (the JobManager never deletes them) and OnCompletetion() is
+ *   never called for them; use a continuation instead.
+ */
+ 
+#pragma once
+
+namespace mage
+{
+
+	class Task
+		: public Job
+	{
+	public:
+		Task( JobPriority priority=JP_AVERAGE );
+		virtual ~Task();
+
+		// Don't run this task until 'dependency' has finished
+		// Must be called before Submit()
+		void AddDependency( Task* dependency );
+		// Run 'continuation' once this task has finished (same as continuation->AddDependency( this ))
+		void Then( Task* continuation );
+
+		// Hand the task to the JobManager; it runs as soon as all of its dependencies have finished
+		void Submit();
+
+		bool IsSubmitted() const;
+		bool IsFinished() const;
+
+		void OnExecute();
+		void OnCompletetion() {}
+
+	protected:
+		// The work done by the task
+		virtual void Run() = 0;
+
+	private:
+		void Finish();
+
+		std::vector< Task* > mContinuations;
+		unsigned int mPendingDependencies;
+		bool mIsSubmitted;
+		bool mIsFinished;
+
+		// Guards the dependency state of every task
+		// Tasks are meant to be coarse enough that a shared lock doesn't matter
+		static Mutex msTaskMutex;
+	};
+	//---------------------------------------
+
+
+	//---------------------------------------
+	// Task that calls a function or lambda
+	template< typename Function >
+	class FunctionTask
+		: public Task
+	{
+	public:
+		FunctionTask( Function function, JobPriority priority=JP_AVERAGE )
+			: Task( priority )
+			, mFunction( function )
+		{}
+
+	protected:
+		void Run()
+		{
+			mFunction();
+		}
+
+	private:
+		Function mFunction;
+	};
+
+	template< typename Function >
+	FunctionTask< Function >* CreateTask( Function function, Job::JobPriority priority=Job::JP_AVERAGE )
+	{
+		return new FunctionTask< Function >( function, priority );
+	}
+	//---------------------------------------
+
+
+	//---------------------------------------
+	// Task that calls function( i ) for every i in [begin, end)
+	template< typename Function >
+	class RangeTask
+		: public Task
+	{
+	public:
+		RangeTask( int begin, int end, Function& function )
+			: mBegin( begin )
+			, mEnd( end )
+			, mFunction( function )
+		{}
+
+	protected:
+		void Run()
+		{
+			for ( int i = mBegin; i < mEnd; ++i )
+			{
+				mFunction( i );
+			}
+		}
+
+	private:
+		int mBegin;
+		int mEnd;
+		Function& mFunction;
+	};
+	//---------------------------------------
+
+
+	//---------------------------------------
+	// Calls function( i ) for every i in [begin, end), split into tasks of 'grain' indices across all workers
+	// The calling thread runs the first chunk itself and helps with the rest, so this returns once every
+	// index has been processed.
+	template< typename Function >
+	void ParallelFor( int begin, int end, int grain, Function function )
+	{
+		if ( grain < 1 )
+		{
+			grain = 1;
+		}
+
+		if ( end - begin <= grain )
+		{
+			// Not worth splitting
+			for ( int i = begin; i < end; ++i )
+			{
+				function( i );
+			}
+			return;
+		}
+
+		std::vector< RangeTask< Function >* > tasks;
+		tasks.reserve( ( end - begin ) / grain );
+
+		for ( int chunkBegin = begin + grain; chunkBegin < end; chunkBegin += grain )
+		{
+			RangeTask< Function >* task = new RangeTask< Function >( chunkBegin, std::min( chunkBegin + grain, end ), function );
+			tasks.push_back( task );
+			task->Submit();
+		}
+
+		// Do the first chunk here rather than waiting
+		for ( int i = begin; i < begin + grain; ++i )
+		{
+			function( i );
+		}
+
+		JobManager* jobManager = JobManager::GetInstance();
+
+		for ( auto itr = tasks.begin(); itr != tasks.end(); ++itr )
+		{
+			jobManager->WaitFor( *itr );
+			delete *itr;
+		}
+	}
+	//---------------------------------------
+
+}
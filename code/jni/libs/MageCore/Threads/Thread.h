@@ -7,6 +7,21 @@
  
 #pragma once
 
+// Storage for plain data that every thread has its own copy of
+#ifdef WIN32
+#	define THREAD_LOCAL __declspec( thread )
+#else
+#	define THREAD_LOCAL __thread
+#endif
+
+// Full memory barrier, neither the compiler nor the CPU moves loads or stores across it
+// MemoryBarrier() needs Windows.h
+#ifdef WIN32
+#	define MEMORY_BARRIER() MemoryBarrier()
+#else
+#	define MEMORY_BARRIER() __sync_synchronize()
+#endif
+
 namespace mage
 {
 
@@ -24,7 +39,11 @@ namespace mage
 		inline unsigned int GetThreadId() const;
 
 		static void Sleep( unsigned long ms );
+		// Give up the rest of this thread's time slice
+		static void YieldTimeSlice();
 		static unsigned int GetMaxThreadConcurrency();
+		// Id of the calling thread, matches GetThreadId() of the Thread that is running it
+		static unsigned int GetCurrentThreadId();
 
 	private:
 		class PDIThread* mPDIThread;
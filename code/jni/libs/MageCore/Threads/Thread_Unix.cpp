@@ -0,0 +1,174 @@
+#include "CoreLib.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <exception>
+
+using namespace mage;
+
+//---------------------------------------
+// Info passed to wrapper function
+struct ThreadInfo
+{
+	Thread::Function Function;
+	void *Arg;
+	unsigned int ThreadId;
+};
+//---------------------------------------
+// Thread ids are handed out from a counter, pthread_t is opaque and may not fit in an unsigned int
+// 0 means the thread has not been given an id yet
+static unsigned int gNextThreadId = 0;
+static THREAD_LOCAL unsigned int gCurrentThreadId = 0;
+//---------------------------------------
+static unsigned int AllocateThreadId()
+{
+	return __sync_add_and_fetch( &gNextThreadId, 1 );
+}
+//---------------------------------------
+
+
+//---------------------------------------
+class ThreadUnix
+	: public PDIThread
+{
+public:
+	//---------------------------------------
+	ThreadUnix( Thread::Function function, void* userData, unsigned int stackSize=0 )
+		: mThreadId( AllocateThreadId() )
+		, mHasThread( false )
+	{
+		ThreadInfo* info = new ThreadInfo;
+		info->Function = function;
+		info->Arg = userData;
+		info->ThreadId = mThreadId;
+
+		pthread_attr_t attributes;
+		pthread_attr_init( &attributes );
+
+		if ( stackSize > 0 )
+		{
+			pthread_attr_setstacksize( &attributes, stackSize );
+		}
+
+		mHasThread = ( pthread_create( &mHandle, &attributes, _thread_wrapper_function, (void*) info ) == 0 );
+		pthread_attr_destroy( &attributes );
+
+		// Failed to create thread
+		if ( !mHasThread )
+		{
+			delete info;
+			mThreadId = 0;
+		}
+	}
+	//---------------------------------------
+	virtual ~ThreadUnix()
+	{
+		// Never leak the thread's resources if nobody joined it
+		if ( Joinable() )
+		{
+			pthread_detach( mHandle );
+		}
+	}
+	//---------------------------------------
+	void Join()
+	{
+		if ( Joinable() )
+		{
+			pthread_join( mHandle, NULL );
+			mHasThread = false;
+		}
+	}
+	//---------------------------------------
+	bool Joinable() const
+	{
+		return mHasThread;
+	}
+	//---------------------------------------
+	unsigned int GetThreadId() const
+	{
+		return mThreadId;
+	}
+	//---------------------------------------
+private:
+	static void* _thread_wrapper_function( void* arg );
+
+	pthread_t mHandle;
+	unsigned int mThreadId;
+	bool mHasThread;
+};
+
+//---------------------------------------
+// Thread wrapper function
+void* ThreadUnix::_thread_wrapper_function( void* arg )
+{
+	ThreadInfo* info = (ThreadInfo*) arg;
+	gCurrentThreadId = info->ThreadId;
+
+	try
+	{
+		info->Function( info->Arg );
+	}
+	catch ( ... )
+	{
+		std::terminate();
+	}
+
+	// Hand any memory cached by this thread back to the pool
+	MemoryPool::ReleaseThreadCache();
+	ProfilingSystem::ReleaseThreadBuffer();
+
+	delete info;
+
+	return NULL;
+}
+//---------------------------------------
+
+
+//---------------------------------------
+Thread::Thread( Function function, void* userData, unsigned int stackSize )
+	: mPDIThread( new ThreadUnix( function, userData, stackSize ) )
+{}
+//---------------------------------------
+Thread::~Thread()
+{
+	delete mPDIThread;
+}
+//---------------------------------------
+void Thread::Join()
+{
+	mPDIThread->Join();
+}
+//---------------------------------------
+bool Thread::Joinable()
+{
+	return mPDIThread->Joinable();
+}
+//---------------------------------------
+void Thread::Sleep( unsigned long ms )
+{
+	usleep( ms * 1000 );
+}
+//---------------------------------------
+void Thread::YieldTimeSlice()
+{
+	sched_yield();
+}
+//---------------------------------------
+unsigned int Thread::GetMaxThreadConcurrency()
+{
+	long processorCount = sysconf( _SC_NPROCESSORS_ONLN );
+	return ( processorCount > 0 ) ? (unsigned int) processorCount : 1;
+}
+//---------------------------------------
+unsigned int Thread::GetCurrentThreadId()
+{
+	// Threads not started through Thread, like the main thread, get their id the first time they ask
+	if ( gCurrentThreadId == 0 )
+	{
+		gCurrentThreadId = AllocateThreadId();
+	}
+
+	return gCurrentThreadId;
+}
+//---------------------------------------
@@ -105,6 +105,10 @@ unsigned int WINAPI ThreadWin32::_thread_wrapper_function( void* arg )
 		std::terminate();
 	}
 
+	// Hand any memory cached by this thread back to the pool
+	MemoryPool::ReleaseThreadCache();
+	ProfilingSystem::ReleaseThreadBuffer();
+
 	info->TheThread->mMutex.Lock();
 	info->TheThread->mAlive = false;
 	info->TheThread->mMutex.Unlock();
@@ -141,10 +145,20 @@ void Thread::Sleep( unsigned long ms )
 	::Sleep( ms );
 }
 //---------------------------------------
+void Thread::YieldTimeSlice()
+{
+	SwitchToThread();
+}
+//---------------------------------------
 unsigned int Thread::GetMaxThreadConcurrency()
 {
 	SYSTEM_INFO si;
 	GetSystemInfo( &si );
 	return (unsigned int) si.dwNumberOfProcessors;
 }
+//---------------------------------------
+unsigned int Thread::GetCurrentThreadId()
+{
+	return (unsigned int) ::GetCurrentThreadId();
+}
 //---------------------------------------
\ No newline at end of file
@@ -18,3 +18,15 @@ extern "C" unsigned int GenerateHash( const char* str )
 	static std::hash< std::string > hash;
 	return hash( str );
 }
+
+uint32 mage::GenerateHashCaseInsensitive( const char* str )
+{
+	uint32 hash = FNV_OFFSET_BASIS;
+
+	for ( ; *str; ++str )
+	{
+		hash = HashCharCaseInsensitive( hash, *str );
+	}
+
+	return hash;
+}
@@ -10,4 +10,30 @@
 namespace mage
 {
 	extern "C" unsigned int GenerateHash( const char* str );
-}
\ No newline at end of file
+
+	//---------------------------------------
+	// Case insensitive 32bit FNV-1a
+	// The constexpr versions let the compiler hash string literals
+	const uint32 FNV_OFFSET_BASIS = 2166136261U;
+	const uint32 FNV_PRIME = 16777619U;
+
+	// Only ASCII letters are folded
+	constexpr char HashToLower( char c )
+	{
+		return ( c >= 'A' && c <= 'Z' ) ? (char) ( c - 'A' + 'a' ) : c;
+	}
+
+	constexpr uint32 HashCharCaseInsensitive( uint32 hash, char c )
+	{
+		return ( hash ^ (uint8) HashToLower( c ) ) * FNV_PRIME;
+	}
+
+	constexpr uint32 HashStringCaseInsensitive( const char* str, uint32 hash=FNV_OFFSET_BASIS )
+	{
+		return *str ? HashStringCaseInsensitive( str + 1, HashCharCaseInsensitive( hash, *str ) ) : hash;
+	}
+
+	// Same hash as HashStringCaseInsensitive(), as a loop for strings only known at run time
+	uint32 GenerateHashCaseInsensitive( const char* str );
+	//---------------------------------------
+}
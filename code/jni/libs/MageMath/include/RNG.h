@@ -59,4 +59,54 @@ namespace mage
 		static unsigned long Seed;
 	};
 
+
+	// Same generator as RNG, but each instance has its own seed.
+	// Use one per simulation (e.g. per Map) so games on different threads
+	// never share random state and can be replayed from their seed.
+	class RNGStream
+	{
+	public:
+		RNGStream( unsigned long seed = 0 )
+			: mSeed( seed )
+		{}
+
+		// [0, 1]
+		double RandomUnit()
+		{
+			return static_cast< double >( Rand() ) / static_cast< double >( RNG::RandMax );
+		}
+
+		// [-1, 1]
+		double RandomUniform()
+		{
+			return static_cast< double >( 2 * RandomUnit() - 1 );
+		}
+
+		// [min, max]
+		template< typename TReal >
+		TReal RandomInRange( TReal min, TReal max )
+		{
+			return static_cast< TReal >( min + ( max - min ) * RandomUnit() );
+		}
+
+		void SetRandomSeed( unsigned long seed )
+		{
+			mSeed = seed;
+		}
+
+		unsigned long GetSeed() const
+		{
+			return mSeed;
+		}
+
+		int Rand()
+		{
+			mSeed = mSeed * 1103515245 + 12345;
+			return (unsigned int) ( mSeed / 65536 ) % 32768;
+		}
+
+	private:
+		unsigned long mSeed;
+	};
+
 }
\ No newline at end of file
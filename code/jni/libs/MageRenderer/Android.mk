@@ -19,6 +19,9 @@ magerenderer_sources := \
  ./Camera.cpp \
  ./Font.cpp \
  ./Renderer.cpp \
+ ./RenderQueue.cpp \
+ ./QuadList.cpp \
+ ./NullRenderer.cpp \
  ./Shader.cpp \
  ./Surface.cpp \
  ./Texture.cpp \
@@ -26,6 +29,7 @@ magerenderer_sources := \
  ./Sprite.cpp \
  ./SpriteManager.cpp \
  ./TileMap.cpp \
+ ./PerformanceHUD.cpp \
 
 include $(CLEAR_VARS)
 
@@ -196,6 +196,8 @@ void GLRenderer::Start()
 	mCurrentTexture = 0;
 	mActiveTexture = 0;
 	mCurrentBufferCount = 0;
+	mCurrentIndexCount = 0;
+	ResetFrameStats();
 
 	// Create basic effect for simple rendering
 	basicVS = new Shader( Shader::ST_VERTEX, vs_basic );
@@ -222,17 +224,30 @@ void GLRenderer::Start()
 //---------------------------------------
 void GLRenderer::CopyVertexListToBuffer( const VertexList& verts )
 {
+	mFrameStats.Verticies += verts.size();
+	assertion( verts.size() < MAX_VERTEX_BATCH, "Renderer: Too many verticies in a single draw request (%u)\n", verts.size() );
+
 	// Flush if buffer is full
-	if ( mCurrentBufferCount + verts.size() >= MAX_VERTEX_BATCH )
+	if ( mCurrentBufferCount + verts.size() >= MAX_VERTEX_BATCH || mCurrentIndexCount + verts.size() > MAX_INDEX_BATCH )
 	{
 		FlushRenderer();
 	}
+
+	// Triangles are drawn indexed so they can share a batch with quads
+	if ( mCurrentRenderMode == IRenderer::Triangles )
+	{
+		for ( size_t i = 0; i < verts.size(); ++i )
+		{
+			mIndexBuffer[ mCurrentIndexCount++ ] = (unsigned short) ( mCurrentBufferCount + i );
+		}
+	}
+
 	// Copy verts to buffer
 	memcpy( mVertexBuffer + mCurrentBufferCount, &verts[0], sizeof( Vertex2D ) * verts.size() );
 	mCurrentBufferCount += verts.size();
 }
-
-void GLRenderer::RenderVerticies( RenderMode mode, IRenderer::TextureHandle texture, const VertexList& verts )
+//---------------------------------------
+void GLRenderer::SetBatchState( RenderMode mode, IRenderer::TextureHandle texture )
 {
 	// Flush on required state change
 	if ( mode != mCurrentRenderMode || texture != mCurrentTexture )
@@ -242,10 +257,61 @@ void GLRenderer::RenderVerticies( RenderMode mode, IRenderer::TextureHandle text
 		mCurrentTexture = texture;
 		mCurrentRenderMode = mode;
 	}
+}
+//---------------------------------------
+void GLRenderer::RenderVerticies( RenderMode mode, IRenderer::TextureHandle texture, const VertexList& verts )
+{
+	SetBatchState( mode, texture );
+
 	// Copy verts to be rendered
 	CopyVertexListToBuffer( verts );
 }
 //---------------------------------------
+IRenderer::Vertex2D* GLRenderer::ReserveQuads( IRenderer::TextureHandle texture, size_t quadCount )
+{
+	assertion( quadCount <= GetMaxQuadBatch(), "Renderer: Cannot reserve %u quads in a single batch\n", quadCount );
+
+	SetBatchState( IRenderer::Triangles, texture );
+
+	// Flush if buffer is full
+	const size_t vertexCount = 4 * quadCount;
+	const size_t indexCount = 6 * quadCount;
+
+	if ( mCurrentBufferCount + vertexCount >= MAX_VERTEX_BATCH || mCurrentIndexCount + indexCount > MAX_INDEX_BATCH )
+	{
+		FlushRenderer();
+	}
+
+	// Write two triangles per quad, sharing the bottom-left and top-right corners
+	for ( size_t i = 0; i < quadCount; ++i )
+	{
+		unsigned short first = (unsigned short) ( mCurrentBufferCount + 4 * i );
+		unsigned short* indices = mIndexBuffer + mCurrentIndexCount + 6 * i;
+
+		indices[ 0 ] = first;
+		indices[ 1 ] = first + 1;
+		indices[ 2 ] = first + 2;
+		indices[ 3 ] = first;
+		indices[ 4 ] = first + 3;
+		indices[ 5 ] = first + 2;
+	}
+
+	mFrameStats.Verticies += vertexCount;
+	mFrameStats.Quads += quadCount;
+
+	// Hand back the verticies to be filled in place
+	Vertex2D* verts = mVertexBuffer + mCurrentBufferCount;
+	mCurrentBufferCount += vertexCount;
+	mCurrentIndexCount += indexCount;
+
+	return verts;
+}
+//---------------------------------------
+size_t GLRenderer::GetMaxQuadBatch() const
+{
+	return ( MAX_VERTEX_BATCH - 1 ) / 4;
+}
+//---------------------------------------
 void GLRenderer::Stop()
 {
 	Destroy();
@@ -373,14 +439,19 @@ void GLRenderer::FlushRenderer()
 		GL_POINTS
 	};
 
-	if ( mCurrentRenderMode != IRenderer::None )
+	++mFrameStats.Flushes;
+
+	if ( mCurrentRenderMode != IRenderer::None && mCurrentBufferCount > 0 )
 	{
+		++mFrameStats.DrawCalls;
+
 #if USE_GL33
 		
 		// Set active texture
 		if ( mCurrentTexture != mActiveTexture )
 		{
 			mActiveTexture = mCurrentTexture;
+			++mFrameStats.TextureSwitches;
 		}
 		// Apply active texture if using default shader
 		if ( mActiveEffect == gBasicEffect )
@@ -425,7 +496,10 @@ void GLRenderer::FlushRenderer()
 		if ( aPointsize != Effect::INVALID_LOCATION )
 			glVertexAttribPointer( aPointsize, 1, GL_FLOAT, GL_FALSE, sizeof( Vertex2D ), &mVertexBuffer[0].pointsize );
 		
-		glDrawArrays( GLRenderModes[ mCurrentRenderMode ], 0, mCurrentBufferCount );
+		if ( mCurrentRenderMode == IRenderer::Triangles )
+			glDrawElements( GL_TRIANGLES, mCurrentIndexCount, GL_UNSIGNED_SHORT, mIndexBuffer );
+		else
+			glDrawArrays( GLRenderModes[ mCurrentRenderMode ], 0, mCurrentBufferCount );
 
 		glDisableVertexAttribArray( aPosLoc );
 		glDisableVertexAttribArray( aColLoc );
@@ -445,6 +519,7 @@ void GLRenderer::FlushRenderer()
 			{
 				glBindTexture( GL_TEXTURE_2D, mCurrentTexture );
 				mActiveTexture = mCurrentTexture;
+				++mFrameStats.TextureSwitches;
 			}
 		}
 
@@ -452,7 +527,10 @@ void GLRenderer::FlushRenderer()
 		glColorPointer(  4, GL_UNSIGNED_BYTE, sizeof( Vertex2D ), &mVertexBuffer[0].rgba[0] );
 		glTexCoordPointer( 2, GL_FLOAT,       sizeof( Vertex2D ), &mVertexBuffer[0].u );
 
-		glDrawArrays( GLRenderModes[ mCurrentRenderMode ], 0, mCurrentBufferCount );
+		if ( mCurrentRenderMode == IRenderer::Triangles )
+			glDrawElements( GL_TRIANGLES, mCurrentIndexCount, GL_UNSIGNED_SHORT, mIndexBuffer );
+		else
+			glDrawArrays( GLRenderModes[ mCurrentRenderMode ], 0, mCurrentBufferCount );
 
 		glDisableClientState( GL_VERTEX_ARRAY );
 		glDisableClientState( GL_COLOR_ARRAY );
@@ -466,13 +544,17 @@ void GLRenderer::FlushRenderer()
 	}
 
 	mCurrentBufferCount = 0;
+	mCurrentIndexCount = 0;
 }
 
 void GLRenderer::SetActiveEffect( Effect* effect )
 {
 	// Flush if switching to a new effect
 	if ( mActiveEffect != effect )
+	{
 		FlushRenderer();
+		++mFrameStats.EffectChanges;
+	}
 
 	mActiveEffect = effect;
 }
@@ -481,7 +563,10 @@ void GLRenderer::ClearActiveEffect()
 {
 	// Flush if we are switching back to default
 	if ( mActiveEffect != gBasicEffect )
+	{
 		FlushRenderer();
+		++mFrameStats.EffectChanges;
+	}
 
 	mActiveEffect = gBasicEffect;
 }
@@ -497,6 +582,16 @@ void GLRenderer::SetBlendFunc( IRenderer::BlendFunc sFactor, IRenderer::BlendFun
 	glBlendFunc( BlendFuncToGL[ sFactor ], BlendFuncToGL[ dFactor ] );
 }
 
+const IRenderer::FrameStats& GLRenderer::GetFrameStats() const
+{
+	return mFrameStats;
+}
+
+void GLRenderer::ResetFrameStats()
+{
+	memset( &mFrameStats, 0, sizeof( mFrameStats ) );
+}
+
 void GLRenderer::SwapBuffers() const
 {
 #ifdef ANDROID
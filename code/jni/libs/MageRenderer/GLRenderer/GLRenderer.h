@@ -13,6 +13,8 @@ namespace mage
 		virtual ~GLRenderer();
 
 		void RenderVerticies( RenderMode mode, IRenderer::TextureHandle texture, const VertexList& verts );
+		Vertex2D* ReserveQuads( IRenderer::TextureHandle texture, size_t quadCount );
+		size_t GetMaxQuadBatch() const;
 		void FlushRenderer();
 		void SetViewMatrix( const float* view );
 		void ClearScreen();
@@ -25,6 +27,8 @@ namespace mage
 		void ClearActiveEffect();
 		void BindTexture( IRenderer::TextureHandle hTexture, int channel );
 		void SetBlendFunc( IRenderer::BlendFunc sFactor, IRenderer::BlendFunc dFactor );
+		const FrameStats& GetFrameStats() const;
+		void ResetFrameStats();
         
         // Requires a valid context be set
         void SwapBuffers() const;
@@ -46,13 +50,18 @@ namespace mage
         bool Initialize();
 		void Destroy();
 		void CopyVertexListToBuffer( const VertexList& verts );
+		void SetBatchState( RenderMode mode, IRenderer::TextureHandle texture );
 	
-		static const size_t MAX_VERTEX_BATCH = 1024;
+		static const size_t MAX_VERTEX_BATCH = 4096;	// Must fit in the 16-bit index buffer
+		static const size_t MAX_INDEX_BATCH = MAX_VERTEX_BATCH * 3 / 2;	// Enough for a batch made entirely of quads
 		Vertex2D mVertexBuffer[ MAX_VERTEX_BATCH ];
+		unsigned short mIndexBuffer[ MAX_INDEX_BATCH ];	// Triangles are always drawn indexed
 		IRenderer::TextureHandle mCurrentTexture;		// Texture to bind for current batch
 		IRenderer::TextureHandle mActiveTexture;		// Texture currently bound
 		RenderMode mCurrentRenderMode;					// Render mode to use for current batch
 		size_t mCurrentBufferCount;						// Vertex Batch usage
+		size_t mCurrentIndexCount;						// Index Batch usage
+		FrameStats mFrameStats;
 
 		// Experimental
 		//ShaderProgram* mCurrentProgram;
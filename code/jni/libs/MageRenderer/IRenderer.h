@@ -47,7 +47,8 @@ namespace mage
 			float padding;		// Make vertex multiple of 32
 		};
 
-		typedef std::vector< Vertex2D > VertexList;
+		// Vertex lists are only built to be copied into a batch, so their memory comes from the frame arena
+		typedef std::vector< Vertex2D, FrameAlloc< Vertex2D > > VertexList;
 		/*struct VertexList
 		{
 			static const size_t MAX_VLIST_SIZE = 128;
@@ -55,6 +56,18 @@ namespace mage
 			size_t NumVerts;
 		};*/
 
+		// Counters for the work done by the renderer since the last ResetFrameStats()
+		struct FrameStats
+		{
+			uint32 DrawCalls;		// Batches actually sent to the GPU
+			uint32 Flushes;			// Calls to FlushRenderer(), including ones with nothing to draw
+			uint32 Verticies;		// Verticies submitted
+			uint32 Quads;			// Quads submitted through ReserveQuads()
+			uint32 TextureSwitches;	// Batches that used a different texture than the one before
+			uint32 EffectChanges;	// Changes to the active effect
+			uint32 Checksum;		// Hash of the submitted vertex stream, if the renderer computes one (0 otherwise)
+		};
+
 		typedef unsigned int TextureHandle;
 		enum PixelFormat
 		{
@@ -78,6 +91,12 @@ namespace mage
 
 		// This call is a draw request. Drawing may be delayed until FlushRenderer() is called.
 		virtual void RenderVerticies( RenderMode mode, IRenderer::TextureHandle texture, const VertexList& verts ) = 0;
+		// Reserve room for quadCount textured quads (4 verticies each) in the current batch and return the first vertex.
+		// The caller writes the verticies in place, ordered bottom-left, top-left, top-right, bottom-right.
+		// The returned pointer is only valid until the next draw request.
+		virtual Vertex2D* ReserveQuads( IRenderer::TextureHandle texture, size_t quadCount ) = 0;
+		// The most quads that can be reserved with a single call to ReserveQuads().
+		virtual size_t GetMaxQuadBatch() const = 0;
 		// Called when drawing must occur.
 		virtual void FlushRenderer() = 0;
 		// Set the effect program to be used when drawing.
@@ -95,5 +114,8 @@ namespace mage
 		virtual void BindTexture( IRenderer::TextureHandle hTexture, int channel ) = 0;
 		// Set how pixels are blended
 		virtual void SetBlendFunc( IRenderer::BlendFunc sFactor, IRenderer::BlendFunc dFactor ) = 0;
+		// Work done since the last reset
+		virtual const FrameStats& GetFrameStats() const = 0;
+		virtual void ResetFrameStats() = 0;
 	};
 }
@@ -20,6 +20,9 @@
 #	include "GLRenderer/ESContext.h"
 #endif
 #include "Renderer.h"
+#include "RenderQueue.h"
+#include "QuadList.h"
+#include "NullRenderer.h"
 
 #include "Stroke.h"
 
@@ -42,3 +45,5 @@
 #include "TileMap.h"
 #include "Sprite.h"
 #include "SpriteManager.h"
+
+#include "PerformanceHUD.h"
@@ -0,0 +1,206 @@
+#include "RendererLib.h"
+
+using namespace mage;
+
+// FNV-1a
+static const uint32 CHECKSUM_OFFSET_BASIS = 2166136261u;
+static const uint32 CHECKSUM_PRIME = 16777619u;
+
+//---------------------------------------
+NullRenderer::NullRenderer()
+	: mCurrentTexture( 0 )
+	, mActiveTexture( 0 )
+	, mCurrentRenderMode( IRenderer::None )
+	, mCurrentBufferCount( 0 )
+	, mActiveEffect( NULL )
+	, mNextTextureHandle( 1 )
+	, mIsChecksumEnabled( false )
+{
+	ResetFrameStats();
+}
+//---------------------------------------
+NullRenderer::~NullRenderer()
+{}
+//---------------------------------------
+void NullRenderer::Start()
+{
+	mCurrentRenderMode = IRenderer::None;
+	mCurrentTexture = 0;
+	mActiveTexture = 0;
+	mCurrentBufferCount = 0;
+	mActiveEffect = NULL;
+	ResetFrameStats();
+
+	DebugPrintf( "NullRenderer: Initialized\n" );
+}
+//---------------------------------------
+void NullRenderer::Stop()
+{
+	DebugPrintf( "NullRenderer: Stopped\n" );
+}
+//---------------------------------------
+void NullRenderer::SetBatchState( RenderMode mode, IRenderer::TextureHandle texture )
+{
+	// Flush on required state change
+	if ( mode != mCurrentRenderMode || texture != mCurrentTexture )
+	{
+		FlushRenderer();
+
+		mCurrentTexture = texture;
+		mCurrentRenderMode = mode;
+	}
+}
+//---------------------------------------
+void NullRenderer::RenderVerticies( RenderMode mode, IRenderer::TextureHandle texture, const VertexList& verts )
+{
+	SetBatchState( mode, texture );
+
+	assertion( verts.size() < MAX_VERTEX_BATCH, "NullRenderer: Too many verticies in a single draw request (%u)\n", verts.size() );
+
+	// Flush if buffer is full
+	if ( mCurrentBufferCount + verts.size() >= MAX_VERTEX_BATCH )
+	{
+		FlushRenderer();
+	}
+
+	mFrameStats.Verticies += verts.size();
+
+	memcpy( mVertexBuffer + mCurrentBufferCount, &verts[0], sizeof( Vertex2D ) * verts.size() );
+	mCurrentBufferCount += verts.size();
+}
+//---------------------------------------
+IRenderer::Vertex2D* NullRenderer::ReserveQuads( IRenderer::TextureHandle texture, size_t quadCount )
+{
+	assertion( quadCount <= GetMaxQuadBatch(), "NullRenderer: Cannot reserve %u quads in a single batch\n", quadCount );
+
+	SetBatchState( IRenderer::Triangles, texture );
+
+	// Flush if buffer is full
+	const size_t vertexCount = 4 * quadCount;
+	if ( mCurrentBufferCount + vertexCount >= MAX_VERTEX_BATCH )
+	{
+		FlushRenderer();
+	}
+
+	mFrameStats.Verticies += vertexCount;
+	mFrameStats.Quads += quadCount;
+
+	// Hand back the verticies to be filled in place
+	Vertex2D* verts = mVertexBuffer + mCurrentBufferCount;
+	mCurrentBufferCount += vertexCount;
+
+	return verts;
+}
+//---------------------------------------
+size_t NullRenderer::GetMaxQuadBatch() const
+{
+	return ( MAX_VERTEX_BATCH - 1 ) / 4;
+}
+//---------------------------------------
+void NullRenderer::FlushRenderer()
+{
+	++mFrameStats.Flushes;
+
+	if ( mCurrentRenderMode != IRenderer::None && mCurrentBufferCount > 0 )
+	{
+		++mFrameStats.DrawCalls;
+
+		if ( mCurrentTexture != mActiveTexture )
+		{
+			mActiveTexture = mCurrentTexture;
+			++mFrameStats.TextureSwitches;
+		}
+
+		if ( mIsChecksumEnabled )
+		{
+			// Only hash what ends up on screen, picking IDs and padding may be left uninitialized
+			HashBytes( &mCurrentRenderMode, sizeof( mCurrentRenderMode ) );
+			HashBytes( &mCurrentTexture, sizeof( mCurrentTexture ) );
+			for ( size_t i = 0; i < mCurrentBufferCount; ++i )
+			{
+				const Vertex2D& v = mVertexBuffer[ i ];
+				HashBytes( &v.x, sizeof( float ) * 4 );
+				HashBytes( v.rgba, sizeof( v.rgba ) );
+			}
+		}
+	}
+
+	mCurrentBufferCount = 0;
+}
+//---------------------------------------
+void NullRenderer::HashBytes( const void* data, size_t size )
+{
+	const unsigned char* bytes = (const unsigned char*) data;
+	uint32 hash = mFrameStats.Checksum;
+
+	for ( size_t i = 0; i < size; ++i )
+	{
+		hash ^= bytes[ i ];
+		hash *= CHECKSUM_PRIME;
+	}
+
+	mFrameStats.Checksum = hash;
+}
+//---------------------------------------
+void NullRenderer::SetActiveEffect( Effect* effect )
+{
+	// Flush if switching to a new effect
+	if ( mActiveEffect != effect )
+	{
+		FlushRenderer();
+		++mFrameStats.EffectChanges;
+	}
+
+	mActiveEffect = effect;
+}
+//---------------------------------------
+void NullRenderer::ClearActiveEffect()
+{
+	SetActiveEffect( NULL );
+}
+//---------------------------------------
+void NullRenderer::CreateTexture( TextureHandle* hTexture, void* /*pixels*/, unsigned int /*w*/, unsigned int /*h*/, IRenderer::PixelFormat /*format*/, bool /*linearFilter*/ )
+{
+	*hTexture = mNextTextureHandle++;
+}
+//---------------------------------------
+void NullRenderer::FreeTexture( TextureHandle* /*hTexture*/ )
+{}
+//---------------------------------------
+void NullRenderer::SetViewMatrix( const float* /*view*/ )
+{}
+//---------------------------------------
+void NullRenderer::ClearScreen()
+{}
+//---------------------------------------
+void NullRenderer::SetClearColor( float /*r*/, float /*g*/, float /*b*/, float /*a*/ )
+{}
+//---------------------------------------
+void NullRenderer::SetViewport( int /*x*/, int /*y*/, int /*w*/, int /*h*/ )
+{}
+//---------------------------------------
+void NullRenderer::BindTexture( IRenderer::TextureHandle /*hTexture*/, int /*channel*/ )
+{}
+//---------------------------------------
+void NullRenderer::SetBlendFunc( IRenderer::BlendFunc /*sFactor*/, IRenderer::BlendFunc /*dFactor*/ )
+{}
+//---------------------------------------
+const IRenderer::FrameStats& NullRenderer::GetFrameStats() const
+{
+	return mFrameStats;
+}
+//---------------------------------------
+void NullRenderer::ResetFrameStats()
+{
+	memset( &mFrameStats, 0, sizeof( mFrameStats ) );
+	mFrameStats.Checksum = mIsChecksumEnabled ? CHECKSUM_OFFSET_BASIS : 0;
+}
+//---------------------------------------
+void NullRenderer::SwapBuffers() const
+{}
+//---------------------------------------
+void NullRenderer::SetGLContext( GLContext* /*glContext*/ )
+{}
+//---------------------------------------
+void NullRenderer::SetWindowHandle( void** /*hWindow*/ )
+{}
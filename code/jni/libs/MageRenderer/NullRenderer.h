@@ -0,0 +1,66 @@
+/*
+ * Description :
+ *   Renderer that draws nothing. Batches draw requests exactly like GLRenderer and records
+ *   what would have been sent to the GPU, so rendering code can be benchmarked headless.
+ */
+
+#pragma once
+
+#include "IRenderer.h"
+
+namespace mage
+{
+
+	class NullRenderer
+		: public IRenderer
+	{
+	public:
+		NullRenderer();
+		virtual ~NullRenderer();
+
+		void RenderVerticies( RenderMode mode, IRenderer::TextureHandle texture, const VertexList& verts );
+		Vertex2D* ReserveQuads( IRenderer::TextureHandle texture, size_t quadCount );
+		size_t GetMaxQuadBatch() const;
+		void FlushRenderer();
+		void SetViewMatrix( const float* view );
+		void ClearScreen();
+		void SetClearColor( float r, float g, float b, float a );
+		void SetViewport( int x, int y, int w, int h );
+		void CreateTexture( TextureHandle* hTexture, void* pixels, unsigned int w, unsigned int h, PixelFormat format, bool linearFilter=true );
+		void FreeTexture( TextureHandle* hTexture );
+
+		void SetActiveEffect( Effect* effect );
+		void ClearActiveEffect();
+		void BindTexture( IRenderer::TextureHandle hTexture, int channel );
+		void SetBlendFunc( IRenderer::BlendFunc sFactor, IRenderer::BlendFunc dFactor );
+		const FrameStats& GetFrameStats() const;
+		void ResetFrameStats();
+
+		void SwapBuffers() const;
+		void SetGLContext( GLContext* glContext );
+		void SetWindowHandle( void** hWindow );
+		void Start();
+		void Stop();
+
+		// Hash every flushed batch into FrameStats::Checksum, to check that a change didn't alter the output
+		void SetChecksumEnabled( bool enabled )		{ mIsChecksumEnabled = enabled; }
+		bool IsChecksumEnabled() const				{ return mIsChecksumEnabled; }
+
+	protected:
+		void SetBatchState( RenderMode mode, IRenderer::TextureHandle texture );
+		void HashBytes( const void* data, size_t size );
+
+		// Same limits as GLRenderer so batches and flushes match
+		static const size_t MAX_VERTEX_BATCH = 4096;
+		Vertex2D mVertexBuffer[ MAX_VERTEX_BATCH ];
+		IRenderer::TextureHandle mCurrentTexture;		// Texture for current batch
+		IRenderer::TextureHandle mActiveTexture;		// Texture of the last batch drawn
+		RenderMode mCurrentRenderMode;					// Render mode to use for current batch
+		size_t mCurrentBufferCount;						// Vertex Batch usage
+		Effect* mActiveEffect;							// NULL for the default effect
+		IRenderer::TextureHandle mNextTextureHandle;
+		bool mIsChecksumEnabled;
+		FrameStats mFrameStats;
+	};
+
+}
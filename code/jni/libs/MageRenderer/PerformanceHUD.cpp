@@ -0,0 +1,155 @@
+#include "RendererLib.h"
+
+namespace mage
+{
+namespace PerformanceHUD
+{
+	static const float GRAPH_WIDTH = 300.0f;
+	static const float GRAPH_HEIGHT = 80.0f;
+	static const double GRAPH_MAX_SECONDS = 0.05;			// Frame time at the top of the graph
+	static const double FRAME_BUDGET_SECONDS = 1.0 / 60.0;	// Marked on the graph
+	static const Color BACKGROUND_COLOR( 0.0f, 0.0f, 0.0f, 0.6f );
+
+	struct TrackedPool
+	{
+		std::string Name;
+		PoolStatsFunction GetStats;
+		uint32 LastTotalAcquired;
+	};
+
+	bool mIsVisible = false;
+	BitmapFont* mFont = nullptr;
+	std::vector< TrackedPool > mTrackedPools;
+
+	static void DrawFrameTimeGraph( float x, float y, const FrameTimeHistogram& frameTimes );
+
+//---------------------------------------
+void SetVisible( bool isVisible )
+{
+	if ( isVisible && !mIsVisible )
+	{
+		// Don't count the allocations made while hidden as one frame's worth
+		for ( std::vector< TrackedPool >::iterator itr = mTrackedPools.begin(); itr != mTrackedPools.end(); ++itr )
+		{
+			itr->LastTotalAcquired = itr->GetStats().TotalAcquired;
+		}
+	}
+
+	mIsVisible = isVisible;
+}
+//---------------------------------------
+bool IsVisible()
+{
+	return mIsVisible;
+}
+//---------------------------------------
+void ToggleVisible()
+{
+	SetVisible( !mIsVisible );
+}
+//---------------------------------------
+void SetFont( BitmapFont* font )
+{
+	mFont = font;
+}
+//---------------------------------------
+void TrackPool( const std::string& name, PoolStatsFunction getStats )
+{
+	TrackedPool pool;
+	pool.Name = name;
+	pool.GetStats = getStats;
+	pool.LastTotalAcquired = getStats().TotalAcquired;
+	mTrackedPools.push_back( pool );
+}
+//---------------------------------------
+void OnDraw( float x, float y )
+{
+	if ( mIsVisible && mFont )
+	{
+		const float lineHeight = mFont->GetLineHeight();
+		const FrameTimeHistogram* graphedFrameTimes = nullptr;
+		float lineY = y;
+
+		// Frame time percentiles for every tracked tag
+		const std::vector< ProfilingData >& profilerData = ProfilingSystem::GetProfilerData();
+		for ( std::vector< ProfilingData >::const_iterator itr = profilerData.begin(); itr != profilerData.end(); ++itr )
+		{
+			const FrameTimeHistogram* frameTimes = itr->FrameTimes;
+			if ( frameTimes )
+			{
+				DrawTextFormat( x, lineY, mFont, Color::WHITE, "%s  p50 %.1f  p95 %.1f  p99 %.1f ms  hitches %u",
+					itr->Tag.c_str(),
+					frameTimes->GetPercentile( 0.50 ) * 1000.0,
+					frameTimes->GetPercentile( 0.95 ) * 1000.0,
+					frameTimes->GetPercentile( 0.99 ) * 1000.0,
+					frameTimes->GetHitchCount() );
+				lineY += lineHeight;
+
+				if ( !graphedFrameTimes )
+					graphedFrameTimes = frameTimes;
+			}
+		}
+
+		// Last frame's renderer work
+		const IRenderer::FrameStats& renderStats = GetFrameStats();
+		DrawTextFormat( x, lineY, mFont, Color::WHITE, "Draw calls %u  quads %u  texture switches %u",
+			renderStats.DrawCalls, renderStats.Quads, renderStats.TextureSwitches );
+		lineY += lineHeight;
+
+		// Allocations
+		DrawTextFormat( x, lineY, mFont, Color::WHITE, "Frame memory %u allocs %.1f KB",
+			FrameMemory::GetAllocationsLastFrame(), FrameMemory::GetBytesUsedLastFrame() / 1024.0f );
+		lineY += lineHeight;
+
+		for ( std::vector< TrackedPool >::iterator itr = mTrackedPools.begin(); itr != mTrackedPools.end(); ++itr )
+		{
+			PoolStats stats = itr->GetStats();
+			DrawTextFormat( x, lineY, mFont, Color::WHITE, "%s pool %u allocs %u live",
+				itr->Name.c_str(), stats.TotalAcquired - itr->LastTotalAcquired, stats.LiveCount );
+			itr->LastTotalAcquired = stats.TotalAcquired;
+			lineY += lineHeight;
+		}
+
+		// Jobs
+		if ( JobManager::HasInstance() )
+		{
+			JobManager* jobManager = JobManager::GetInstance();
+			DrawTextFormat( x, lineY, mFont, Color::WHITE, "Jobs pending %u  workers %d",
+				jobManager->GetPendingJobCount(), jobManager->GetCurrentNumberOfWorkers() );
+			lineY += lineHeight;
+		}
+
+		if ( graphedFrameTimes )
+		{
+			DrawFrameTimeGraph( x, lineY, *graphedFrameTimes );
+		}
+	}
+}
+//---------------------------------------
+static void DrawFrameTimeGraph( float x, float y, const FrameTimeHistogram& frameTimes )
+{
+	const float barWidth = GRAPH_WIDTH / FrameTimeHistogram::WINDOW_SIZE;
+	const float bottom = y + GRAPH_HEIGHT;
+
+	DrawRect( x, y, GRAPH_WIDTH, GRAPH_HEIGHT, BACKGROUND_COLOR );
+
+	// One bar per frame, newest on the right
+	for ( uint32 i = 0; i < frameTimes.GetSampleCount(); ++i )
+	{
+		double seconds = frameTimes.GetSample( i );
+		float height = (float) ( std::min( seconds / GRAPH_MAX_SECONDS, 1.0 ) * GRAPH_HEIGHT );
+		const Color& color = ( seconds > frameTimes.GetHitchThreshold() ) ? Color::RED :
+			( seconds > FRAME_BUDGET_SECONDS ? Color::YELLOW : Color::GREEN );
+
+		DrawRect( x + GRAPH_WIDTH - ( frameTimes.GetSampleCount() - i ) * barWidth, bottom - height, barWidth, height, color );
+	}
+
+	// Frame budget and hitch threshold
+	float budgetY = bottom - (float) ( FRAME_BUDGET_SECONDS / GRAPH_MAX_SECONDS ) * GRAPH_HEIGHT;
+	float hitchY = bottom - (float) ( std::min( frameTimes.GetHitchThreshold() / GRAPH_MAX_SECONDS, 1.0 ) ) * GRAPH_HEIGHT;
+	DrawLine( x, budgetY, x + GRAPH_WIDTH, budgetY, 1.0f, Color::WHITE );
+	DrawLine( x, hitchY, x + GRAPH_WIDTH, hitchY, 1.0f, Color::RED );
+}
+//---------------------------------------
+}
+}
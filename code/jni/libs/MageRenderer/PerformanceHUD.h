@@ -0,0 +1,34 @@
+/*
+ * Description :
+ *   On-screen overlay with frame time percentiles, a frame time graph, draw calls, allocations and jobs.
+ */
+
+#pragma once
+
+namespace mage
+{
+	//---------------------------------------
+	// Performance overlay
+	// Shows every profiler tag passed to ProfilingSystem::TrackFrameTimes(), and graphs the first one.
+	// Nothing is gathered while the HUD is hidden.
+	// This is a namespace that looks like a static class
+	namespace PerformanceHUD
+	{
+		void SetVisible( bool isVisible );
+		bool IsVisible();
+		void ToggleVisible();
+
+		// The HUD isn't drawn until it has a font
+		void SetFont( BitmapFont* font );
+
+		// Show how many objects are taken from a pool each frame and how many are alive
+		// e.g. TrackPool( "Widget", PoolAllocated< Widget >::GetPoolStats )
+		typedef PoolStats (*PoolStatsFunction)();
+		void TrackPool( const std::string& name, PoolStatsFunction getStats );
+
+		// Draw the HUD with its top left corner at ( x, y ) in screen space
+		// Call last, so it is drawn on top of everything else
+		void OnDraw( float x, float y );
+	}
+
+}
@@ -0,0 +1,35 @@
+#include "RendererLib.h"
+
+using namespace mage;
+
+//---------------------------------------
+QuadList::QuadList()
+{}
+//---------------------------------------
+QuadList::~QuadList()
+{}
+//---------------------------------------
+IRenderer::Vertex2D* QuadList::AddQuad( IRenderer::TextureHandle texture )
+{
+	const size_t quadIndex = GetQuadCount();
+
+	// Start a new run on texture change
+	if ( mRuns.empty() || mRuns.back().Texture != texture )
+	{
+		Run run;
+		run.Texture = texture;
+		run.FirstQuad = quadIndex;
+		run.QuadCount = 0;
+		mRuns.push_back( run );
+	}
+	++mRuns.back().QuadCount;
+
+	mVerts.resize( mVerts.size() + 4 );
+	return &mVerts[ 4 * quadIndex ];
+}
+//---------------------------------------
+void QuadList::Clear()
+{
+	mVerts.clear();
+	mRuns.clear();
+}
@@ -0,0 +1,43 @@
+/*
+ * Description :
+ *   Retained list of textured quads for geometry that rarely changes (e.g. terrain).
+ *   Fill it once with BeginQuadCapture()/EndQuadCapture() and draw it every frame with DrawQuadList().
+ */
+
+#pragma once
+
+namespace mage
+{
+
+	class QuadList
+	{
+	public:
+		// Consecutive quads that share a texture
+		struct Run
+		{
+			IRenderer::TextureHandle Texture;
+			size_t FirstQuad;
+			size_t QuadCount;
+		};
+
+		typedef std::vector< Run > Runs;
+
+		QuadList();
+		~QuadList();
+
+		// Add a quad and return its 4 verticies to be filled in place
+		IRenderer::Vertex2D* AddQuad( IRenderer::TextureHandle texture );
+		// Remove all quads, keeping the storage
+		void Clear();
+
+		const Runs& GetRuns() const							{ return mRuns; }
+		const IRenderer::Vertex2D* GetQuad( size_t index ) const	{ return &mVerts[ 4 * index ]; }
+		size_t GetQuadCount() const							{ return mVerts.size() / 4; }
+		bool IsEmpty() const								{ return mVerts.empty(); }
+
+	private:
+		std::vector< IRenderer::Vertex2D > mVerts;
+		Runs mRuns;
+	};
+
+}
@@ -0,0 +1,142 @@
+#include "RendererLib.h"
+
+using namespace mage;
+
+//---------------------------------------
+RenderQueue::RenderQueue()
+	: mLayer( 0 )
+	, mIsLayerOrdered( false )
+	, mDepth( 0 )
+	, mEffect( NULL )
+	, mEffectIndex( 0 )
+{
+	// Slot 0 is always the default effect
+	mEffects.push_back( NULL );
+}
+//---------------------------------------
+RenderQueue::~RenderQueue()
+{}
+//---------------------------------------
+void RenderQueue::SetLayer( uint8 layer, bool preserveOrder )
+{
+	mLayer = layer;
+	mIsLayerOrdered = preserveOrder;
+}
+//---------------------------------------
+void RenderQueue::SetDepth( uint16 depth )
+{
+	mDepth = depth;
+}
+//---------------------------------------
+void RenderQueue::SetEffect( Effect* effect )
+{
+	mEffect = effect;
+
+	// Find the slot for this effect, or give it a new one
+	auto found = std::find( mEffects.begin(), mEffects.end(), effect );
+	if ( found == mEffects.end() )
+	{
+		assertion( mEffects.size() <= 0xFF, "RenderQueue: Too many effects in a single frame\n" );
+		mEffects.push_back( effect );
+		found = mEffects.end() - 1;
+	}
+
+	mEffectIndex = (uint8) ( found - mEffects.begin() );
+}
+//---------------------------------------
+IRenderer::Vertex2D* RenderQueue::AddQuad( IRenderer::TextureHandle texture )
+{
+	mSortEntries.push_back( SortEntry( MakeKey( texture ), (uint32) mQuads.size() ) );
+
+	mQuads.resize( mQuads.size() + 1 );
+	QueuedQuad& quad = mQuads.back();
+	quad.Texture = texture;
+	quad.QuadEffect = mEffect;
+
+	return quad.Verts;
+}
+//---------------------------------------
+void RenderQueue::Submit( IRenderer* renderer )
+{
+	if ( mQuads.empty() )
+	{
+		return;
+	}
+
+	std::sort( mSortEntries.begin(), mSortEntries.end() );
+
+	// Draw runs of quads that share a texture and effect with a single reservation each
+	const size_t maxRunLength = renderer->GetMaxQuadBatch();
+	const size_t count = mSortEntries.size();
+	size_t i = 0;
+
+	while ( i < count )
+	{
+		const QueuedQuad& first = mQuads[ mSortEntries[ i ].second ];
+		size_t runLength = 1;
+
+		while ( i + runLength < count && runLength < maxRunLength )
+		{
+			const QueuedQuad& next = mQuads[ mSortEntries[ i + runLength ].second ];
+			if ( next.Texture != first.Texture || next.QuadEffect != first.QuadEffect )
+				break;
+			++runLength;
+		}
+
+		ApplyEffect( renderer, first.QuadEffect );
+
+		IRenderer::Vertex2D* verts = renderer->ReserveQuads( first.Texture, runLength );
+		for ( size_t j = 0; j < runLength; ++j, verts += 4 )
+		{
+			memcpy( verts, mQuads[ mSortEntries[ i + j ].second ].Verts, sizeof( IRenderer::Vertex2D ) * 4 );
+		}
+
+		i += runLength;
+	}
+
+	// Leave the renderer with the effect the caller expects for anything drawn next
+	ApplyEffect( renderer, mEffect );
+
+	Clear();
+}
+//---------------------------------------
+void RenderQueue::Clear()
+{
+	// Keep the storage so steady-state frames don't allocate
+	mQuads.clear();
+	mSortEntries.clear();
+
+	// Only the current effect needs a slot next frame
+	mEffects.resize( 1 );
+	mEffectIndex = 0;
+	SetEffect( mEffect );
+}
+//---------------------------------------
+uint64 RenderQueue::MakeKey( IRenderer::TextureHandle texture ) const
+{
+	uint64 key = (uint64) mLayer << 56;
+
+	if ( mIsLayerOrdered )
+	{
+		// Painter order: depth, then the order quads were added
+		key |= (uint64) mDepth << 40;
+	}
+	else
+	{
+		// Group by state: effect, texture, then depth
+		key |= (uint64) mEffectIndex << 48;
+		key |= (uint64) ( texture & 0xFFFF ) << 32;
+		key |= (uint64) mDepth << 16;
+	}
+
+	return key;
+}
+//---------------------------------------
+void RenderQueue::ApplyEffect( IRenderer* renderer, Effect* effect )
+{
+	// The renderer flushes on its own if the effect actually changes
+	if ( effect )
+		renderer->SetActiveEffect( effect );
+	else
+		renderer->ClearActiveEffect();
+}
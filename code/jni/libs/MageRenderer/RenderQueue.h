@@ -0,0 +1,68 @@
+/*
+ * Description :
+ *   Deferred list of textured quads, sorted once per frame before being handed to the IRenderer.
+ *   Each quad gets a 64-bit key made of ( layer, effect, texture, depth ), so quads sharing state
+ *   end up next to each other and are drawn in as few batches as possible.
+ */
+
+#pragma once
+
+namespace mage
+{
+
+	class RenderQueue
+	{
+	public:
+		RenderQueue();
+		~RenderQueue();
+
+		// Quads added after this call are drawn in the given layer. Lower layers are drawn first.
+		// Set preserveOrder for layers with overlapping sprites from different textures:
+		// their quads are kept in the order they were added (by depth) instead of grouped by texture.
+		void SetLayer( uint8 layer, bool preserveOrder=false );
+		// Quads with a lower depth are drawn first among quads that otherwise share a key
+		void SetDepth( uint16 depth );
+		// Effect used for quads added after this call. NULL is the renderer's default effect.
+		void SetEffect( Effect* effect );
+
+		// Add a quad and return its 4 verticies to be filled in place.
+		// Verticies are ordered bottom-left, top-left, top-right, bottom-right.
+		IRenderer::Vertex2D* AddQuad( IRenderer::TextureHandle texture );
+
+		// Sort all queued quads and hand them to the renderer, then empty the queue
+		void Submit( IRenderer* renderer );
+		void Clear();
+
+		uint8 GetLayer() const					{ return mLayer; }
+		bool IsLayerOrdered() const				{ return mIsLayerOrdered; }
+		uint16 GetDepth() const					{ return mDepth; }
+		Effect* GetEffect() const				{ return mEffect; }
+		size_t GetQuadCount() const				{ return mQuads.size(); }
+		bool IsEmpty() const					{ return mQuads.empty(); }
+
+	private:
+		struct QueuedQuad
+		{
+			IRenderer::TextureHandle Texture;
+			Effect* QuadEffect;
+			IRenderer::Vertex2D Verts[4];
+		};
+
+		// Sort key and index of the quad it belongs to.
+		// Ties are broken by index, so quads with equal keys keep the order they were added in.
+		typedef std::pair< uint64, uint32 > SortEntry;
+
+		uint64 MakeKey( IRenderer::TextureHandle texture ) const;
+		void ApplyEffect( IRenderer* renderer, Effect* effect );
+
+		std::vector< QueuedQuad > mQuads;
+		std::vector< SortEntry > mSortEntries;
+		std::vector< Effect* > mEffects;		// Effects used this frame, by their slot in the sort key
+		uint8 mLayer;
+		bool mIsLayerOrdered;
+		uint16 mDepth;
+		Effect* mEffect;
+		uint8 mEffectIndex;
+	};
+
+}
@@ -11,6 +11,15 @@ static bool gYUp = false;
 static int gPickingID;
 
 static Surface* gActiveSurface;
+static Effect* gActiveEffect;
+
+// Quads drawn between BeginRenderQueue() and EndRenderQueue() are sorted before being submitted
+static RenderQueue gRenderQueue;
+static bool gIsRenderQueueActive;
+static IRenderer::FrameStats gLastFrameStats;
+
+// Quads drawn between BeginQuadCapture() and EndQuadCapture() are kept instead of drawn
+static QuadList* gQuadCapture;
 
 static float width;
 static float height;
@@ -44,6 +53,16 @@ IRenderer* GetRenderer()
 	return pRenderer;
 }
 
+IRenderer* SwapRenderer( IRenderer* renderer )
+{
+	// Finish anything drawn with the old renderer first
+	FlushRenderer();
+
+	IRenderer* previous = pRenderer;
+	pRenderer = renderer;
+	return previous;
+}
+
 void StartRenderer()
 {
 	IRenderCall( Start() );
@@ -59,11 +78,114 @@ void SetTextureYUp( bool up )
 	gYUp = up;
 }
 
+static void SubmitRenderQueue()
+{
+	if ( gIsRenderQueueActive && !gRenderQueue.IsEmpty() )
+	{
+		gRenderQueue.Submit( pRenderer );
+	}
+}
+
+// Anything that isn't a quad is drawn immediately, so queued quads go first to keep draw order
+static void SubmitVerticies( IRenderer::RenderMode mode, IRenderer::TextureHandle texture, const IRenderer::VertexList& verts )
+{
+	SubmitRenderQueue();
+	IRenderCall( RenderVerticies( mode, texture, verts ) );
+}
+
 void FlushRenderer()
 {
+	SubmitRenderQueue();
 	IRenderCall( FlushRenderer() );
 }
 
+void BeginRenderQueue()
+{
+	assertion( !gIsRenderQueueActive, "BeginRenderQueue() called twice without EndRenderQueue()\n" );
+	gIsRenderQueueActive = true;
+
+	gRenderQueue.SetLayer( 0 );
+	gRenderQueue.SetDepth( 0 );
+	gRenderQueue.SetEffect( gActiveEffect );
+}
+
+void EndRenderQueue()
+{
+	SubmitRenderQueue();
+	gIsRenderQueueActive = false;
+}
+
+void SetRenderLayer( uint8 layer, bool preserveOrder )
+{
+	gRenderQueue.SetLayer( layer, preserveOrder );
+}
+
+uint8 GetRenderLayer()
+{
+	return gRenderQueue.GetLayer();
+}
+
+void SetRenderDepth( uint16 depth )
+{
+	gRenderQueue.SetDepth( depth );
+}
+
+const IRenderer::FrameStats& GetFrameStats()
+{
+	return gLastFrameStats;
+}
+
+void BeginQuadCapture( QuadList* quads )
+{
+	assertion( !gQuadCapture, "BeginQuadCapture() called twice without EndQuadCapture()\n" );
+	assertion( quads, "Cannot capture quads to a NULL QuadList\n" );
+	gQuadCapture = quads;
+	gQuadCapture->Clear();
+}
+
+void EndQuadCapture()
+{
+	gQuadCapture = NULL;
+}
+
+void DrawQuadList( const QuadList& quads, float x, float y )
+{
+	assertion( pRenderer != NULL, "You must call 'CreateRenderer()' first!!\n", "" );
+
+	if ( quads.IsEmpty() )
+	{
+		return;
+	}
+
+	// Retained quads are drawn immediately, so anything queued before them goes first
+	SubmitRenderQueue();
+
+	// Fold the offset into the current (affine) matrix once instead of per vertex
+	Vec3f origin = gCurrentMatrix * Vec3f( x, y, 0 );
+	Vec3f axisX = gCurrentMatrix * Vec3f( x + 1.0f, y, 0 ) - origin;
+	Vec3f axisY = gCurrentMatrix * Vec3f( x, y + 1.0f, 0 ) - origin;
+
+	const size_t maxRunLength = pRenderer->GetMaxQuadBatch();
+	const QuadList::Runs& runs = quads.GetRuns();
+
+	for ( auto run = runs.begin(); run != runs.end(); ++run )
+	{
+		for ( size_t first = 0; first < run->QuadCount; first += maxRunLength )
+		{
+			const size_t count = std::min( run->QuadCount - first, maxRunLength );
+			IRenderer::Vertex2D* dst = pRenderer->ReserveQuads( run->Texture, count );
+			const IRenderer::Vertex2D* src = quads.GetQuad( run->FirstQuad + first );
+
+			memcpy( dst, src, sizeof( IRenderer::Vertex2D ) * 4 * count );
+			for ( size_t i = 0; i < 4 * count; ++i )
+			{
+				dst[ i ].x = origin.x + src[ i ].x * axisX.x + src[ i ].y * axisY.x;
+				dst[ i ].y = origin.y + src[ i ].x * axisX.y + src[ i ].y * axisY.y;
+			}
+		}
+	}
+}
+
 void DrawRect( float x, float y, float w, float h, const mage::Color& color )
 {
 	DrawRect( 0, x, y, w, h, color, false );
@@ -158,80 +280,67 @@ void DrawRect( Texture2D* texture, float x, float y, const mage::RectF& uv, bool
 	DrawRect( texture, x, y, (float) texture->GetWidth(), (float) texture->GetHeight(), uv, 0xFFFFFFFF, yUp );
 }
 
-void DrawRect( Texture2D* texture, float x, float y, float w, float h, const mage::RectF& fclip, const mage::Color& color, bool yUp )
+static void WriteQuad( IRenderer::Vertex2D* verts, float x, float y, float w, float h, const mage::RectF& fclip, const mage::Color& color, bool yUp )
 {
-	IRenderer::VertexList verts;
-
-	verts.resize( 6 );
-
-	unsigned char rgba[4] =
-	{
-		color.r, color.g, color.b, color.a
-	};
-
-	Vec3f v[6];
-	
-	v[0].Set( x, y + h, 0 );
-	v[0] = gCurrentMatrix * v[0];
-
-	v[1].Set( x, y, 0 );
-	v[1] = gCurrentMatrix * v[1];
-
-	v[2].Set( x + w, y, 0 );
-	v[2] = gCurrentMatrix * v[2];
-
-	v[3].Set( x, y + h, 0 );
-	v[3] = gCurrentMatrix * v[3];
-
-	v[4].Set( x + w, y + h, 0 );
-	v[4] = gCurrentMatrix * v[4];
+	// The current matrix is affine, so the last corner can be found from the other three
+	Vec3f bottomLeft = gCurrentMatrix * Vec3f( x, y + h, 0 );
+	Vec3f topLeft = gCurrentMatrix * Vec3f( x, y, 0 );
+	Vec3f topRight = gCurrentMatrix * Vec3f( x + w, y, 0 );
+	Vec3f bottomRight = bottomLeft + topRight - topLeft;
 
-	v[5].Set( x + w, y, 0 );
-	v[5] = gCurrentMatrix * v[5];
+	const float top = yUp ? fclip.Bottom : fclip.Top;
+	const float bottom = yUp ? fclip.Top : fclip.Bottom;
 
-	for ( int i = 0; i < 6; ++i )
-		memcpy( &verts[ i ], &v[ i ], 2 * sizeof( float ) );
-	//verts.Verts[ 0 ].x = x;
-	//verts.Verts[ 0 ].y = y + h;
+	verts[ 0 ].x = bottomLeft.x;
+	verts[ 0 ].y = bottomLeft.y;
 	verts[ 0 ].u = fclip.Left;
-	verts[ 0 ].v = yUp ? fclip.Top : fclip.Bottom;
-	memcpy( verts[ 0 ].rgba, rgba, 4 );
+	verts[ 0 ].v = bottom;
 
-	//verts.Verts[ 1 ].x = x;
-	//verts.Verts[ 1 ].y = y;
+	verts[ 1 ].x = topLeft.x;
+	verts[ 1 ].y = topLeft.y;
 	verts[ 1 ].u = fclip.Left;
-	verts[ 1 ].v = yUp ? fclip.Bottom : fclip.Top;
-	memcpy( verts[ 1 ].rgba, rgba, 4 );
+	verts[ 1 ].v = top;
 
-	//verts.Verts[ 2 ].x = x + w;
-	//verts.Verts[ 2 ].y = y;
+	verts[ 2 ].x = topRight.x;
+	verts[ 2 ].y = topRight.y;
 	verts[ 2 ].u = fclip.Right;
-	verts[ 2 ].v = yUp ? fclip.Bottom : fclip.Top;
-	memcpy( verts[ 2 ].rgba, rgba, 4 );
-
-	//verts.Verts[ 3 ].x = x;
-	//verts.Verts[ 3 ].y = y + h;
-	verts[ 3 ].u = fclip.Left;
-	verts[ 3 ].v = yUp ? fclip.Top : fclip.Bottom;
-	memcpy( verts[ 3 ].rgba, rgba, 4 );
-
-	//verts.Verts[ 4 ].x = x + w;
-	//verts.Verts[ 4 ].y = y + h;
-	verts[ 4 ].u = fclip.Right;
-	verts[ 4 ].v = yUp ? fclip.Top : fclip.Bottom;
-	memcpy( verts[ 4 ].rgba, rgba, 4 );
-
-	//verts.Verts[ 5 ].x = x + w;
-	//verts.Verts[ 5 ].y = y;
-	verts[ 5 ].u = fclip.Right;
-	verts[ 5 ].v = yUp ? fclip.Bottom : fclip.Top;
-	memcpy( verts[ 5 ].rgba, rgba, 4 );
+	verts[ 2 ].v = top;
+
+	verts[ 3 ].x = bottomRight.x;
+	verts[ 3 ].y = bottomRight.y;
+	verts[ 3 ].u = fclip.Right;
+	verts[ 3 ].v = bottom;
+
+	for ( int i = 0; i < 4; ++i )
+	{
+		verts[ i ].rgba[0] = color.r;
+		verts[ i ].rgba[1] = color.g;
+		verts[ i ].rgba[2] = color.b;
+		verts[ i ].rgba[3] = color.a;
+		verts[ i ].pickingID = gPickingID;
+		verts[ i ].pointsize = 0;
+		verts[ i ].padding = 0;
+	}
+}
+
+void DrawRect( Texture2D* texture, float x, float y, float w, float h, const mage::RectF& fclip, const mage::Color& color, bool yUp )
+{
+	assertion( pRenderer != NULL, "You must call 'CreateRenderer()' first!!\n", "" );
 
 	IRenderer::TextureHandle hTexture = 0;
 	if ( texture )
 		hTexture = texture->GetId();
 
-	IRenderCall( RenderVerticies( IRenderer::Triangles, hTexture, verts ) );
+	// Write the quad straight into the capture list, the render queue or the renderer's batch
+	IRenderer::Vertex2D* verts;
+	if ( gQuadCapture )
+		verts = gQuadCapture->AddQuad( hTexture );
+	else if ( gIsRenderQueueActive )
+		verts = gRenderQueue.AddQuad( hTexture );
+	else
+		verts = pRenderer->ReserveQuads( hTexture, 1 );
+
+	WriteQuad( verts, x, y, w, h, fclip, color, yUp );
 }
 
 void DrawRect( Texture2D* texture, float x, float y, float w, float h, const mage::Color& color, bool yUp )
@@ -300,7 +409,7 @@ void DrawGradientLine( float x0, float y0, float x1, float y1, float width, cons
 
 	verts.NumVerts = 6;
 
-	IRenderCall( RenderVerticies( IRenderer::Triangles, 0, verts ) );
+	SubmitVerticies( IRenderer::Triangles, 0, verts );
 #else
 	verts.resize( 2 );
 	unsigned char rgbaBegin[4];
@@ -324,7 +433,7 @@ void DrawGradientLine( float x0, float y0, float x1, float y1, float width, cons
 	verts[ 1 ].y = v[1].y;
 	memcpy( verts[ 1 ].rgba, rgbaEnd, 4 );
 
-	IRenderCall( RenderVerticies( IRenderer::Lines, 0, verts ) );
+	SubmitVerticies( IRenderer::Lines, 0, verts );
 #endif
 }
 
@@ -494,7 +603,7 @@ void DrawTriangle( const mage::Vec2f& A, const mage::Vec2f& B, const mage::Vec2f
 		memcpy( verts[ 2 ].rgba, rgba, 4 );
 	}
 
-	IRenderCall( RenderVerticies( IRenderer::Triangles, 0, verts ) );
+	SubmitVerticies( IRenderer::Triangles, 0, verts );
 }
 
 void DrawPoint( float x, float y, float pointSize, const mage::Color& color )
@@ -512,7 +621,7 @@ void DrawPoint( float x, float y, float pointSize, const mage::Color& color )
 	verts[ 0 ].pointsize = pointSize;
 	memcpy( verts[ 0 ].rgba, rgba, 4 );
 
-	IRenderCall( RenderVerticies( IRenderer::Points, 0, verts ) );
+	SubmitVerticies( IRenderer::Points, 0, verts );
 }
 
 void DrawPoint( const mage::Vec2f& pos, float pointSize, const mage::Color& color )
@@ -538,7 +647,7 @@ void DrawPoints( float* points, unsigned int nPoints, float pointSize, const mag
 		memcpy( verts[ j ].rgba, rgba, 4 );
 	}
 
-	IRenderCall( RenderVerticies( IRenderer::Points, 0, verts ) );
+	SubmitVerticies( IRenderer::Points, 0, verts );
 }
 
 void DrawPolyLine( float* points, size_t nPoints, float width, const Color& color, bool loop )
@@ -695,6 +804,13 @@ void ClearScreen()
 void SwapBuffers()
 {
 	IRenderCall( SwapBuffers() );
+
+	// The frame is done, keep its stats around and start counting the next one
+	if ( pRenderer )
+	{
+		gLastFrameStats = pRenderer->GetFrameStats();
+		pRenderer->ResetFrameStats();
+	}
 }
 
 void CreateTexture( IRenderer::TextureHandle* hTexture, void* pixels, unsigned int w, unsigned int h, IRenderer::PixelFormat format, bool linearFilter )
@@ -829,11 +945,19 @@ void ScaleUniform2D( float scale )
 
 void SetActiveEffect( Effect* effect )
 {
+	gActiveEffect = effect;
+	if ( gIsRenderQueueActive )
+		gRenderQueue.SetEffect( effect );
+
 	IRenderCall( SetActiveEffect( effect ) );
 }
 
 void ClearActiveEffect()
 {
+	gActiveEffect = NULL;
+	if ( gIsRenderQueueActive )
+		gRenderQueue.SetEffect( NULL );
+
 	IRenderCall( ClearActiveEffect() );
 }
 
@@ -882,4 +1006,71 @@ void SetAdditiveBlend()
 	SetBlendFunc( IRenderer::BF_SRC_ALPHA, IRenderer::BF_ONE );
 }
 
+void BenchmarkQuadSubmission( size_t quadCount )
+{
+	assertion( pRenderer != NULL, "You must call 'CreateRenderer()' first!!\n", "" );
+
+	const RectF fclip( 0, 0, 1, 1 );
+	const float size = 16.0f;
+
+	// Make sure earlier draw requests don't count against either path
+	FlushRenderer();
+
+	// Old path: build a VertexList of 6 verticies per quad, then copy it into the batch
+	// VertexLists take their memory from FrameMemory, so its allocation count shows what each path allocates
+	uint32 startAllocations = FrameMemory::GetAllocationsThisFrame();
+	double startTime = Clock::QueryTime( Clock::TIME_SEC );
+
+	for ( size_t i = 0; i < quadCount; ++i )
+	{
+		IRenderer::VertexList verts;
+		verts.resize( 6 );
+
+		float x = (float) ( i % 64 ) * size;
+		float y = (float) ( ( i / 64 ) % 64 ) * size;
+		Vec3f v[6];
+		v[0] = gCurrentMatrix * Vec3f( x, y + size, 0 );
+		v[1] = gCurrentMatrix * Vec3f( x, y, 0 );
+		v[2] = gCurrentMatrix * Vec3f( x + size, y, 0 );
+		v[3] = gCurrentMatrix * Vec3f( x, y + size, 0 );
+		v[4] = gCurrentMatrix * Vec3f( x + size, y + size, 0 );
+		v[5] = gCurrentMatrix * Vec3f( x + size, y, 0 );
+
+		for ( int j = 0; j < 6; ++j )
+		{
+			verts[ j ].x = v[ j ].x;
+			verts[ j ].y = v[ j ].y;
+			verts[ j ].u = ( j == 2 || j >= 4 ) ? fclip.Right : fclip.Left;
+			verts[ j ].v = ( j == 1 || j == 2 || j == 5 ) ? fclip.Top : fclip.Bottom;
+			verts[ j ].rgba[0] = verts[ j ].rgba[1] = verts[ j ].rgba[2] = verts[ j ].rgba[3] = 0xFF;
+		}
+
+		pRenderer->RenderVerticies( IRenderer::Triangles, 0, verts );
+	}
+
+	FlushRenderer();
+	double listDuration = Clock::QueryTime( Clock::TIME_SEC ) - startTime;
+	uint32 listAllocations = FrameMemory::GetAllocationsThisFrame() - startAllocations;
+
+	// New path: write 4 verticies per quad straight into the batch
+	startAllocations = FrameMemory::GetAllocationsThisFrame();
+	startTime = Clock::QueryTime( Clock::TIME_SEC );
+
+	for ( size_t i = 0; i < quadCount; ++i )
+	{
+		float x = (float) ( i % 64 ) * size;
+		float y = (float) ( ( i / 64 ) % 64 ) * size;
+		DrawRect( 0, x, y, size, size, fclip, Color::WHITE );
+	}
+
+	FlushRenderer();
+	double quadDuration = Clock::QueryTime( Clock::TIME_SEC ) - startTime;
+	uint32 quadAllocations = FrameMemory::GetAllocationsThisFrame() - startAllocations;
+
+	// Report cost per 10k quads so runs with different counts can be compared
+	double scale = quadCount > 0 ? 10000.0 / quadCount : 0.0;
+	DebugPrintf( "Renderer: Quad submission per 10k quads: VertexList %.3f ms (%.0f frame memory allocations), ReserveQuads %.3f ms (%.0f frame memory allocations)\n",
+		listDuration * 1000.0 * scale, listAllocations * scale, quadDuration * 1000.0 * scale, quadAllocations * scale );
+}
+
 }
@@ -29,13 +29,38 @@
 
 namespace mage
 {
+	class QuadList;
 
 	bool InitRenderer( IRenderer* renderer, GLContext* context );
 	void DestroyRenderer();
+	// Also submits the render queue if one is active
 	void FlushRenderer();
 	void ClearScreen();
+	// Ends the frame - GetFrameStats() reports on the frame that was just presented
     void SwapBuffers();
     IRenderer* GetRenderer();
+	// Route all drawing to another renderer (e.g. a NullRenderer for benchmarks) without destroying
+	// the current one. Returns the previous renderer so it can be swapped back in.
+	IRenderer* SwapRenderer( IRenderer* renderer );
+	const IRenderer::FrameStats& GetFrameStats();
+
+	// Textured quads drawn between these calls are sorted by ( layer, effect, texture, depth ) and
+	// submitted together on EndRenderQueue(), or earlier if something forces a flush (blend, surface,
+	// or a non-quad primitive). Lines, points and triangles are always drawn immediately.
+	void BeginRenderQueue();
+	void EndRenderQueue();
+	// See RenderQueue::SetLayer()
+	void SetRenderLayer( uint8 layer, bool preserveOrder=false );
+	uint8 GetRenderLayer();
+	void SetRenderDepth( uint16 depth );
+
+	// Textured quads drawn between these calls are stored in the QuadList instead of being drawn.
+	// Quads are stored as transformed by the current matrix, so usually capture with LoadIdentity().
+	// The list is cleared when the capture begins.
+	void BeginQuadCapture( QuadList* quads );
+	void EndQuadCapture();
+	// Draw previously captured quads, offset by ( x, y ) and transformed by the current matrix
+	void DrawQuadList( const QuadList& quads, float x, float y );
     
     // Call after CreateRenderer()
 	void StartRenderer();
@@ -144,4 +169,7 @@ namespace mage
 	void SetBlendFunc( IRenderer::BlendFunc sFactor, IRenderer::BlendFunc dFactor );
 	void SetDefaultBlend();
 	void SetAdditiveBlend();
+
+	// Time submitting quadCount quads through RenderVerticies() versus ReserveQuads() and log the results
+	void BenchmarkQuadSubmission( size_t quadCount=10000 );
 }
@@ -80,10 +80,18 @@ void SpriteAnimationFrame::AddComponent( SpriteAnimationComponent* component )
 	int z = component->FrameZOrder;
 	ComponentsByZIndex[ z ].push_back( component );
 
+	// Flatten the components into draw order, so drawing doesn't have to walk the map.
+	DrawOrder.clear();
+	for ( auto zItr = ComponentsByZIndex.rbegin(); zItr != ComponentsByZIndex.rend(); ++zItr )
+	{
+		DrawOrder.insert( DrawOrder.end(), zItr->second.begin(), zItr->second.end() );
+	}
+
 	// Get the clipping rect for the component.
 	auto it = component->SprComponent->SpriteClips.find( component->SprComponentClipName );
 	assertion( it != component->SprComponent->SpriteClips.end(), "No clipping rect found for SpriteComponent!" );
 	const RectI& componentRect = it->second;
+	component->Clip = componentRect;
 
 	// Expand the clipping rect for this frame to contain the component rect, if necessary.
 	if( componentRect.Left < ClippingRect.Left )
@@ -114,24 +122,30 @@ void SpriteAnimationFrame::AddComponent( SpriteAnimationComponent* component )
 //---------------------------------------
 // Sprite
 //---------------------------------------
+const float Sprite::FRAME_DELAY_UNIT = 1.0f / 60.0f;
+//---------------------------------------
 Sprite::Sprite( SpriteAnimationSet& animation, const HashString& initialAnimName )
 	: mAnimationSet( animation )
 	, DrawColor( Color::WHITE)
 	, RelativeToCamera( true )
 	, FixedSize( false )
 	, Scale( Vec2f::ONE )
+	, ManagerIndex( 0 )
 {
 	HashMap< SpriteAnimation >::const_iterator anim = animation.Animations.find( initialAnimName );
 	if ( anim != animation.Animations.end() )
 	{
 		mSprAnimInfo.CurrentAnimationName = anim->first;
+		mSprAnimInfo.CurrentAnimation = &anim->second;
 	}
 	else
 	{
 		WarnInfo( "Sprite() initial animation not found: %s\n", initialAnimName.GetString().c_str() );
+		mSprAnimInfo.CurrentAnimation = nullptr;
 		if ( !mAnimationSet.Animations.empty() )
 		{
 			mSprAnimInfo.CurrentAnimationName = mAnimationSet.Animations.begin()->first;
+			mSprAnimInfo.CurrentAnimation = &mAnimationSet.Animations.begin()->second;
 		}
 	}
 	mSprAnimInfo.CurrentAnimationFrame = 0;
@@ -147,17 +161,33 @@ void Sprite::OnUpdate( float dt )
 	mSprAnimInfo.CurrentAnimationFrameTime += dt;
 
 	// Check if animation exists
-	const SpriteAnimation* anim = mAnimationSet.FindAnimation( mSprAnimInfo.CurrentAnimationName );
+	const SpriteAnimation* anim = mSprAnimInfo.CurrentAnimation;
 	if ( anim )
 	{
 		const SpriteAnimation& sprAnim = *anim;
-		const SpriteAnimationFrame& sprFrame = sprAnim.Frames[ mSprAnimInfo.CurrentAnimationFrame ];
 
-		// Check if frame needs to be increased
-		if ( mSprAnimInfo.CurrentAnimationFrameTime >= sprFrame.Delay * dt )
+		// Advance as many frames as the elapsed time covers, so a long update doesn't slow the animation down
+		while ( mSprAnimInfo.CurrentAnimationFrame < sprAnim.FrameCount )
 		{
+			const SpriteAnimationFrame& sprFrame = sprAnim.Frames[ mSprAnimInfo.CurrentAnimationFrame ];
+			float frameDuration = sprFrame.Delay * FRAME_DELAY_UNIT;
+
+			if ( mSprAnimInfo.CurrentAnimationFrameTime < frameDuration )
+				break;
+
 			++mSprAnimInfo.CurrentAnimationFrame;
-			mSprAnimInfo.CurrentAnimationFrameTime = 0.0f;
+
+			// Carry the leftover time into the next frame (frames without a delay still last one update)
+			if ( frameDuration <= 0.0f )
+			{
+				mSprAnimInfo.CurrentAnimationFrameTime = 0.0f;
+				break;
+			}
+			mSprAnimInfo.CurrentAnimationFrameTime -= frameDuration;
+
+			// Loop only while there's a later frame to show
+			if ( mSprAnimInfo.CurrentAnimationFrame >= sprAnim.FrameCount && sprAnim.LoopType == SpriteAnimation::ANIM_LOOP )
+				break;
 		}
 
 		// Loop frame
@@ -189,66 +219,59 @@ void Sprite::OnUpdate( float dt )
 //---------------------------------------
 void Sprite::OnDraw( const Camera& camera ) const
 {
-	const SpriteAnimation* anim = mAnimationSet.FindAnimation( mSprAnimInfo.CurrentAnimationName );
+	const SpriteAnimation* anim = mSprAnimInfo.CurrentAnimation;
 	if ( anim )
 	{
-		// Get the list of components sorted by z-index.
-		const SpriteAnimationFrame::SprAnimComponentsByZIndex& animComponentsByZIndex =
-			anim->Frames[ mSprAnimInfo.CurrentAnimationFrame ].ComponentsByZIndex;
+		// Get the components in draw order (sorted by z-index when the animation was loaded).
+		const SpriteAnimationFrame::SprAnimComponents& animComponentsToDraw =
+			anim->Frames[ mSprAnimInfo.CurrentAnimationFrame ].DrawOrder;
+		Texture2D* texture = mAnimationSet.MyDefinition->SpriteSheet;
 
-		for( auto z = animComponentsByZIndex.rbegin(); z != animComponentsByZIndex.rend(); ++z )
+		for( auto it = animComponentsToDraw.begin(); it != animComponentsToDraw.end(); ++it )
 		{
-			// For each z-index, get the components to draw.
-			const SpriteAnimationFrame::SprAnimComponents& animComponentsToDraw = z->second;
-
-			for( auto it = animComponentsToDraw.begin(); it != animComponentsToDraw.end(); ++it )
-			{
-				// Get the current component to draw.
-				const SpriteAnimationComponent* animComponent = *it;
+			// Get the current component to draw.
+			const SpriteAnimationComponent* animComponent = *it;
+			const RectI& clip = animComponent->Clip;
 
-				const RectI& clip = animComponent->SprComponent->SpriteClips[ animComponent->SprComponentClipName ];
-				Texture2D* texture = mAnimationSet.MyDefinition->SpriteSheet;
+			float px = Position.x + animComponent->FrameOffsetX * 2;
+			float py = Position.y + animComponent->FrameOffsetY * 2;
+			float w = clip.Width();
+			float h = clip.Height();
 
-				float px = Position.x + animComponent->FrameOffsetX * 2;
-				float py = Position.y + animComponent->FrameOffsetY * 2;
-				float w = clip.Width();
-				float h = clip.Height();
-
-				if ( FixedSize )
-				{
-					w = Size.x;
-					h = Size.y;
-				}
+			if ( FixedSize )
+			{
+				w = Size.x;
+				h = Size.y;
+			}
 
-				w *= Scale.x;
-				h *= Scale.y;
+			w *= Scale.x;
+			h *= Scale.y;
 
-				RectF worldClip( px, py, px + clip.Width(), py + clip.Height() );
+			RectF worldClip( px, py, px + clip.Width(), py + clip.Height() );
 
-				if ( RelativeToCamera )
-				{
-					if ( camera.RectInViewport( worldClip ) )
-					{
-						DrawRect( texture,
-							px - camera.GetPosition().x,
-							py - camera.GetPosition().y,
-							w,
-							h,
-							DrawColor,
-							(int) clip.Left, (int) clip.Top, (int) clip.Width(), (int) clip.Height() );
-					}
-				}
-				else
+			if ( RelativeToCamera )
+			{
+				if ( camera.RectInViewport( worldClip ) )
 				{
 					DrawRect( texture,
-						px,
-						py,
+						px - camera.GetPosition().x,
+						py - camera.GetPosition().y,
 						w,
 						h,
 						DrawColor,
 						(int) clip.Left, (int) clip.Top, (int) clip.Width(), (int) clip.Height() );
 				}
 			}
+			else
+			{
+				DrawRect( texture,
+					px,
+					py,
+					w,
+					h,
+					DrawColor,
+					(int) clip.Left, (int) clip.Top, (int) clip.Width(), (int) clip.Height() );
+			}
 		}
 	}
 }
@@ -259,6 +282,7 @@ void Sprite::PlayAnimation( const HashString& animName, int frame, bool restart
 	if ( restart || mSprAnimInfo.CurrentAnimationName != animName )
 	{
 		mSprAnimInfo.CurrentAnimationName = animName;
+		mSprAnimInfo.CurrentAnimation = mAnimationSet.FindAnimation( animName );
 		mSprAnimInfo.CurrentAnimationFrame = frame;
 		mSprAnimInfo.CurrentAnimationFrameTime = 0.0f;
 	}
@@ -281,7 +305,7 @@ void Sprite::UnregisterOnCompletionEvent( const HashString& animName )
 RectI Sprite::GetClippingRectForCurrentAnimation() const
 {
 	RectI clip;
-	const SpriteAnimation* anim = mAnimationSet.FindAnimation( mSprAnimInfo.CurrentAnimationName );
+	const SpriteAnimation* anim = mSprAnimInfo.CurrentAnimation;
 	if ( anim )
 	{
 		// Return the clipping rect for the current animation frame.
@@ -299,7 +323,7 @@ const HashString& Sprite::GetCurrentAnimationName() const
 bool Sprite::IsCurrentAnimationFinished() const
 {
 	// Check if animation exists
-	const SpriteAnimation* anim = mAnimationSet.FindAnimation( mSprAnimInfo.CurrentAnimationName );
+	const SpriteAnimation* anim = mSprAnimInfo.CurrentAnimation;
 	if ( anim )
 	{
 		return mSprAnimInfo.CurrentAnimationFrame == anim->FrameCount - 1;
@@ -307,3 +331,23 @@ bool Sprite::IsCurrentAnimationFinished() const
 	return false;
 }
 //---------------------------------------
+bool Sprite::IsCurrentAnimationStatic() const
+{
+	const SpriteAnimation* anim = mSprAnimInfo.CurrentAnimation;
+	return !anim || anim->FrameCount <= 1;
+}
+//---------------------------------------
+float Sprite::GetTimeUntilNextFrame() const
+{
+	const SpriteAnimation* anim = mSprAnimInfo.CurrentAnimation;
+
+	// Static animations and ones holding on their last frame never change
+	if ( !anim || anim->FrameCount <= 1 )
+		return -1.0f;
+	if ( anim->LoopType == SpriteAnimation::ANIM_ONCE && IsCurrentAnimationFinished() )
+		return -1.0f;
+
+	const SpriteAnimationFrame& sprFrame = anim->Frames[ mSprAnimInfo.CurrentAnimationFrame ];
+	return std::max( sprFrame.Delay * FRAME_DELAY_UNIT - mSprAnimInfo.CurrentAnimationFrameTime, 0.0f );
+}
+//---------------------------------------
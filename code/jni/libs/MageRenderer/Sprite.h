@@ -40,6 +40,8 @@ namespace mage
 		// The component to draw
 		SpriteComponent* SprComponent;
 		HashString SprComponentClipName;
+		// Clipping rect for SprComponentClipName, looked up when the animation is loaded
+		RectI Clip;
 		// Offsets
 		int FrameOffsetX;
 		int FrameOffsetY;
@@ -59,6 +61,8 @@ namespace mage
 		int Delay;
 		RectI ClippingRect;
 		SprAnimComponentsByZIndex ComponentsByZIndex;
+		// All components in the order they are drawn (highest z-index first)
+		SprAnimComponents DrawOrder;
 	};
 	//---------------------------------------
 	// A named animation
@@ -101,6 +105,9 @@ namespace mage
 	class Sprite
 	{
 	public:
+		// Seconds per unit of SpriteAnimationFrame::Delay
+		static const float FRAME_DELAY_UNIT;
+
 		Sprite( SpriteAnimationSet& animation, const HashString& initialAnimName );
 		~Sprite();
 
@@ -114,6 +121,10 @@ namespace mage
 
 		const HashString& GetCurrentAnimationName() const;
 		bool IsCurrentAnimationFinished() const;
+		// True if the current animation only has a single frame
+		bool IsCurrentAnimationStatic() const;
+		// Seconds until the current animation shows its next frame, or a negative value if it never will
+		float GetTimeUntilNextFrame() const;
 
 		Vec2f Position;
 		Vec2f Scale;
@@ -121,11 +132,14 @@ namespace mage
 		Color DrawColor;
 		bool RelativeToCamera;
 		bool FixedSize;
+		// Slot in the SpriteManager's list of live Sprites
+		size_t ManagerIndex;
 	private:
 		// Stores info on the current animation
 		struct AnimationInfo
 		{
 			HashString CurrentAnimationName;
+			const SpriteAnimation* CurrentAnimation;	// Resolved from the name when the animation starts
 			int CurrentAnimationFrame;
 			float CurrentAnimationFrameTime;
 		};
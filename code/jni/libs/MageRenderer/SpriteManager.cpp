@@ -9,7 +9,17 @@ SpriteComponent* LoadSpriteDefinitionDirectory( SpriteComponent* parent,
 
 HashMap< SpriteDefinition* > mSpriteDefinitions;
 HashMap< SpriteAnimationSet* > mSpriteAnimationSets;
+
+// Sprites live in a FixedSizePool so they never move once created, and their memory is recycled.
+// The pool is never emptied, so Sprites still alive at exit are not destroyed during static destruction.
+// mSprites lists the live Sprites in creation order, which is also their draw order. Each Sprite knows its own
+// slot, so destroying one is O(1): the slot is cleared, and the cleared slots are removed once per update.
+static const uint32 SPRITE_BLOCK_SIZE = 256;
+FixedSizePool mSpritePool( sizeof( Sprite ), alignof( Sprite ), SPRITE_BLOCK_SIZE );
 ArrayList< Sprite* > mSprites;
+uint32 mDestroyedSpriteCount = 0;
+
+static void RemoveDestroyedSprites();
 
 bool LoadSpriteDefinition( const char* filename, bool linearFilter )
 {
@@ -242,10 +252,11 @@ Sprite* CreateSprite( const HashString& animSetName, const Vec2f& position,
 	{
 		// If the animation set was found, create a new Sprite using it.
 		SpriteAnimationSet* animSet = it->second;
-		sprite = new Sprite( *animSet, initialAnimName );
+		sprite = new ( mSpritePool.Acquire() ) Sprite( *animSet, initialAnimName );
 		sprite->Position = position;
 
 		// Store the sprite.
+		sprite->ManagerIndex = mSprites.size();
 		mSprites.push_back( sprite );
 	}
 	else
@@ -258,9 +269,15 @@ Sprite* CreateSprite( const HashString& animSetName, const Vec2f& position,
 //---------------------------------------
 void OnUpdate( float dt )
 {
-	for ( ArrayList< Sprite* >::iterator itr = mSprites.begin(); itr != mSprites.end(); ++itr )
+	RemoveDestroyedSprites();
+
+	// Index rather than iterate, an update may create Sprites
+	for ( uint32 i = 0; i < mSprites.size(); ++i )
 	{
-		(*itr)->OnUpdate( dt );
+		if ( mSprites[ i ] )
+		{
+			mSprites[ i ]->OnUpdate( dt );
+		}
 	}
 }
 //---------------------------------------
@@ -268,23 +285,59 @@ void OnDraw( const Camera& camera )
 {
 	for ( ArrayList< Sprite* >::const_iterator itr = mSprites.begin(); itr != mSprites.end(); ++itr )
 	{
-		(*itr)->OnDraw( camera );
+		if ( *itr )
+		{
+			(*itr)->OnDraw( camera );
+		}
 	}
 }
 //---------------------------------------
 void DestroyAllSprites()
 {
-	DestroyVector( mSprites );
+	for ( ArrayList< Sprite* >::iterator itr = mSprites.begin(); itr != mSprites.end(); ++itr )
+	{
+		if ( *itr )
+		{
+			( *itr )->~Sprite();
+			mSpritePool.Release( *itr );
+		}
+	}
+	mSprites.clear();
+	mDestroyedSpriteCount = 0;
 }
 //---------------------------------------
 void DestroySprite( Sprite*& sprite )
 {
-	ArrayList< Sprite* >::iterator foundItr = std::find( mSprites.begin(), mSprites.end(), sprite );
-	if ( foundItr != mSprites.end() )
+	if ( sprite && sprite->ManagerIndex < mSprites.size() && mSprites[ sprite->ManagerIndex ] == sprite )
+	{
+		// Clear the slot, the list is compacted on the next update so the draw order doesn't change
+		mSprites[ sprite->ManagerIndex ] = nullptr;
+		++mDestroyedSpriteCount;
+
+		sprite->~Sprite();
+		mSpritePool.Release( sprite );
+		sprite = nullptr;
+	}
+}
+//---------------------------------------
+static void RemoveDestroyedSprites()
+{
+	if ( mDestroyedSpriteCount > 0 )
 	{
-		mSprites.erase(
-			foundItr, foundItr + 1 );
-		Delete0( sprite );
+		// Slide the live Sprites down over the cleared slots, keeping their order
+		uint32 liveCount = 0;
+		for ( uint32 i = 0; i < mSprites.size(); ++i )
+		{
+			Sprite* sprite = mSprites[ i ];
+			if ( sprite )
+			{
+				sprite->ManagerIndex = liveCount;
+				mSprites[ liveCount++ ] = sprite;
+			}
+		}
+
+		mSprites.resize( liveCount );
+		mDestroyedSpriteCount = 0;
 	}
 }
 //---------------------------------------
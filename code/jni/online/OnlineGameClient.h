@@ -77,6 +77,7 @@ namespace mage
 		void Destroy();
 		void Update();
 		bool IsInitialized() const;
+		bool HasPendingRequests() const;
 
 		std::string GetUserSessionToken() const;
 		bool IsAuthenticated() const;
@@ -145,6 +146,12 @@ namespace mage
 	}
 
 
+	inline bool OnlineGameClient::HasPendingRequests() const
+	{
+		return !( mCallbacksByID.empty() );
+	}
+
+
 #define MAGE_IMPLEMENT_GET_JSON_VALUE( type, rapidjsonType ) \
 	inline type GetJSON ## rapidjsonType ## Value( const rapidjson::Value& object, const char* name, type const & defaultValue ) \
 	{ \
@@ -123,6 +123,13 @@ void GameState::Exit()
 }
 
 
+float GameState::GetIdleTime() const
+{
+	// By default, keep running frames (since the state may be animating).
+	return 0.0f;
+}
+
+
 void GameState::OnScreenSizeChanged( int32 width, int32 height )
 {
 	// TODO
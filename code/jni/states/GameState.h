@@ -20,6 +20,7 @@ namespace mage
 		virtual bool OnPointerDown( const Pointer& pointer );
 		virtual bool OnPointerUp( const Pointer& pointer );
 		virtual bool OnPointerMotion( const Pointer& activePointer, const PointersByID& pointersByID );
+		virtual float GetIdleTime() const;
 
 		template< class InputStateSubclass, typename... Parameters >
 		InputStateSubclass* CreateState( Parameters... );
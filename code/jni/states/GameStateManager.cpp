@@ -119,6 +119,25 @@ void GameStateManager::DestroyActiveState()
 }
 
 
+float GameStateManager::GetIdleTime() const
+{
+	float result = -1.0f;
+
+	if( HasPendingStateChange() )
+	{
+		// Switch states as soon as possible.
+		result = 0.0f;
+	}
+	else if( HasActiveState() )
+	{
+		// Let the active state decide when it next needs a frame.
+		result = mActiveState->GetIdleTime();
+	}
+
+	return result;
+}
+
+
 GameState* GameStateManager::GetActiveState() const
 {
 	return mActiveState;
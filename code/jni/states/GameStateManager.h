@@ -25,6 +25,7 @@ namespace mage
 		void OnPointerDown( const Pointer& pointer );
 		void OnPointerUp( const Pointer& pointer );
 		void OnPointerMotion( const Pointer& activePointer, const PointersByID& pointersByID );
+		float GetIdleTime() const;
 
 		GameState* GetActiveState() const;
 		bool HasActiveState() const;
@@ -153,7 +153,7 @@ void Widget::OnDraw( const Camera& camera )
 
 	for( auto layerIt = mChildrenByDrawLayer.begin(); layerIt != mChildrenByDrawLayer.end(); ++layerIt )
 	{
-		const std::vector< Widget* > layer = layerIt->second;
+		const std::vector< Widget* >& layer = layerIt->second;
 
 		for( auto childIt = layer.begin(); childIt != layer.end(); ++childIt )
 		{
@@ -35,7 +35,7 @@ namespace mage
 	};
 
 
-	class Widget
+	class Widget : public PoolAllocated< Widget >
 	{
 		DECLARE_RTTI;
 